@@ -290,6 +290,7 @@ int main(int argc, char** argv)
             ("threadless", "run without threading")
             ("fatal_exceptions", "abort execution on exception")
             ("disable_thread_grouping", "by default create one thread per node")
+            ("freeze_graph", "cache the topology of the loaded graph until it is edited")
             ("input", "config file to load")
             ("start-server", "start tcp server")
             ("port", po::value<int>()->default_value(42123), "tcp server port");
@@ -405,6 +406,7 @@ int main(int argc, char** argv)
     settings.set("headless", headless);
     settings.set("threadless", vm.count("threadless") > 0);
     settings.set("thread_grouping", vm.count("disable_thread_grouping") == 0);
+    settings.set("freeze_graph", vm.count("freeze_graph") > 0);
     settings.set("additional_args", additional_args);
     settings.set("initially_paused", vm.count("paused") > 0);
     settings.set("start-server", vm.count("start-server") > 0);
@@ -103,7 +103,7 @@ int main(int argc, char** argv)
     po::options_description desc("Allowed options");
     desc.add_options()("help", "show help message")("port", po::value<int>()->default_value(42123),
                                                     "tcp server port")("debug", "enable debug output")("dump", "show variables")("paused", "start paused")("headless", "run without gui")(
-        "threadless", "run without threading")("fatal_exceptions", "abort execution on exception")("disable_thread_grouping", "by default create one thread per node")("input", "config file to load");
+        "threadless", "run without threading")("fatal_exceptions", "abort execution on exception")("disable_thread_grouping", "by default create one thread per node")("freeze_graph", "cache the topology of the loaded graph until it is edited")("input", "config file to load");
 
     po::positional_options_description p;
     p.add("input", 1);
@@ -201,6 +201,7 @@ int main(int argc, char** argv)
     settings.set("headless", headless);
     settings.set("threadless", vm.count("threadless") > 0);
     settings.set("thread_grouping", vm.count("disable_thread_grouping") == 0);
+    settings.set("freeze_graph", vm.count("freeze_graph") > 0);
     settings.set("additional_args", additional_args);
     settings.set("initially_paused", vm.count("paused") > 0);
     settings.set("port", vm["port"].as<int>());
@@ -8,6 +8,7 @@
 #include <csapex/command/command_fwd.h>
 #include <csapex/utility/uuid.h>
 #include <csapex/model/connector_type.h>
+#include <csapex/model/overflow_policy.h>
 #include <csapex_core/csapex_command_export.h>
 #include <csapex/scheduling/scheduling_fwd.h>
 
@@ -34,6 +35,7 @@ public:
     CommandPtr moveConnections(Connector* from, Connector* to);
 
     CommandPtr setConnectionActive(int connection, bool active);
+    CommandPtr setConnectionBuffer(int connection, int buffer_size, OverflowPolicy overflow_policy);
 
     CommandPtr deleteConnectionFulcrumCommand(int connection, int fulcrum);
     CommandPtr deleteAllConnectionFulcrumsCommand(int connection);
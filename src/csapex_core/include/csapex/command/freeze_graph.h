@@ -0,0 +1,40 @@
+#ifndef FREEZE_GRAPH_H
+#define FREEZE_GRAPH_H
+
+/// COMPONENT
+#include "command_impl.hpp"
+#include <csapex/utility/uuid.h>
+
+namespace csapex
+{
+namespace command
+{
+class CSAPEX_COMMAND_EXPORT FreezeGraph : public CommandImplementation<FreezeGraph>
+{
+    COMMAND_HEADER(FreezeGraph);
+
+public:
+    /**
+     * @brief FreezeGraph lets a graph and all nested graphs cache their topology, or switches them back to dynamic execution
+     */
+    FreezeGraph(const AUUID& graph_uuid, bool frozen);
+
+    std::string getDescription() const override;
+
+    void serialize(SerializationBuffer& data, SemanticVersion& version) const override;
+    void deserialize(const SerializationBuffer& data, const SemanticVersion& version) override;
+
+protected:
+    bool doExecute() override;
+    bool doUndo() override;
+    bool doRedo() override;
+
+private:
+    bool frozen_;
+    bool was_frozen_;
+};
+
+}  // namespace command
+
+}  // namespace csapex
+#endif  // FREEZE_GRAPH_H
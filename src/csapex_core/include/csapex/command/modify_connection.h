@@ -4,6 +4,7 @@
 /// COMPONENT
 #include "command_impl.hpp"
 #include <csapex/data/point.h>
+#include <csapex/model/overflow_policy.h>
 
 namespace csapex
 {
@@ -15,6 +16,7 @@ class CSAPEX_COMMAND_EXPORT ModifyConnection : public CommandImplementation<Modi
 
 public:
     ModifyConnection(const AUUID& graph_uuid, int connection_id, bool active);
+    ModifyConnection(const AUUID& graph_uuid, int connection_id, int buffer_size, OverflowPolicy overflow_policy);
 
     std::string getDescription() const override;
 
@@ -29,8 +31,15 @@ protected:
 private:
     int connection_id;
 
+    bool modify_buffer;
+
     bool was_active;
     bool active;
+
+    int was_buffer_size;
+    int buffer_size;
+    OverflowPolicy was_overflow_policy;
+    OverflowPolicy overflow_policy;
 };
 
 }  // namespace command
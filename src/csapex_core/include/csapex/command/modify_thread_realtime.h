@@ -0,0 +1,42 @@
+#ifndef MODIFY_THREAD_REALTIME_H
+#define MODIFY_THREAD_REALTIME_H
+
+/// COMPONENT
+#include "command_impl.hpp"
+#include <csapex/scheduling/thread_group.h>
+
+namespace csapex
+{
+namespace command
+{
+class CSAPEX_COMMAND_EXPORT ModifyThreadRealtime : public CommandImplementation<ModifyThreadRealtime>
+{
+    COMMAND_HEADER(ModifyThreadRealtime);
+
+public:
+    ModifyThreadRealtime(int thread_id, const ThreadGroup::RealtimeSettings& settings);
+
+    std::string getDescription() const override;
+
+    void serialize(SerializationBuffer& data, SemanticVersion& version) const override;
+    void deserialize(const SerializationBuffer& data, const SemanticVersion& version) override;
+
+protected:
+    bool doExecute() override;
+    bool doUndo() override;
+    bool doRedo() override;
+
+private:
+    int id;
+
+    ThreadGroup::RealtimeSettings settings;
+
+    // cache
+    ThreadGroup::RealtimeSettings old_settings;
+};
+
+}  // namespace command
+
+}  // namespace csapex
+
+#endif  // MODIFY_THREAD_REALTIME_H
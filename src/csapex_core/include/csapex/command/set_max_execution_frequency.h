@@ -15,7 +15,11 @@ class CSAPEX_COMMAND_EXPORT SetMaximumExecutionFrequency : public CommandImpleme
     COMMAND_HEADER(SetMaximumExecutionFrequency);
 
 public:
-    SetMaximumExecutionFrequency(const AUUID& graph_uuid, const UUID& node, double frequency);
+    /**
+     * @brief SetMaximumExecutionFrequency sets the period and optionally the relative deadline of a node
+     * @param deadline the deadline in seconds, 0 for an implicit deadline, negative values keep the current one
+     */
+    SetMaximumExecutionFrequency(const AUUID& graph_uuid, const UUID& node, double frequency, double deadline = -1.0);
 
     std::string getDescription() const override;
 
@@ -31,6 +35,8 @@ private:
     UUID uuid;
     double was_frequency;
     double frequency;
+    double was_deadline;
+    double deadline;
 };
 
 }  // namespace command
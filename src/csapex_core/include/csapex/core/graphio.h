@@ -65,7 +65,7 @@ protected:
     void serializeNode(YAML::Node& doc, NodeFacadeImplementationConstPtr node_handle);
     void deserializeNode(const YAML::Node& doc, NodeFacadeImplementationPtr node_handle, SemanticVersion version);
 
-    void loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::string& connection_type, SemanticVersion version);
+    void loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::string& connection_type, int buffer_size, OverflowPolicy overflow_policy, SemanticVersion version);
 
     UUID readNodeUUID(std::weak_ptr<UUIDProvider> parent, const YAML::Node& doc);
     UUID readConnectorUUID(std::weak_ptr<UUIDProvider> parent, const YAML::Node& doc);
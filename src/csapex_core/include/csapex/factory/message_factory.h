@@ -4,6 +4,7 @@
 /// COMPONENT
 #include <csapex/model/token_data.h>
 #include <csapex/msg/message.h>
+#include <csapex/msg/message_type_registry.h>
 #include <csapex/msg/token_traits.h>
 #include <csapex/msg/serialization_format.h>
 
@@ -66,6 +67,7 @@ public:
         std::string type = connection_types::serializationName<Wrapper<M> >();
         if (!instance.isMessageRegistered(type)) {
             instance.registerMessage(type, std::type_index(typeid(Wrapper<M>)), std::bind(&MessageFactory::createDirectMessage<Wrapper, M>));
+            MessageTypeRegistry::id<Wrapper<M> >();
         }
     }
 
@@ -81,6 +83,7 @@ public:
     static void registerMessage()
     {
         MessageFactory::instance().registerMessage(connection_types::serializationName<M>(), std::type_index(typeid(M)), std::bind(&MessageFactory::createMessage<M>));
+        MessageTypeRegistry::id<M>();
     }
     template <typename M>
     static void deregisterMessage()
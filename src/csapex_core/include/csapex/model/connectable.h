@@ -124,6 +124,9 @@ protected:
 
     void init();
 
+private:
+    void updateConnectionsEnabled();
+
 protected:
     mutable std::recursive_mutex io_mutex;
     mutable std::recursive_mutex sync_mutex;
@@ -12,6 +12,7 @@
 #include <csapex/model/connection_description.h>
 
 /// SYSTEM
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <deque>
@@ -20,6 +21,8 @@
 
 namespace csapex
 {
+class ConnectionStateCounter;
+
 class CSAPEX_CORE_EXPORT Connection
 {
     friend class GraphIO;
@@ -75,6 +78,26 @@ public:
     TokenPtr getToken() const;
     void setTokenProcessed();
 
+    /**
+     * @brief setBuffer lets the connection hold up to capacity tokens, so that the producer does not have to wait for the consumer.
+     * A capacity of 1 is the classic single token handshake.
+     * With OverflowPolicy::KEEP_LATEST the capacity is ignored, the connection only ever holds the latest token.
+     */
+    void setBuffer(int capacity, OverflowPolicy policy);
+    int getBufferCapacity() const;
+    OverflowPolicy getOverflowPolicy() const;
+    bool isBuffered() const;
+
+    /**
+     * @brief getBufferedTokenCount returns the number of tokens waiting behind the current one
+     */
+    std::size_t getBufferedTokenCount() const;
+
+    /**
+     * @brief getDroppedTokenCount returns the number of tokens discarded because the buffer was full
+     */
+    std::size_t getDroppedTokenCount() const;
+
     /**
      * @brief readMessage retrieves the current message and marks the Connection read
      * @return
@@ -91,11 +114,37 @@ public:
     bool isSourceEnabled() const;
     bool isSinkEnabled() const;
 
+    /**
+     * @brief setPipelining is called when the consumer changes its execution mode.
+     * A pipelining consumer accepts the next token while it is still processing the current one.
+     */
+    void setPipelining(bool pipelining);
     bool isPipelining() const;
 
     State getState() const;
     void setState(State s);
 
+    /**
+     * @brief getSourceState returns the state as seen by the producer.
+     * For buffered connections, the producer is done as soon as its token has been buffered.
+     */
+    State getSourceState() const;
+
+    /**
+     * @brief observeSinkState lets counter count this connection in its current state, as long as the connection is enabled
+     */
+    void observeSinkState(ConnectionStateCounter* counter);
+    /**
+     * @brief observeSourceState is the same as observeSinkState for the state as seen by the producer
+     */
+    void observeSourceState(ConnectionStateCounter* counter);
+    void stopObservingState(ConnectionStateCounter* counter);
+
+    /**
+     * @brief updateEnabled has to be called whenever one of the connectors is enabled or disabled
+     */
+    void updateEnabled();
+
     int getSeq() const;
 
     void reset();
@@ -109,6 +158,7 @@ public:
     slim_signal::Signal<void(bool)> source_enable_changed;
     slim_signal::Signal<void(bool)> sink_enabled_changed;
     slim_signal::Signal<void()> connection_changed;
+    slim_signal::Signal<void()> token_dropped;
 
     slim_signal::Signal<void(Fulcrum*)> fulcrum_added;
     slim_signal::Signal<void(Fulcrum*, bool dropped)> fulcrum_moved;
@@ -130,6 +180,15 @@ public:
     void moveFulcrum(int fulcrum_id, const Point& pos, bool dropped);
     void deleteFulcrum(int fulcrum_id);
 
+private:
+    int getEffectiveCapacity() const;
+    OverflowPolicy getEffectiveOverflowPolicy() const;
+
+    State calculateSourceState() const;
+    void updateSourceState();
+    void changeState(State s);
+    void observeState(ConnectionStateCounter*& observer, ConnectionStateCounter* counter, State state);
+
 protected:
     OutputPtr from_;
     InputPtr to_;
@@ -141,9 +200,24 @@ protected:
 
     std::vector<FulcrumPtr> fulcrums_;
 
-    State state_;
+    // the states are read without locking, they are only written while holding sync
+    std::atomic<State> state_;
+    std::atomic<State> source_state_;
+
+    ConnectionStateCounter* sink_counter_;
+    ConnectionStateCounter* source_counter_;
+    bool counted_;
+
     TokenPtr message_;
 
+    // tokens waiting behind message_, only used by buffered connections
+    std::deque<TokenPtr> buffer_;
+    int buffer_capacity_;
+    OverflowPolicy overflow_policy_;
+    std::size_t dropped_tokens_;
+
+    bool pipelining_;
+
     static int next_connection_id_;
 
     int seq_ = 0;
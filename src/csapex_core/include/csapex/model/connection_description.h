@@ -7,6 +7,7 @@
 #include <csapex/model/model_fwd.h>
 #include <csapex_core/csapex_core_export.h>
 #include <csapex/model/fulcrum.h>
+#include <csapex/model/overflow_policy.h>
 
 namespace csapex
 {
@@ -29,7 +30,11 @@ public:
 
     std::vector<Fulcrum> fulcrums;
 
-    ConnectionDescription(const UUID& from, const UUID& to, const TokenDataConstPtr& type, int id, int seq, bool active, const std::vector<Fulcrum>& fulcrums);
+    int buffer_size;
+    OverflowPolicy overflow_policy;
+
+    ConnectionDescription(const UUID& from, const UUID& to, const TokenDataConstPtr& type, int id, int seq, bool active, const std::vector<Fulcrum>& fulcrums, int buffer_size = 1,
+                          OverflowPolicy overflow_policy = OverflowPolicy::BLOCK);
 
     ConnectionDescription(const ConnectionDescription& other);
 
@@ -0,0 +1,53 @@
+#ifndef CONNECTION_STATE_COUNTER_H
+#define CONNECTION_STATE_COUNTER_H
+
+/// COMPONENT
+#include <csapex/model/connection.h>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <atomic>
+#include <cstdint>
+
+namespace csapex
+{
+/**
+ * @brief ConnectionStateCounter counts the enabled connections of a transition per connection state.
+ *
+ * All counts are packed into a single atomic word, so that a query sees a consistent picture of all
+ * connections without locking and without visiting them. The connections keep the counts up to date
+ * themselves whenever their state changes.
+ */
+class CSAPEX_CORE_EXPORT ConnectionStateCounter
+{
+public:
+    ConnectionStateCounter();
+
+    void add(Connection::State state);
+    void remove(Connection::State state);
+    void move(Connection::State from, Connection::State to);
+
+    int count(Connection::State state) const;
+    int total() const;
+
+    bool areAll(Connection::State state) const;
+    bool areAll(Connection::State a, Connection::State b) const;
+    bool areAll(Connection::State a, Connection::State b, Connection::State c) const;
+    bool isOne(Connection::State state) const;
+
+private:
+    static constexpr int BITS_PER_STATE = 21;
+    static constexpr std::uint64_t STATE_MASK = (std::uint64_t(1) << BITS_PER_STATE) - 1;
+
+    static int shift(Connection::State state);
+    static int count(std::uint64_t counts, Connection::State state);
+    static int total(std::uint64_t counts);
+    static int countMatching(std::uint64_t counts, int state_bits);
+
+private:
+    std::atomic<std::uint64_t> counts_;
+};
+
+}  // namespace csapex
+
+#endif  // CONNECTION_STATE_COUNTER_H
@@ -0,0 +1,40 @@
+#ifndef CREDIT_ACCOUNT_H
+#define CREDIT_ACCOUNT_H
+
+/// PROJECT
+#include <csapex/utility/slim_signal.hpp>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <atomic>
+
+namespace csapex
+{
+/**
+ * @brief CreditAccount bounds the number of token sets that a source has in flight towards a sink.
+ *
+ * The source takes a credit for every token set it produces, the sink grants it back once it has processed the set.
+ */
+class CSAPEX_CORE_EXPORT CreditAccount
+{
+public:
+    CreditAccount(int credits);
+
+    int getCredits() const;
+    int getAvailableCredits() const;
+
+    bool hasCredit() const;
+    void take();
+    void grant();
+
+public:
+    slim_signal::Signal<void()> credit_granted;
+
+private:
+    const int credits_;
+    std::atomic<int> available_;
+};
+
+}  // namespace csapex
+
+#endif  // CREDIT_ACCOUNT_H
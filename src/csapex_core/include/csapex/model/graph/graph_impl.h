@@ -69,6 +69,19 @@ public:
 
     void analyzeGraph();
 
+    /**
+     * @brief setFusionEnabled controls whether linear chains of nodes in the same thread are executed as one task
+     */
+    void setFusionEnabled(bool enabled);
+    bool isFusionEnabled() const;
+
+    /**
+     * @brief freeze lets all nodes and nested graphs cache their topology dependent state. Any change of the topology thaws the graph again.
+     */
+    void freeze();
+    void thaw();
+    bool isFrozen() const;
+
     void setNodeFacade(NodeFacadeImplementation* nf);
 
     // iterators
@@ -83,6 +96,10 @@ private:
 
     void buildConnectedComponents();
     void calculateDepths();
+    void calculateFusedChains();
+    void calculateCredits();
+
+    std::vector<GraphImplementation*> getNestedGraphs() const;
 
     std::set<graph::Vertex*> findVerticesThatNeedMessages();
     std::set<graph::Vertex*> findVerticesThatJoinStreams();
@@ -92,11 +109,19 @@ protected:
     std::vector<ConnectionPtr> edges_;
 
     std::map<Connection*, std::vector<slim_signal::ScopedConnection>> connection_observations_;
+    std::map<graph::Vertex*, std::vector<slim_signal::ScopedConnection>> vertex_observations_;
+
+    std::map<graph::Vertex*, slim_signal::ScopedConnection> credit_grants_;
+    std::map<Connection*, std::vector<slim_signal::ScopedConnection>> credit_refunds_;
 
     std::set<graph::VertexPtr> sources_;
     std::set<graph::VertexPtr> sinks_;
 
     bool in_transaction_;
+    bool fusion_enabled_;
+
+    bool frozen_;
+    std::vector<NodeHandle*> frozen_nodes_;
 
     NodeFacadeImplementation* nf_;
 };
@@ -94,6 +94,9 @@ protected:
 
     void createSubgraphFacade(NodeFacadePtr nf);
 
+    void updateThreadPlacement();
+    void collectPlacementChains(std::map<TaskGenerator*, std::pair<int, int>>& chains, int chain, int depth) const;
+
 private:
     UUID getOutputUUID(NodeFacade* node, const std::string& label);
     UUID getInputUUID(NodeFacade* node, const std::string& label);
@@ -26,6 +26,7 @@ FWD(Connection)
 FWD(ConnectionDescription)
 FWD(Connector)
 FWD(ConnectorDescription)
+FWD(CreditAccount)
 FWD(Fulcrum)
 FWD(GenericState)
 FWD(Graph)
@@ -259,6 +259,17 @@ public:
      */
     virtual bool canRunInSeparateProcess() const;
 
+    /**
+     * @brief isReplicable specifies whether multiple copies of this node may process consecutive token sets concurrently.
+     *
+     * This requires the node to be stateless, i.e. the result of Node::process must only depend on the
+     * received messages and the parameters. Replicas are enabled per node via NodeState::setReplicas.
+     * By default, the method returns false.
+     *
+     * @return <b>true</b>, iff the node can be replicated.
+     */
+    virtual bool isReplicable() const;
+
     /**
      * @brief stateChanged is an event function that is called, when the NodeState has changed.
      */
@@ -26,6 +26,13 @@ public:
 
     bool is_leading_to_essential_vertex;
 
+    // id and position of the linear chain this node is fused into, -1 if not fused
+    int fused_chain;
+    int fused_chain_position;
+
+    // the node declares that copies of it may process consecutive token sets concurrently
+    bool is_replicable;
+
     void serialize(SerializationBuffer& data, SemanticVersion& version) const override;
     void deserialize(const SerializationBuffer& data, const SemanticVersion& version) override;
 };
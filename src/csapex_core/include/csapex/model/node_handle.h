@@ -16,6 +16,7 @@
 #include <csapex/serialization/serialization_fwd.h>
 
 /// SYSTEM
+#include <atomic>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -46,6 +47,17 @@ public:
     void setNodeRunner(NodeRunnerWeakPtr runner);
     NodeRunnerPtr getNodeRunner() const;
 
+    /**
+     * @brief setNodeConstructor remembers how the node was created, which is required for replication
+     */
+    void setNodeConstructor(std::function<NodePtr()> constructor);
+
+    /**
+     * @brief makeReplica creates an independent copy of the node, which is not part of any graph
+     * @return nullptr, iff the node cannot be copied
+     */
+    NodeHandlePtr makeReplica(const UUIDProviderPtr& uuid_provider) const;
+
     Input* addInput(TokenDataConstPtr type, const std::string& label, bool optional) override;
     void manageInput(InputPtr in);
     bool isParameterInput(const UUID& id) const override;
@@ -117,6 +129,18 @@ public:
     bool hasConnectionsIncoming() const;
     bool hasConnectionsOutgoing() const;
 
+    /**
+     * @brief areRequiredInputsConnected returns true, iff every non-optional input has an enabled connection
+     */
+    bool areRequiredInputsConnected() const;
+
+    /**
+     * @brief freeze caches the properties that only depend on the topology of the graph, until thaw is called
+     */
+    void freeze();
+    void thaw();
+    bool isFrozen() const;
+
     bool isVariadic() const;
     bool hasVariadicInputs() const;
     bool hasVariadicOutputs() const;
@@ -136,6 +160,18 @@ public:
     Rate& getRate();
     const Rate& getRate() const;
 
+    /**
+     * @brief setCreditAccounts sets the accounts of the downstream sinks that limit how many token sets this node may have in flight
+     */
+    void setCreditAccounts(const std::vector<CreditAccountPtr>& accounts);
+    std::vector<CreditAccountPtr> getCreditAccounts() const;
+
+    /**
+     * @brief hasCredits returns true, iff every account has a credit left, so that the node may produce the next token set
+     */
+    bool hasCredits() const;
+    void takeCredits();
+
     bool updateParameterValues();
 
 public:
@@ -199,6 +235,7 @@ protected:
     ConnectableVector<Slot> internal_slots_;
 
     std::string node_type_;
+    std::function<NodePtr()> node_constructor_;
 
     InputTransitionPtr transition_in_;
     OutputTransitionPtr transition_out_;
@@ -216,6 +253,14 @@ private:
 
     Rate rate_;
 
+    std::vector<CreditAccountPtr> credit_accounts_;
+    std::vector<slim_signal::ScopedConnection> credit_connections_;
+
+    std::atomic<bool> frozen_;
+    bool frozen_is_source_;
+    bool frozen_is_sink_;
+    bool frozen_inputs_connected_;
+
     std::map<Connectable*, std::vector<slim_signal::Connection>> connections_;
 
 public:
@@ -0,0 +1,101 @@
+#ifndef NODE_REPLICAS_H
+#define NODE_REPLICAS_H
+
+/// PROJECT
+#include <csapex/model/model_fwd.h>
+#include <csapex/model/token.h>
+#include <csapex/msg/msg_fwd.h>
+#include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex/utility/slim_signal.hpp>
+#include <csapex/utility/utility_fwd.h>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief NodeReplicas lets independent copies of a replicable node process consecutive token sets concurrently.
+ *
+ * Every replica is a task generator on the scheduler of the original node, so the replicas run on the workers of
+ * its thread group. Token sets are dispatched round robin and the results are handed back in the order of the
+ * sequence numbers of the dispatched tokens.
+ */
+class CSAPEX_CORE_EXPORT NodeReplicas
+{
+public:
+    struct Result
+    {
+        long sequence_number;
+        Token::OriginsPtr origins;
+        std::vector<std::pair<OutputPtr, TokenPtr>> outputs;
+        std::string error;
+
+        // failures are rethrown by the node worker, so that they reach the exception handler
+        std::exception_ptr failure;
+    };
+
+public:
+    NodeReplicas(NodeHandlePtr node_handle, int count, Scheduler* scheduler);
+    ~NodeReplicas();
+
+    int getCount() const;
+
+    /**
+     * @brief assignToScheduler moves the replicas to the scheduler of the original node, nullptr detaches them
+     */
+    void assignToScheduler(Scheduler* scheduler);
+
+    /**
+     * @brief getPendingCount returns the number of token sets that were dispatched, but whose result was not taken yet
+     */
+    std::size_t getPendingCount() const;
+    bool canDispatch() const;
+
+    /**
+     * @brief dispatch hands the tokens that are currently held by the inputs of the node to the next replica
+     */
+    void dispatch();
+
+    /**
+     * @brief takeNextResult removes the result of the oldest pending token set, iff it is finished
+     */
+    bool takeNextResult(Result& result);
+
+public:
+    slim_signal::Signal<void()> result_available;
+
+private:
+    struct Job;
+    struct Entry;
+    class Replica;
+
+    void process(Replica& replica, Job& job);
+    void finish(const std::shared_ptr<Entry>& entry);
+
+private:
+    NodeHandlePtr node_handle_;
+
+    std::vector<std::shared_ptr<Replica>> replicas_;
+    std::size_t next_replica_;
+
+    // only parameters that changed since the last token set of a replica are forwarded to it
+    std::mutex parameters_mutex_;
+    std::vector<std::set<std::string>> outdated_parameters_;
+    std::vector<slim_signal::ScopedConnection> parameter_connections_;
+
+    mutable std::mutex reorder_mutex_;
+    std::map<long, std::shared_ptr<Entry>> reorder_buffer_;
+    long last_sequence_number_;
+};
+
+}  // namespace csapex
+
+#endif  // NODE_REPLICAS_H
@@ -13,6 +13,7 @@
 #include <mutex>
 #include <atomic>
 #include <thread>
+#include <chrono>
 
 namespace csapex
 {
@@ -48,13 +49,21 @@ public:
 
     void setNodeWorker(NodeWorkerPtr worker);
 
+    /**
+     * @brief isFused returns true, iff this node is part of a chain that is executed as one task
+     */
+    bool isFused() const;
+
 private:
     void connectNodeWorker();
 
     void measureFrequency();
     void scheduleProcess();
+    void updateDeadline(std::chrono::steady_clock::time_point release);
     void checkParameters();
     void execute();
+    void executeNode();
+    bool processOnce();
     void notify();
 
 private:
@@ -77,6 +86,12 @@ private:
 
     long guard_;
     double max_frequency_;
+    double deadline_;
+
+    int batch_size_;
+    std::chrono::steady_clock::duration batch_time_slice_;
+    std::atomic<bool> batching_;
+    std::atomic<bool> batch_pending_;
 
     bool waiting_for_execution_;
 
@@ -42,6 +42,38 @@ public:
     void setMaximumFrequency(double f);
     Signal max_frequency_changed;
 
+    /**
+     * @brief getDeadline returns the relative deadline of one execution in seconds.
+     * 0 means that the deadline is implicit, i.e. equal to the period 1 / max_frequency
+     */
+    double getDeadline() const;
+    void setDeadline(double seconds);
+    Signal deadline_changed;
+
+    /**
+     * @brief getBatchSize returns how many ready token sets may be processed per dispatch.
+     * 1 disables batching
+     */
+    int getBatchSize() const;
+    void setBatchSize(int size);
+    Signal batch_size_changed;
+
+    /**
+     * @brief getReplicas returns how many token sets of a replicable node may be processed concurrently.
+     * 1 disables replication
+     */
+    int getReplicas() const;
+    void setReplicas(int replicas);
+    Signal replicas_changed;
+
+    /**
+     * @brief getCredits returns how many token sets each upstream source may have in flight towards this node.
+     * 0 disables credit based flow control
+     */
+    int getCredits() const;
+    void setCredits(int credits);
+    Signal credits_changed;
+
     Point getPos() const;
     void setPos(const Point& value, bool quiet = false);
     Signal pos_changed;
@@ -127,6 +159,10 @@ private:
     mutable GenericStatePtr parameter_state;
 
     double max_frequency_;
+    double deadline_;
+    int batch_size_;
+    int replicas_;
+    int credits_;
 
     std::string label_;
     Point pos_;
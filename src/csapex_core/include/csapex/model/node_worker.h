@@ -6,6 +6,7 @@
 #include <csapex/utility/utility_fwd.h>
 #include <csapex/msg/msg_fwd.h>
 #include <csapex/signal/signal_fwd.h>
+#include <csapex/scheduling/scheduling_fwd.h>
 #include <csapex/param/parameter.h>
 #include <csapex/model/error_state.h>
 #include <csapex/utility/uuid.h>
@@ -18,6 +19,7 @@
 #include <csapex/model/execution_state.h>
 #include <csapex/model/activity_modifier.h>
 #include <csapex/model/parameterizable.h>
+#include <csapex/model/token.h>
 
 /// SYSTEM
 #include <map>
@@ -33,6 +35,7 @@ namespace csapex
 {
 class ProfilerImplementation;
 class Interval;
+class NodeReplicas;
 
 class CSAPEX_CORE_EXPORT NodeWorker : public ErrorState, public Observer, public Notifier, private ThreadDebugHelper
 {
@@ -67,6 +70,16 @@ public:
     bool isIdle() const;
     bool isProcessing() const;
 
+    /**
+     * @brief isReplicated returns true, iff the token sets are processed concurrently by copies of the node
+     */
+    bool isReplicated() const;
+
+    /**
+     * @brief setScheduler tells the worker which scheduler executes the node, the replicas of the node are run by the same one
+     */
+    void setScheduler(Scheduler* scheduler);
+
     bool canExecute();
     bool canProcess() const;
     bool canReceive() const;
@@ -142,9 +155,20 @@ private:
 
     void rememberExecutionMode();
 
+    std::shared_ptr<NodeReplicas> getReplicas() const;
+    void resetReplicas();
+    void updateReplicas();
+    void dispatchToReplica(NodeReplicas& replicas);
+    void sendReplicaResults();
+    bool hasIncomingMarker() const;
+
     void startProfilerInterval(TracingType type);
     void stopActiveProfilerInterval();
 
+    Token::OriginsPtr collectTokenOrigins() const;
+    Token::OriginsPtr getOutgoingTokenOrigins() const;
+    void recordTokenLatencies();
+
 protected:
     mutable std::recursive_mutex sync;
 
@@ -173,6 +197,16 @@ private:
     // TimerPtr profiling_timer_;
     std::shared_ptr<ProfilerImplementation> profiler_;
 
+    // the sources of the token set that is currently processed
+    Token::OriginsPtr current_token_origins_;
+
+    // replicas hand results back via the scheduler, everyone else works on a copy of the pointer
+    mutable std::mutex replicas_mutex_;
+    std::shared_ptr<NodeReplicas> replicas_;
+    Scheduler* scheduler_;
+    slim_signal::ScopedConnection replica_results_connection_;
+    std::atomic<bool> replicas_outdated_;
+
     long guard_;
 };
 
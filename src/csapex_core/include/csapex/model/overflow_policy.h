@@ -0,0 +1,23 @@
+#ifndef OVERFLOW_POLICY_H
+#define OVERFLOW_POLICY_H
+
+namespace csapex
+{
+/**
+ * @brief The OverflowPolicy enum decides what happens to a token sent to a connection whose buffer is full
+ */
+enum class OverflowPolicy
+{
+    // the producer waits until the consumer has made room
+    BLOCK,
+    // the oldest buffered token is discarded
+    DROP_OLDEST,
+    // the new token is discarded
+    DROP_NEWEST,
+    // sample and hold: the held token is replaced by the new one, regardless of the buffer size.
+    // The producer never waits and the consumer only sees the latest token when it runs.
+    KEEP_LATEST
+};
+}
+
+#endif  // OVERFLOW_POLICY_H
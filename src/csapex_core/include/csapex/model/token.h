@@ -9,6 +9,12 @@
 #include <csapex_core/csapex_core_export.h>
 #include <csapex/model/activity_modifier.h>
 
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
 namespace csapex
 {
 class CSAPEX_CORE_EXPORT Token : public Clonable
@@ -19,8 +25,22 @@ protected:
 public:
     typedef std::shared_ptr<Token> Ptr;
 
+    /**
+     * @brief Origin records when a token set, that this token has been derived from, left a source node
+     */
+    struct Origin
+    {
+        std::string source;
+        std::chrono::steady_clock::time_point stamp;
+    };
+    typedef std::shared_ptr<const std::vector<Origin>> OriginsPtr;
+
 public:
     Token(const TokenDataConstPtr& token);
+    Token(const Token& other);
+    ~Token() override;
+
+    Token& operator=(const Token& other) = delete;
 
     void setActivityModifier(ActivityModifier active);
     bool hasActivityModifier() const;
@@ -28,9 +48,44 @@ public:
 
     TokenDataConstPtr getTokenData() const;
 
+    /**
+     * @brief getMutableTokenData returns the payload for in-place modification.
+     * The payload is shared between all tokens cloned from the same origin, so it is copied first unless this token is its only owner.
+     * Tokens that merely retain the payload do not count as owners, see markAsRetained.
+     */
+    TokenDataPtr getMutableTokenData();
+
+    /**
+     * @brief isTokenDataShared returns true, if the payload may be referenced by other tokens
+     */
+    bool isTokenDataShared() const;
+
+    /**
+     * @brief markAsRetained declares that this token only keeps its payload to hand it out again later, e.g. when an output republishes.
+     * Once a consumer has claimed the payload for modification in place, clones of a retaining token carry a NoMessage instead.
+     * In particular, connections that are enabled after the payload was claimed receive a NoMessage when the output republishes.
+     */
+    void markAsRetained();
+    bool isRetained() const;
+
     int getSequenceNumber() const;
     void setSequenceNumber(int seq_no_) const;
 
+    /**
+     * @brief getOrigins returns the sources this token has been derived from, nullptr if they are unknown.
+     * The origins are metadata of the token, they are shared between all tokens cloned from it.
+     */
+    OriginsPtr getOrigins() const;
+    void setOrigins(const OriginsPtr& origins);
+
+    /**
+     * @brief mergeOrigins combines the origins of several tokens, keeping the oldest stamp of every source
+     */
+    static OriginsPtr mergeOrigins(const std::vector<OriginsPtr>& origins);
+
+    /**
+     * @brief cloneData copies the per-edge state of other, the immutable payload is shared instead of copied
+     */
     virtual bool cloneData(const Token& other);
 
     static Ptr makeEmpty();
@@ -38,12 +93,25 @@ public:
 private:
     Token();
 
+    bool claimTokenData() const;
+    TokenDataConstPtr shareTokenData() const;
+    void releaseTokenData();
+
 private:
     TokenDataConstPtr data_;
+    // true, if data_ has been copied or claimed for this token and has not been handed to another token since.
+    // Cloning resets it on the source token, which may be cloned from several threads.
+    mutable std::atomic<bool> data_owned_;
+
+    bool retained_;
+    // the claims on data_ when this token started retaining it, a different count means that the payload has been modified
+    unsigned retained_claims_;
 
     ActivityModifier activity_modifier_;
 
     mutable int seq_no_;
+
+    OriginsPtr origins_;
 };
 
 }  // namespace csapex
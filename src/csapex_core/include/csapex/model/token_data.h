@@ -4,8 +4,11 @@
 /// COMPONENT
 #include <csapex_core/csapex_core_export.h>
 #include <csapex/serialization/streamable.h>
+#include <csapex/utility/symbol_table.h>
 
 /// SYSTEM
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -19,11 +22,17 @@ public:
     typedef std::shared_ptr<TokenData> Ptr;
     typedef std::shared_ptr<const TokenData> ConstPtr;
 
+    typedef std::uint16_t TypeId;
+
 public:
     TokenData(const std::string& type_name);
     TokenData(const std::string& type_name, const std::string& descriptive_name);
+    TokenData(SymbolTable::Id type_id);
+    TokenData(const TokenData& other);
     ~TokenData() override;
 
+    TokenData& operator=(const TokenData& other);
+
     TokenData::Ptr toType() const;
 
     virtual bool isValid() const;
@@ -38,7 +47,24 @@ public:
     virtual bool acceptsConnectionFrom(const TokenData* other_side) const;
 
     virtual std::string descriptiveName() const;
-    std::string typeName() const;
+    const std::string& typeName() const;
+
+    /**
+     * @brief typeId is the interned type name, two tokens have the same type iff their ids are equal
+     */
+    SymbolTable::Id typeId() const;
+
+    /**
+     * @brief dynamicTypeId is the id of the most derived type of this object, see MessageTypeRegistry
+     */
+    TypeId dynamicTypeId() const
+    {
+        TypeId id = dynamic_type_id_.load(std::memory_order_relaxed);
+        if (id == 0) {
+            id = lookupDynamicTypeId();
+        }
+        return id;
+    }
 
     virtual void writeNative(const std::string& file, const std::string& base, const std::string& suffix) const;
 
@@ -50,10 +76,26 @@ public:
 protected:
     TokenData();
     void setDescriptiveName(const std::string& descriptiveName);
+    void setDescriptiveName(SymbolTable::Id descriptive_name_id);
+
+private:
+    TypeId lookupDynamicTypeId() const;
 
 private:
-    std::string type_name_;
-    std::string descriptive_name_;
+    friend class Token;
+
+    SymbolTable::Id type_id_;
+    SymbolTable::Id descriptive_name_id_;
+
+    // determined on first use, since the most derived type is not known during construction
+    mutable std::atomic<TypeId> dynamic_type_id_;
+
+    // bookkeeping of the tokens that share this object, see Token::getMutableTokenData
+    mutable std::atomic<int> retaining_tokens_;
+    mutable std::atomic<int> republishing_tokens_;
+    mutable std::atomic<unsigned> claims_;
+    // claims that have been announced, but not yet decided
+    mutable std::atomic<int> pending_claims_;
 };
 
 }  // namespace csapex
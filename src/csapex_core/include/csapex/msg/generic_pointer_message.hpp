@@ -22,12 +22,13 @@ public:
     typedef std::shared_ptr<GenericPointerMessage<Type>> Ptr;
     typedef std::shared_ptr<GenericPointerMessage<Type> const> ConstPtr;
 
-    GenericPointerMessage(const std::string& _frame_id = "/", Message::Stamp stamp = 0) : Message(type<GenericPointerMessage<Type>>::name(), _frame_id, stamp)
+    GenericPointerMessage(const std::string& _frame_id = "/", Message::Stamp stamp = 0) : Message(serializationSymbol<GenericPointerMessage<Type>>(), _frame_id, stamp)
     {
         static csapex::DirectMessageConstructorRegistered<connection_types::GenericPointerMessage, Type> reg_c;
         static csapex::DirectMessageSerializerRegistered<connection_types::GenericPointerMessage, Type> reg_s;
 
-        setDescriptiveName(type2name(typeid(Type)));
+        static const SymbolTable::Id descriptive_name = SymbolTable::intern(type2name(typeid(Type)));
+        setDescriptiveName(descriptive_name);
     }
     GenericPointerMessage(const std::shared_ptr<Type>& ptr, const std::string& _frame_id = "/", Message::Stamp stamp = 0) : GenericPointerMessage(_frame_id, stamp)
     {
@@ -35,7 +35,7 @@ public:
     typedef std::shared_ptr<GenericValueMessage<Type> const> ConstPtr;
 
     explicit GenericValueMessage(const Type& _value = Type(), const std::string& _frame_id = "/", Message::Stamp stamp = 0)
-      : Message(type<GenericValueMessage<Type>>::name(), _frame_id, stamp), value(_value)
+      : Message(serializationSymbol<GenericValueMessage<Type>>(), _frame_id, stamp), value(_value)
     {
         static_assert(should_use_value_message<Type>::value, "The type should not use a value message");
         static csapex::DirectMessageConstructorRegistered<connection_types::GenericValueMessage, Type> reg_c;
@@ -180,8 +180,8 @@ struct MessageCaster<connection_types::GenericValueMessage<V>, S>
 {
     static std::shared_ptr<connection_types::GenericValueMessage<V> const> constcast(const std::shared_ptr<S const>& msg)
     {
-        // if we can dynamic cast directly, use that
-        if (auto direct = std::dynamic_pointer_cast<connection_types::GenericValueMessage<V> const>(msg)) {
+        // if we can cast directly, use that
+        if (auto direct = DefaultMessageCaster<connection_types::GenericValueMessage<V>, S>::constcast(msg)) {
             return direct;
         }
 
@@ -195,8 +195,8 @@ struct MessageCaster<connection_types::GenericValueMessage<V>, S>
 
     static std::shared_ptr<connection_types::GenericValueMessage<V>> cast(const std::shared_ptr<S>& msg)
     {
-        // if we can dynamic cast directly, use that
-        if (auto direct = std::dynamic_pointer_cast<connection_types::GenericValueMessage<V>>(msg)) {
+        // if we can cast directly, use that
+        if (auto direct = DefaultMessageCaster<connection_types::GenericValueMessage<V>, S>::cast(msg)) {
             return direct;
         }
         // if we can cast the message to the value type, create a new message of that type
@@ -4,6 +4,7 @@
 /// PROJECT
 #include <csapex/msg/message.h>
 #include <csapex/msg/token_traits.h>
+#include <csapex/msg/message_type_registry.h>
 #include <csapex/msg/any_message.h>
 #include <csapex/utility/yaml_io.hpp>
 #include <csapex/msg/generic_value_message.hpp>
@@ -13,8 +14,10 @@
 #include <csapex/utility/assert.h>
 
 /// SYSTEM
+#include <stdexcept>
 #include <string>
 #include <boost/static_assert.hpp>
+#include <type_traits>
 #include <vector>
 #undef NDEBUG
 #include <assert.h>
@@ -46,6 +49,15 @@ public:
     {
     };
 
+    /**
+     * @brief is_flat_element is true for element types that are stored in one contiguous buffer and copied bytewise
+     */
+    template <typename T>
+    struct is_flat_element
+    {
+        static constexpr bool value = std::is_trivially_copyable<T>::value && !std::is_same<T, bool>::value && !std::is_base_of<TokenData, T>::value;
+    };
+
 private:
     struct CSAPEX_CORE_EXPORT EntryInterface : public Message
     {
@@ -54,6 +66,9 @@ private:
         EntryInterface(const std::string& name, Message::Stamp stamp = 0) : Message(name, "/", stamp)
         {
         }
+        EntryInterface(SymbolTable::Id type_id, Message::Stamp stamp = 0) : Message(type_id, "/", stamp)
+        {
+        }
 
         virtual std::string nestedName() const = 0;
 
@@ -89,12 +104,18 @@ private:
         typedef std::shared_ptr<Self> Ptr;
 
     public:
-        Implementation() : EntryInterface(std::string("std::vector<") + type2nameWithoutNamespace(typeid(T)) + ">")
+        Implementation() : EntryInterface(vectorSymbol())
         {
             static_assert(!std::is_same<T, void*>::value, "void* not allowed");
             value.reset(new std::vector<Payload>);
         }
 
+        static SymbolTable::Id vectorSymbol()
+        {
+            static const SymbolTable::Id id = SymbolTable::intern(std::string("std::vector<") + type2nameWithoutNamespace(typeid(T)) + ">");
+            return id;
+        }
+
         static typename Self::Ptr make()
         {
             return Self::Ptr(new Self);
@@ -109,10 +130,10 @@ private:
 
         bool canConnectTo(const TokenData* other_side) const override
         {
-            if (const EntryInterface* ei = dynamic_cast<const EntryInterface*>(other_side)) {
+            if (const EntryInterface* ei = MessageTypeRegistry::cast<EntryInterface>(other_side)) {
                 return nestedType()->canConnectTo(ei->nestedType().get());
             } else {
-                const GenericVectorMessage* vec = dynamic_cast<const GenericVectorMessage*>(other_side);
+                const GenericVectorMessage* vec = MessageTypeRegistry::cast<GenericVectorMessage>(other_side);
                 if (vec != nullptr) {
                     // if the other side is a vector too, try if they are compatible
                     return vec->canConnectTo(this);
@@ -134,7 +155,7 @@ private:
         }
         bool acceptsConnectionFrom(const TokenData* other_side) const override
         {
-            if (const EntryInterface* ei = dynamic_cast<const EntryInterface*>(other_side)) {
+            if (const EntryInterface* ei = MessageTypeRegistry::cast<EntryInterface>(other_side)) {
                 return nestedType()->canConnectTo(ei->nestedType().get());
             } else {
                 return false;
@@ -159,6 +180,33 @@ private:
             *value = node["values"].as<std::vector<Payload>>();
         }
 
+        void serialize(SerializationBuffer& data, SemanticVersion& version) const override
+        {
+            EntryInterface::serialize(data, version);
+            if constexpr (is_flat_element<T>::value) {
+                // flat entries are written as one block, both sides have to agree on the memory layout of T
+                data << static_cast<uint64_t>(value->size());
+                data.writeRaw(reinterpret_cast<const uint8_t*>(value->data()), value->size() * sizeof(T));
+            }
+        }
+        void deserialize(const SerializationBuffer& data, const SemanticVersion& version) override
+        {
+            EntryInterface::deserialize(data, version);
+            if constexpr (is_flat_element<T>::value) {
+                uint64_t size;
+                data >> size;
+                // a corrupt size must not allocate more than the buffer can hold
+                std::size_t remaining = data.size() - data.getPos();
+                if (size > remaining / sizeof(T)) {
+                    throw std::runtime_error("cannot deserialize vector of " + std::to_string(size) + " entries, only " + std::to_string(remaining) + " bytes are left");
+                }
+                value.reset(new std::vector<Payload>(size));
+                if (size > 0) {
+                    data.readRaw(reinterpret_cast<uint8_t*>(value->data()), size * sizeof(T));
+                }
+            }
+        }
+
         TokenData::Ptr nestedType() const override
         {
             return makeTypeSwitch(Tag<Payload>());
@@ -166,11 +214,22 @@ private:
 
         void addNestedValue(const TokenData::ConstPtr& msg) override
         {
+            if (value.use_count() > 1) {
+                // the buffer is shared with views and readers of makeShared, they must not see the new entry
+                value.reset(new std::vector<Payload>(*value));
+            }
             addCastedEntry(*value, msg);
         }
         TokenData::ConstPtr nestedValue(std::size_t i) const override
         {
-            return makeToken(value->at(i));
+            if constexpr (is_flat_element<T>::value && connection_types::should_use_pointer_message<T>::value) {
+                // large flat entries are not copied, the token refers into the buffer and keeps it alive
+                auto res = csapex::makeEmpty<connection_types::GenericPointerMessage<T>>();
+                res->value = std::shared_ptr<T>(value, &value->at(i));
+                return res;
+            } else {
+                return makeToken(value->at(i));
+            }
         }
         virtual std::size_t nestedValueCount() const override
         {
@@ -493,32 +552,53 @@ public:
 
     struct SupportedTypes : public Singleton<SupportedTypes>
     {
+        SupportedTypes()
+        {
+            // values of these types are collected flat, even if no node uses a vector of them explicitly
+            add<int>(type2name(typeid(int)));
+            add<long>(type2name(typeid(long)));
+            add<float>(type2name(typeid(float)));
+            add<double>(type2name(typeid(double)));
+        }
+
         static EntryInterface::Ptr make(const std::string& type)
         {
             if (type == "::anything::") {
                 return std::make_shared<AnythingImplementation>();
             }
 
-            const std::string ns = "csapex::connection_types::";
-            std::string ns_type = type;
-            if (type.find(ns) == std::string::npos) {
-                ns_type = ns + type;
+            std::map<std::string, EntryInterface::Ptr>& map = instance().map_;
+            auto pos = map.find(type);
+            if (pos == map.end()) {
+                const std::string ns = "csapex::connection_types::";
+                if (type.find(ns) == std::string::npos) {
+                    pos = map.find(ns + type);
+                }
             }
-            auto pos = instance().map_.find(ns_type);
-            if (pos == instance().map_.end()) {
+            if (pos == map.end()) {
                 throw std::runtime_error(std::string("cannot make vector of type ") + type);
             }
             return std::dynamic_pointer_cast<EntryInterface>(pos->second->makeEmptyInstance());
         }
 
+        /**
+         * @brief makeFlat creates a flat implementation for entries like element, if there is one
+         */
+        static EntryInterface::Ptr makeFlat(const TokenData& element)
+        {
+            std::map<MessageTypeRegistry::Id, EntryInterface::Ptr>& flat = instance().flat_;
+            auto pos = flat.find(element.dynamicTypeId());
+            if (pos == flat.end()) {
+                return nullptr;
+            }
+            return std::dynamic_pointer_cast<EntryInterface>(pos->second->makeEmptyInstance());
+        }
+
         template <typename T>
         static void registerType(const std::string& type_name = "")
         {
             std::string type = type_name.empty() ? type2name(typeid(T)) : type_name;
-            std::map<std::string, EntryInterface::Ptr>& map = instance().map_;
-            if (map.find(type) == map.end()) {
-                Adder<T>::addToMap(instance().map_, type);
-            }
+            instance().add<T>(type);
         }
 
         template <typename T>
@@ -535,10 +615,30 @@ public:
         void shutdown() override
         {
             map_.clear();
+            flat_.clear();
+        }
+
+    private:
+        template <typename T>
+        void add(const std::string& type)
+        {
+            if (map_.find(type) == map_.end()) {
+                Adder<T>::addToMap(map_, type);
+            }
+            if constexpr (is_flat_element<T>::value) {
+                typedef typename std::conditional<connection_types::should_use_value_message<T>::value, GenericValueMessage<T>, GenericPointerMessage<T>>::type EntryMessage;
+                MessageTypeRegistry::Id entry_type = MessageTypeRegistry::id<EntryMessage>();
+                if (flat_.find(entry_type) == flat_.end()) {
+                    flat_[entry_type] = Implementation<T>::make();
+                }
+            }
         }
 
     private:
         std::map<std::string, EntryInterface::Ptr> map_;
+
+        // flat implementations by the type id of their entries
+        std::map<MessageTypeRegistry::Id, EntryInterface::Ptr> flat_;
     };
 
     template <typename T>
@@ -578,6 +678,10 @@ public:
 
     static GenericVectorMessage::Ptr make(TokenData::ConstPtr type)
     {
+        // entries of flat types are stored contiguously instead of as individual tokens
+        if (EntryInterface::Ptr flat = SupportedTypes::makeFlat(*type)) {
+            return GenericVectorMessage::Ptr(new GenericVectorMessage(flat, "/", 0));
+        }
         return GenericVectorMessage::Ptr(new GenericVectorMessage(std::make_shared<InstancedImplementation>(type), "/", 0));
     }
 
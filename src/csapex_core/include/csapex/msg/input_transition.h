@@ -36,6 +36,12 @@ public:
 
     int findHighestDeviantSequenceNumber() const;
 
+    /**
+     * @brief setPipelining lets all connections accept the next token while the current one is processed
+     */
+    void setPipelining(bool pipelining);
+    bool isPipelining() const;
+
     bool isEnabled() const override;
 
     void connectionRemoved(Connection* connection) override;
@@ -55,6 +61,8 @@ private:
 
     bool forwarded_;
     bool processed_;
+
+    bool pipelining_;
 };
 
 }  // namespace csapex
@@ -7,6 +7,7 @@
 #include <csapex/msg/token_traits.h>
 #include <csapex/utility/uuid.h>
 #include <csapex/msg/message_allocator.h>
+#include <csapex/msg/message_type_registry.h>
 
 namespace boost
 {
@@ -69,13 +70,34 @@ void trigger(Event* input, const T value, typename std::enable_if<connection_typ
 template <typename R, typename S>
 struct DefaultMessageCaster
 {
+    // down casts between message types are checked with the MessageTypeRegistry instead of RTTI
+    static constexpr bool is_message_down_cast = std::is_base_of<TokenData, S>::value && std::is_base_of<S, R>::value && std::is_convertible<R*, S*>::value;
+
     static std::shared_ptr<R const> constcast(const std::shared_ptr<S const>& msg)
     {
-        return std::dynamic_pointer_cast<R const>(msg);
+        if constexpr (std::is_convertible<S*, R*>::value) {
+            return msg;
+        } else if constexpr (is_message_down_cast) {
+            if (msg && MessageTypeRegistry::isInstance<R>(*msg)) {
+                return std::static_pointer_cast<R const>(msg);
+            }
+            return nullptr;
+        } else {
+            return std::dynamic_pointer_cast<R const>(msg);
+        }
     }
     static std::shared_ptr<R> cast(const std::shared_ptr<S>& msg)
     {
-        return std::dynamic_pointer_cast<R>(msg);
+        if constexpr (std::is_convertible<S*, R*>::value) {
+            return msg;
+        } else if constexpr (is_message_down_cast) {
+            if (msg && MessageTypeRegistry::isInstance<R>(*msg)) {
+                return std::static_pointer_cast<R>(msg);
+            }
+            return nullptr;
+        } else {
+            return std::dynamic_pointer_cast<R>(msg);
+        }
     }
 };
 
@@ -165,6 +187,23 @@ std::shared_ptr<R> getClonedMessage(Input* input)
     return message_cast<R>(msg->cloneRaw());
 }
 
+/**
+ * @brief getMutableMessage returns the message of input for in-place modification.
+ * Messages are shared between all receivers, so the message is copied first unless the input holds the only reference.
+ */
+CSAPEX_CORE_EXPORT TokenDataPtr getMutableMessage(Input* input);
+
+template <typename R>
+std::shared_ptr<R> getMutableMessage(Input* input)
+{
+    TokenDataPtr msg = getMutableMessage(input);
+    typename std::shared_ptr<R> result = message_cast<R>(msg);
+    if (!result) {
+        throwError(msg, typeid(R));
+    }
+    return result;
+}
+
 template <typename R>
 R getValue(Input* input)
 {
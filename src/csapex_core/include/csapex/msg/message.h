@@ -25,6 +25,7 @@ public:
 
 protected:
     Message(const std::string& name, const std::string& frame_id, Stamp stamp_micro_seconds);
+    Message(SymbolTable::Id type_id, const std::string& frame_id, Stamp stamp_micro_seconds);
     ~Message() override;
 
     bool cloneDataFrom(const Clonable& other) override;
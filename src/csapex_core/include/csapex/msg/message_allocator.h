@@ -5,10 +5,21 @@
 #include <csapex_core/csapex_core_export.h>
 
 /// SYSTEM
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
 
 namespace csapex
 {
+namespace connection_types
+{
+struct MessageTemplateBase;
+}
+
 class MessageAllocatorImplementationInterface
 {
 public:
@@ -72,6 +83,249 @@ private:
     Alloc alloc_;
 };
 
+class MessagePoolInterface
+{
+public:
+    virtual ~MessagePoolInterface() = default;
+
+    virtual void setCapacity(std::size_t capacity) = 0;
+    virtual std::size_t size() const = 0;
+};
+
+/**
+ * @brief MessagePool keeps the messages that were allocated for one type, so that they can be reused
+ *        once all consumers have released them.
+ *
+ * The pool does not hold any reference to a message while it is in use, released messages are returned
+ * by the deleter of the handed out pointer. This way, the use count of a message only reflects its consumers.
+ * The memory of the control blocks of the handed out pointers is kept as well, so taking a message does not allocate.
+ */
+template <typename T>
+class MessagePool : public MessagePoolInterface
+{
+private:
+    struct State
+    {
+        ~State()
+        {
+            for (void* block : blocks) {
+                ::operator delete(block);
+            }
+        }
+
+        std::mutex mutex;
+        std::vector<T*> released;
+        std::size_t owned;
+        std::size_t capacity;
+        bool alive;
+
+        // memory of released control blocks, they all have the same size
+        std::vector<void*> blocks;
+        std::size_t block_size = 0;
+    };
+
+    class Recycler
+    {
+    public:
+        Recycler(const std::shared_ptr<State>& state) : state_(state)
+        {
+        }
+
+        void operator()(T* ptr) const noexcept
+        {
+            {
+                // the lock also makes the changes of the last consumer visible to the next user
+                std::unique_lock<std::mutex> lock(state_->mutex);
+                if (state_->alive && state_->owned <= state_->capacity) {
+                    state_->released.push_back(ptr);
+                    return;
+                }
+                --state_->owned;
+            }
+            delete ptr;
+        }
+
+    private:
+        std::shared_ptr<State> state_;
+    };
+
+    /**
+     * @brief The BlockAllocator class provides the memory for the control blocks of the handed out pointers
+     */
+    template <typename U>
+    class BlockAllocator
+    {
+    public:
+        typedef U value_type;
+
+        BlockAllocator(const std::shared_ptr<State>& state) : state(state)
+        {
+        }
+
+        template <typename V>
+        BlockAllocator(const BlockAllocator<V>& other) : state(other.state)
+        {
+        }
+
+        U* allocate(std::size_t n)
+        {
+            std::size_t size = n * sizeof(U);
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                if (size == state->block_size && !state->blocks.empty()) {
+                    void* block = state->blocks.back();
+                    state->blocks.pop_back();
+                    return static_cast<U*>(block);
+                }
+            }
+            return static_cast<U*>(::operator new(size));
+        }
+
+        void deallocate(U* ptr, std::size_t n) noexcept
+        {
+            std::size_t size = n * sizeof(U);
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                if (state->alive && state->blocks.size() < state->capacity && (state->block_size == 0 || state->block_size == size)) {
+                    state->block_size = size;
+                    state->blocks.push_back(ptr);
+                    return;
+                }
+            }
+            ::operator delete(ptr);
+        }
+
+        template <typename V>
+        bool operator==(const BlockAllocator<V>& other) const
+        {
+            return state == other.state;
+        }
+        template <typename V>
+        bool operator!=(const BlockAllocator<V>& other) const
+        {
+            return state != other.state;
+        }
+
+        std::shared_ptr<State> state;
+    };
+
+    std::shared_ptr<T> makePointer(T* ptr)
+    {
+        return std::shared_ptr<T>(ptr, Recycler(state_), BlockAllocator<T>(state_));
+    }
+
+public:
+    MessagePool(std::size_t capacity) : state_(std::make_shared<State>())
+    {
+        state_->owned = 0;
+        state_->capacity = capacity;
+        state_->alive = true;
+    }
+
+    ~MessagePool() override
+    {
+        std::vector<T*> released;
+        std::vector<void*> blocks;
+        {
+            std::unique_lock<std::mutex> lock(state_->mutex);
+            // messages that are still in use are deleted by their last consumer
+            state_->alive = false;
+            state_->owned -= state_->released.size();
+            released.swap(state_->released);
+            blocks.swap(state_->blocks);
+        }
+        for (T* ptr : released) {
+            delete ptr;
+        }
+        for (void* block : blocks) {
+            ::operator delete(block);
+        }
+    }
+
+    /**
+     * @brief take returns a message that is not referenced anywhere else, or nullptr
+     */
+    std::shared_ptr<T> take()
+    {
+        T* ptr = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(state_->mutex);
+            if (state_->released.empty()) {
+                return nullptr;
+            }
+            ptr = state_->released.back();
+            state_->released.pop_back();
+        }
+        return makePointer(ptr);
+    }
+
+    /**
+     * @brief add hands out a newly allocated message, which is returned to the pool once released if there is capacity left
+     */
+    std::shared_ptr<T> add(std::unique_ptr<T> message)
+    {
+        {
+            std::unique_lock<std::mutex> lock(state_->mutex);
+            if (state_->owned >= state_->capacity) {
+                return std::shared_ptr<T>(std::move(message));
+            }
+            ++state_->owned;
+        }
+        return makePointer(message.release());
+    }
+
+    void setCapacity(std::size_t capacity) override
+    {
+        std::vector<T*> surplus;
+        std::vector<void*> surplus_blocks;
+        {
+            std::unique_lock<std::mutex> lock(state_->mutex);
+            state_->capacity = capacity;
+            while (state_->owned > state_->capacity && !state_->released.empty()) {
+                surplus.push_back(state_->released.back());
+                state_->released.pop_back();
+                --state_->owned;
+            }
+            while (state_->blocks.size() > state_->capacity) {
+                surplus_blocks.push_back(state_->blocks.back());
+                state_->blocks.pop_back();
+            }
+        }
+        for (T* ptr : surplus) {
+            delete ptr;
+        }
+        for (void* block : surplus_blocks) {
+            ::operator delete(block);
+        }
+    }
+
+    std::size_t size() const override
+    {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        return state_->owned;
+    }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+namespace detail
+{
+template <typename T>
+struct is_poolable_message
+{
+    static constexpr bool value = std::is_base_of<connection_types::MessageTemplateBase, T>::value && std::is_move_assignable<T>::value;
+};
+}  // namespace detail
+
+/**
+ * @brief MessageAllocator creates the messages that are published via an output.
+ *
+ * Messages generated from MessageTemplate are recycled by default: every allocator keeps a small pool per type
+ * and hands out a pooled message again as soon as all consumers have released it.
+ * allocate only reuses the message object and its control block, its contents are constructed anew, so the
+ * buffers of the previous contents are released. recycle keeps the contents, so that their buffers can be reused.
+ */
 class CSAPEX_CORE_EXPORT MessageAllocator
 {
 public:
@@ -93,9 +347,40 @@ public:
                 allocator_->deallocate(raw);
                 return nullptr;
             }
-        } else {
-            return std::make_shared<T>(std::forward<Args>(args)...);
         }
+
+        if constexpr (detail::is_poolable_message<T>::value) {
+            if (pooling_) {
+                if (std::shared_ptr<T> msg = takePooled<T>()) {
+                    // only the object shell is reused, see recycle for reusing the buffers
+                    *msg = T(std::forward<Args>(args)...);
+                    return msg;
+                }
+
+                std::unique_ptr<T> msg(new T(std::forward<Args>(args)...));
+                std::unique_lock<std::mutex> lock(pool_mutex_);
+                return getPool<T>().add(std::move(msg));
+            }
+        }
+
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief recycle returns a pooled message without resetting its contents, so that its buffers can be reused.
+     *        All data of the message has to be overwritten, falls back to allocate if nothing can be recycled.
+     */
+    template <typename T>
+    std::shared_ptr<T> recycle()
+    {
+        if constexpr (detail::is_poolable_message<T>::value) {
+            if (pooling_ && !allocator_) {
+                if (std::shared_ptr<T> msg = takePooled<T>()) {
+                    return msg;
+                }
+            }
+        }
+        return allocate<T>();
     }
 
     template <typename T, typename Alloc>
@@ -105,8 +390,51 @@ public:
         allocator_ = new MessageAllocatorImplementation<T, Alloc>(alloc);
     }
 
+    void setPooling(bool pooling);
+    bool isPooling() const;
+
+    void setPoolCapacity(std::size_t capacity);
+    std::size_t getPoolCapacity() const;
+    std::size_t getPoolSize() const;
+    void clearPool();
+
+    std::size_t getPoolHits() const;
+    std::size_t getPoolMisses() const;
+
+private:
+    template <typename T>
+    MessagePool<T>& getPool()
+    {
+        std::unique_ptr<MessagePoolInterface>& pool = pools_[std::type_index(typeid(T))];
+        if (!pool) {
+            pool.reset(new MessagePool<T>(pool_capacity_));
+        }
+        return static_cast<MessagePool<T>&>(*pool);
+    }
+
+    template <typename T>
+    std::shared_ptr<T> takePooled()
+    {
+        std::unique_lock<std::mutex> lock(pool_mutex_);
+        std::shared_ptr<T> msg = getPool<T>().take();
+        if (msg) {
+            ++pool_hits_;
+        } else {
+            ++pool_misses_;
+        }
+        return msg;
+    }
+
 private:
     MessageAllocatorImplementationInterface* allocator_;
+
+    std::atomic<bool> pooling_;
+    std::size_t pool_capacity_;
+
+    mutable std::mutex pool_mutex_;
+    std::map<std::type_index, std::unique_ptr<MessagePoolInterface>> pools_;
+    std::size_t pool_hits_;
+    std::size_t pool_misses_;
 };
 
 }  // namespace csapex
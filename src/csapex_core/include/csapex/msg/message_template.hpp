@@ -131,15 +131,15 @@ public:
     typedef MessageTemplateContainer<Type, std::is_integral<Type>::value> ValueContainer;
     typedef MessageTemplate<Type, Instance> Self;
 
-    explicit MessageTemplate(const std::string& _frame_id = "/", Message::Stamp stamp = 0) : Message(type<Instance>::name(), _frame_id, stamp)
+    explicit MessageTemplate(const std::string& _frame_id = "/", Message::Stamp stamp = 0) : Message(serializationSymbol<Instance>(), _frame_id, stamp)
     {
     }
 
-    MessageTemplate(const Self& copy) : Message(type<Instance>::name(), copy.frame_id, copy.stamp_micro_seconds), ValueContainer(static_cast<const ValueContainer&>(copy))
+    MessageTemplate(const Self& copy) : Message(serializationSymbol<Instance>(), copy.frame_id, copy.stamp_micro_seconds), ValueContainer(static_cast<const ValueContainer&>(copy))
     {
     }
 
-    MessageTemplate(Self&& moved) : Message(type<Instance>::name(), moved.frame_id, moved.stamp_micro_seconds), ValueContainer(static_cast<ValueContainer&&>(moved))
+    MessageTemplate(Self&& moved) : Message(serializationSymbol<Instance>(), moved.frame_id, moved.stamp_micro_seconds), ValueContainer(static_cast<ValueContainer&&>(moved))
     {
     }
 
@@ -154,7 +154,7 @@ public:
     {
         ValueContainer::operator=(std::move(other));
         frame_id = std::move(other.frame_id);
-        stamp_micro_seconds = std::move(stamp_micro_seconds);
+        stamp_micro_seconds = std::move(other.stamp_micro_seconds);
         return *this;
     }
 
@@ -225,8 +225,8 @@ struct MessageCaster<Instance, S, typename std::enable_if<std::is_base_of<connec
     using V = typename Instance::value_type;
     static std::shared_ptr<Instance const> constcast(const std::shared_ptr<S const>& msg)
     {
-        // if we can dynamic cast directly, use that
-        if (auto direct = std::dynamic_pointer_cast<Instance const>(msg)) {
+        // if we can cast directly, use that
+        if (auto direct = DefaultMessageCaster<Instance, S>::constcast(msg)) {
             return direct;
         }
 
@@ -249,8 +249,8 @@ struct MessageCaster<Instance, S, typename std::enable_if<std::is_base_of<connec
     }
     static std::shared_ptr<Instance> cast(const std::shared_ptr<S>& msg)
     {
-        // if we can dynamic cast directly, use that
-        if (auto direct = std::dynamic_pointer_cast<Instance>(msg)) {
+        // if we can cast directly, use that
+        if (auto direct = DefaultMessageCaster<Instance, S>::cast(msg)) {
             return direct;
         }
 
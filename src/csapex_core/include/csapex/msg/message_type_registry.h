@@ -0,0 +1,89 @@
+#ifndef MESSAGE_TYPE_REGISTRY_H
+#define MESSAGE_TYPE_REGISTRY_H
+
+/// COMPONENT
+#include <csapex/model/token_data.h>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <cstdint>
+#include <type_traits>
+#include <typeinfo>
+
+namespace csapex
+{
+/**
+ * @brief MessageTypeRegistry assigns compact ids to message types and keeps a table of which types are subtypes of which.
+ *
+ * Message types get their id when they are registered, every other type when it is used first. The first token of a
+ * type relates it to all known types at once, later checks of the same pair of types are a table lookup, so that
+ * casting a message does not need a dynamic_cast per token.
+ */
+class CSAPEX_CORE_EXPORT MessageTypeRegistry
+{
+public:
+    typedef TokenData::TypeId Id;
+    typedef bool (*InstanceCheck)(const TokenData&);
+
+    static constexpr Id UNKNOWN = 0;
+
+public:
+    template <typename T>
+    static Id id()
+    {
+        static const Id id = getId(typeid(T), &checkInstance<T>);
+        return id;
+    }
+
+    /**
+     * @brief isInstance checks whether data is a T or derived from T
+     */
+    template <typename T>
+    static bool isInstance(const TokenData& data)
+    {
+        Id type = data.dynamicTypeId();
+        Id target = id<T>();
+        if (type == target) {
+            return true;
+        }
+        return isSubtype(type, target, data, &checkInstance<T>);
+    }
+
+    /**
+     * @brief cast is a replacement for dynamic_cast to message types
+     */
+    template <typename T>
+    static const T* cast(const TokenData* data)
+    {
+        static_assert(std::is_base_of<TokenData, T>::value, "only message types can be casted");
+        if (data && isInstance<T>(*data)) {
+            return static_cast<const T*>(data);
+        }
+        return nullptr;
+    }
+
+    static Id getId(const std::type_info& type);
+    static Id getId(const std::type_info& type, InstanceCheck check);
+    static std::size_t size();
+
+private:
+    template <typename T>
+    static bool checkInstance(const TokenData& data)
+    {
+        if constexpr (std::is_base_of<T, TokenData>::value) {
+            // every message is a T, casting a reference would only be compared against nullptr
+            return true;
+        } else {
+            return dynamic_cast<const T*>(&data) != nullptr;
+        }
+    }
+
+    static bool isSubtype(Id type, Id target, const TokenData& data, InstanceCheck check);
+
+    friend class TokenData;
+    static Id getDynamicId(const TokenData& data);
+};
+
+}  // namespace csapex
+
+#endif  // MESSAGE_TYPE_REGISTRY_H
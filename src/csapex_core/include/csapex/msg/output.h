@@ -61,6 +61,10 @@ public:
     virtual bool canSendMessages() const;
     virtual bool commitMessages(bool is_activated) = 0;
     virtual void publish();
+    /**
+     * @brief republish hands the current message to the enabled connections that have already processed it, e.g. ones that were enabled late.
+     * If a consumer has already claimed the payload for modification in place, these connections receive a NoMessage, see Token::markAsRetained.
+     */
     virtual void republish();
     virtual TokenPtr getToken() const = 0;
     virtual TokenPtr getAddedToken() = 0;
@@ -4,6 +4,7 @@
 /// COMPONENT
 #include <csapex/msg/transition.h>
 #include <csapex/utility/uuid.h>
+#include <csapex/model/token.h>
 
 /// SYSTEM
 #include <unordered_map>
@@ -29,7 +30,11 @@ public:
     long getSequenceNumber() const;
 
     bool canStartSendingMessages() const;
-    bool sendMessages(bool is_active);
+    /**
+     * @brief sendMessages commits the messages of all outputs
+     * @param origins if set, the sent tokens are marked as derived from these origins
+     */
+    bool sendMessages(bool is_active, const Token::OriginsPtr& origins = nullptr);
     void tokenProcessed();
 
     void clearBuffer();
@@ -43,6 +48,9 @@ public:
 public:
     slim_signal::Signal<void()> messages_processed;
 
+protected:
+    void observeConnectionState(Connection& connection, ConnectionStateCounter* counter) override;
+
 private:
     void fillConnections();
 
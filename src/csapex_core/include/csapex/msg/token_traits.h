@@ -27,6 +27,16 @@ inline std::string serializationName()
     return type<TT>::name();
 }
 
+/**
+ * @brief serializationSymbol returns the interned serialization name, the name is only generated once per type
+ */
+template <typename T>
+inline SymbolTable::Id serializationSymbol()
+{
+    static const SymbolTable::Id id = SymbolTable::intern(serializationName<T>());
+    return id;
+}
+
 TokenPtr makeToken(const TokenDataConstPtr& data);
 
 template <typename T>
@@ -3,9 +3,12 @@
 
 /// COMPONENT
 #include <csapex/model/connection.h>
+#include <csapex/model/connection_state_counter.h>
 #include <csapex/utility/delegate.h>
 
 /// SYSTEM
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -41,8 +44,21 @@ public:
     bool areAllConnections(Connection::State a, /*or*/ Connection::State b, /*or*/ Connection::State c) const;
     bool isOneConnection(Connection::State state) const;
 
+    /**
+     * @brief countConnections returns the number of enabled connections that are in the given state
+     */
+    int countConnections(Connection::State state) const;
+
     std::vector<ConnectionPtr> getConnections() const;
 
+    /**
+     * @brief freeze takes a snapshot of the enabled connections, which is used for iterating them until thaw is called.
+     * The snapshot is read without locking, a reader keeps the snapshot it has loaded alive until it is done with it.
+     */
+    void freeze();
+    void thaw();
+    bool isFrozen() const;
+
 public:
     slim_signal::Signal<void()> enabled_changed;
 
@@ -50,8 +66,15 @@ protected:
     virtual void connectionAdded(Connection* connection);
     virtual void connectionRemoved(Connection* connection);
 
+    /**
+     * @brief observeConnectionState lets counter track the state of connection as seen from this side of the connection
+     */
+    virtual void observeConnectionState(Connection& connection, ConnectionStateCounter* counter);
+
     void trackConnection(Connection* connection, const slim_signal::Connection& c);
 
+    std::shared_ptr<const std::vector<ConnectionPtr>> getFrozenConnections() const;
+
 protected:
     delegate::Delegate0<> activation_fn_;
 
@@ -59,7 +82,14 @@ protected:
 
     std::map<Connection*, std::vector<slim_signal::Connection>> signal_connections_;
 
+    // the connections update the counts, so that readiness checks do not have to visit them
+    ConnectionStateCounter state_counter_;
+
     mutable std::recursive_mutex sync;
+
+private:
+    // only accessed via std::atomic_load and std::atomic_store
+    std::shared_ptr<const std::vector<ConnectionPtr>> frozen_connections_;
 };
 
 }  // namespace csapex
@@ -0,0 +1,50 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+/// COMPONENT
+#include <csapex_core/csapex_profiling_export.h>
+
+/// SYSTEM
+#include <cstddef>
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief The Histogram class counts non-negative values in logarithmic buckets.
+ * Bucket 0 contains values below 1, bucket i > 0 contains values in [2^(i-1), 2^i).
+ */
+class CSAPEX_PROFILING_EXPORT Histogram
+{
+public:
+    static constexpr std::size_t BUCKETS = 48;
+
+public:
+    Histogram();
+
+    void add(double value);
+    void reset();
+
+    std::size_t count() const;
+    double getMean() const;
+    double getMax() const;
+
+    /**
+     * @brief getPercentile returns an upper bound for the given fraction of all values
+     * @param p fraction in [0, 1]
+     */
+    double getPercentile(double p) const;
+
+    const std::vector<std::size_t>& getBuckets() const;
+    static double getUpperBound(std::size_t bucket);
+
+private:
+    std::vector<std::size_t> buckets_;
+    std::size_t count_;
+    double sum_;
+    double max_;
+};
+
+}  // namespace csapex
+
+#endif  // HISTOGRAM_H
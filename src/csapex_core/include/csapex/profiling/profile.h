@@ -3,12 +3,14 @@
 
 /// COMPONENT
 #include <csapex/profiling/timer.h>
+#include <csapex/profiling/histogram.h>
 #include <csapex_core/csapex_profiling_export.h>
 
 /// SYSTEM
 #define BOOST_PARAMETER_MAX_ARITY 7
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
+#include <mutex>
 
 namespace csapex
 {
@@ -36,10 +38,33 @@ public:
     Interval::Ptr getInterval(const std::size_t index) const;
 
     ProfilerStats getStats(const std::string& name) const;
+
+    // counters, histograms and latencies are recorded concurrently, so they are returned as copies
+
+    /**
+     * @brief getCounter returns how often an event has been counted since the last reset
+     */
+    std::size_t getCounter(const std::string& name) const;
+    std::map<std::string, std::size_t> getCounters() const;
+
+    /**
+     * @brief getHistogram returns the distribution of a recorded quantity, empty if nothing has been recorded
+     */
+    Histogram getHistogram(const std::string& name) const;
+    std::map<std::string, Histogram> getHistograms() const;
+
+    /**
+     * @brief getLatencies returns the end-to-end latency of the tokens, indexed by the source they originated from
+     */
+    std::map<std::string, Histogram> getLatencies() const;
+
     void reset();
 
 protected:
     void addInterval(Interval::Ptr interval);
+    void incrementCounter(const std::string& name, std::size_t amount);
+    void addToHistogram(const std::string& name, double value);
+    void addLatency(const std::string& source, double value);
 
 private:
     Timer::Ptr timer;
@@ -52,6 +77,11 @@ private:
     std::map<std::string, accumulator> steps_acc_;
     std::vector<Interval::Ptr> timer_history_;
     unsigned int count_;
+
+    mutable std::mutex records_mutex_;
+    std::map<std::string, std::size_t> counters_;
+    std::map<std::string, Histogram> histograms_;
+    std::map<std::string, Histogram> latencies_;
 };
 
 }  // namespace csapex
@@ -9,6 +9,7 @@
 
 /// SYSTEM
 #include <map>
+#include <mutex>
 
 namespace csapex
 {
@@ -26,13 +27,29 @@ public:
     Timer::Ptr getTimer(const std::string& key);
     const Profile& getProfile(const std::string& key);
 
+    /**
+     * @brief incrementCounter, addToHistogram and addLatency can be called concurrently from any thread
+     */
+    void incrementCounter(const std::string& key, const std::string& counter, std::size_t amount = 1);
+    void addToHistogram(const std::string& key, const std::string& histogram, double value);
+
+    /**
+     * @brief addLatency records the time [µs] a token needed from the given source to the profiled sink
+     */
+    void addLatency(const std::string& key, const std::string& source, double value);
+
 public:
     slim_signal::Signal<void(bool)> enabled_changed;
 
 protected:
     Profiler(bool enabled, int history);
 
+private:
+    Profile& findOrCreateProfile(const std::string& key);
+
 protected:
+    // guards the insertion of profiles, the profiles themselves are never removed
+    std::mutex profiles_mutex_;
     std::map<std::string, Profile> profiles_;
 
     bool enabled_;
@@ -13,6 +13,29 @@ namespace csapex
 {
 class CSAPEX_CORE_EXPORT Scheduler
 {
+public:
+    /**
+     * @brief The QueueType enum selects how tasks are submitted.
+     * LOCKED:    every submission synchronizes with the executing threads.
+     * LOCK_FREE: submissions go to a bounded lock-free ring, producers only synchronize to wake up idle threads.
+     */
+    enum class QueueType
+    {
+        LOCKED,
+        LOCK_FREE
+    };
+
+    /**
+     * @brief The SchedulingPolicy enum selects the order in which ready tasks are executed.
+     * PRIORITY:                tasks with a higher priority first, FIFO otherwise.
+     * EARLIEST_DEADLINE_FIRST: tasks with the earliest absolute deadline first, tasks without a deadline last.
+     */
+    enum class SchedulingPolicy
+    {
+        PRIORITY,
+        EARLIEST_DEADLINE_FIRST
+    };
+
 public:
     virtual ~Scheduler();
 
@@ -34,6 +57,12 @@ public:
 
     virtual bool isEmpty() const = 0;
 
+    virtual QueueType getQueueType() const = 0;
+    virtual void setQueueType(QueueType type) = 0;
+
+    virtual SchedulingPolicy getSchedulingPolicy() const = 0;
+    virtual void setSchedulingPolicy(SchedulingPolicy policy) = 0;
+
     virtual void add(TaskGeneratorPtr schedulable) = 0;
     virtual void add(TaskGeneratorPtr schedulable, const std::vector<TaskPtr>& initial_tasks) = 0;
     virtual std::vector<TaskPtr> remove(TaskGenerator* schedulable) = 0;
@@ -41,6 +70,12 @@ public:
     virtual void schedule(TaskPtr schedulable) = 0;
     virtual void scheduleDelayed(TaskPtr schedulable, std::chrono::system_clock::time_point time) = 0;
 
+    /**
+     * @brief executeInline executes a task in the calling thread, iff no other task of its generator is executing
+     * @return false, iff the task has not been executed
+     */
+    virtual bool executeInline(TaskPtr task) = 0;
+
 public:
     slim_signal::Signal<void()> stepping_enabled;
     slim_signal::Signal<void()> begin_step;
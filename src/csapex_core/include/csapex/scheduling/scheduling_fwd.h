@@ -18,8 +18,11 @@ FWD(Scheduler)
 FWD(TaskGenerator)
 FWD(ThreadPool)
 FWD(ThreadGroup)
+FWD(ThreadPlacement)
+FWD(ThreadRebalancer)
 FWD(Task)
-FWD(TimedQueue)
+FWD(TaskRing)
+FWD(TimerWheel)
 }  // namespace csapex
 
 #undef FWD
@@ -8,6 +8,8 @@
 /// SYSTEM
 #include <functional>
 #include <string>
+#include <atomic>
+#include <chrono>
 
 namespace csapex
 {
@@ -25,6 +27,25 @@ public:
     void setScheduled(bool scheduled);
     bool isScheduled() const;
 
+    /**
+     * @brief markScheduled atomically sets the scheduled flag
+     * @return false, iff the task was already scheduled
+     */
+    bool markScheduled();
+
+    /**
+     * @brief setDeadline sets the absolute time by which the task should be finished, time_point::max means no deadline
+     */
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+    std::chrono::steady_clock::time_point getDeadline() const;
+    bool hasDeadline() const;
+
+    /**
+     * @brief setEnqueueTime remembers when the task was handed to a scheduler, to measure how long it waited
+     */
+    void setEnqueueTime(std::chrono::steady_clock::time_point time);
+    std::chrono::steady_clock::time_point getEnqueueTime() const;
+
     TaskGenerator* getParent() const;
     std::string getName() const;
 
@@ -34,7 +55,9 @@ private:
     std::function<void()> callback_;
 
     long priority_;
-    bool scheduled_;
+    std::atomic<bool> scheduled_;
+    std::atomic<std::chrono::steady_clock::rep> deadline_;
+    std::atomic<std::chrono::steady_clock::rep> enqueue_time_;
 };
 
 }  // namespace csapex
@@ -0,0 +1,53 @@
+#ifndef TASK_RING_H
+#define TASK_RING_H
+
+/// PROJECT
+#include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex/utility/mpsc_ring.hpp>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <array>
+#include <memory>
+
+namespace csapex
+{
+/**
+ * @brief The TaskRing class is a bounded, lock-free queue for submitting tasks.
+ * Tasks are sorted into priority buckets, each bucket is a multi-producer / single-consumer ring.
+ * Tasks with a priority above the highest bucket share the highest bucket, negative priorities share the lowest one.
+ */
+class CSAPEX_CORE_EXPORT TaskRing
+{
+public:
+    enum
+    {
+        BUCKETS = 4
+    };
+
+    static std::size_t bucketOf(long priority);
+
+public:
+    explicit TaskRing(std::size_t capacity_per_bucket);
+
+    /**
+     * @brief push enqueues a task, can be called from any thread
+     * @return false, iff the bucket of the task is full
+     */
+    bool push(const TaskPtr& task);
+
+    /**
+     * @brief pop dequeues the oldest task of the highest non-empty bucket, must only be called by one thread at a time
+     * @return nullptr, iff the ring is empty
+     */
+    TaskPtr pop();
+
+    bool empty() const;
+
+private:
+    std::array<std::unique_ptr<MpscRing<TaskPtr>>, BUCKETS> buckets_;
+};
+
+}  // namespace csapex
+
+#endif  // TASK_RING_H
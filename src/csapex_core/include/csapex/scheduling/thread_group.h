@@ -17,6 +17,8 @@
 #include <condition_variable>
 #include <deque>
 #include <set>
+#include <map>
+#include <mutex>
 
 namespace YAML
 {
@@ -36,12 +38,60 @@ public:
         MINIMUM_THREAD_ID = 2
     };
 
+    enum
+    {
+        INBOX_CAPACITY = 1024
+    };
+
+    /**
+     * @brief The LoadStatistics struct summarizes the work done by a group during one sampling period
+     */
+    struct LoadStatistics
+    {
+        std::chrono::steady_clock::duration period{};
+        // time spent executing tasks, summed over all workers
+        std::chrono::steady_clock::duration busy{};
+        // time tasks spent in the queues before they were executed
+        std::chrono::steady_clock::duration wait{};
+        std::size_t tasks = 0;
+        std::map<TaskGenerator*, std::chrono::steady_clock::duration> generators;
+    };
+
+    enum class RealtimePolicy
+    {
+        NONE,
+        FIFO,
+        ROUND_ROBIN
+    };
+
+    /**
+     * @brief The RealtimeSettings struct describes how the operating system schedules the workers of a group
+     */
+    struct RealtimeSettings
+    {
+        RealtimePolicy policy = RealtimePolicy::NONE;
+        // static priority for SCHED_FIFO / SCHED_RR, ignored for RealtimePolicy::NONE
+        int priority = 0;
+        // lock all current and future pages of the process into memory while the group is running
+        bool lock_memory = false;
+        // bytes of each worker stack that are touched before the first task is executed
+        std::size_t stack_prefault = 0;
+
+        bool operator==(const RealtimeSettings& other) const;
+        bool operator!=(const RealtimeSettings& other) const;
+    };
+
+    enum
+    {
+        MAX_STACK_PREFAULT = 4 * 1024 * 1024
+    };
+
 public:
     static int nextId();
 
 public:
-    ThreadGroup(TimedQueuePtr timed_queue, ExceptionHandler& handler, int id, std::string name);
-    ThreadGroup(TimedQueuePtr timed_queue, ExceptionHandler& handler, std::string name);
+    ThreadGroup(ExceptionHandler& handler, int id, std::string name);
+    ThreadGroup(ExceptionHandler& handler, std::string name);
     ~ThreadGroup() override;
 
     int id() const override;
@@ -51,11 +101,46 @@ public:
 
     CpuAffinityPtr getCpuAffinity() const;
 
+    /**
+     * @brief getRealtimeSettings returns the scheduling policy and memory settings of the workers
+     */
+    RealtimeSettings getRealtimeSettings() const;
+
+    /**
+     * @brief setRealtimeSettings changes the scheduling policy and memory settings of the workers.
+     * Policy and memory lock are applied to running workers, stack prefaulting takes effect when the workers are started.
+     */
+    void setRealtimeSettings(const RealtimeSettings& settings);
+
     const std::thread& thread() const;
 
+    std::size_t getWorkerCount() const;
+    void setWorkerCount(std::size_t workers);
+
     std::size_t size() const;
     bool isEmpty() const override;
 
+    QueueType getQueueType() const override;
+    void setQueueType(QueueType type) override;
+
+    SchedulingPolicy getSchedulingPolicy() const override;
+    void setSchedulingPolicy(SchedulingPolicy policy) override;
+
+    /**
+     * @brief getDeadlineMissCount returns the number of tasks that finished after their deadline
+     */
+    std::size_t getDeadlineMissCount() const;
+
+    /**
+     * @brief getWakeupCount returns how often a sleeping worker has been woken up
+     */
+    std::size_t getWakeupCount() const;
+
+    /**
+     * @brief takeLoadStatistics returns the load since the last call and starts a new sampling period
+     */
+    LoadStatistics takeLoadStatistics();
+
     void setPause(bool pause) override;
     void setSteppingMode(bool stepping) override;
 
@@ -77,6 +162,9 @@ public:
 
     void schedule(TaskPtr schedulable) override;
     void scheduleDelayed(TaskPtr schedulable, std::chrono::system_clock::time_point time) override;
+    void scheduleDelayed(TaskPtr schedulable, std::chrono::steady_clock::time_point time);
+
+    bool executeInline(TaskPtr task) override;
 
     std::vector<TaskGeneratorPtr>::iterator begin();
     std::vector<TaskGeneratorPtr>::const_iterator begin() const;
@@ -90,17 +178,56 @@ public:
     slim_signal::Signal<void(TaskGeneratorPtr)> generator_added;
     slim_signal::Signal<void(TaskGeneratorPtr)> generator_removed;
 
+private:
+    /**
+     * @brief The Worker struct represents one OS thread of this group.
+     * Each worker has its own queue, tasks of one generator are always queued at the same worker.
+     * Idle workers steal tasks from the queues of their siblings.
+     */
+    struct Worker
+    {
+        std::size_t index;
+        std::thread thread;
+
+        std::mutex tasks_mtx;
+        std::deque<TaskPtr> tasks;
+
+        bool starved = false;
+        std::size_t starved_epoch = 0;
+    };
+
 private:
     void setup();
-    void schedulingLoop();
+    void schedulingLoop(Worker& worker);
     void updateAffinity();
+    void updateRealtimePolicy();
+    void updateMemoryLock(bool lock);
 
-    bool waitForTasks();
+    void startWorkers();
+    void stopWorkers();
+    void resizeWorkers(std::size_t workers);
+
+    Worker& getWorkerFor(TaskGenerator* generator);
+
+    bool isBefore(const TaskPtr& a, const TaskPtr& b) const;
+    void enqueue(const TaskPtr& task);
+    void drainInbox();
+    std::size_t fireTimers();
+
+    bool waitForTasks(Worker& worker);
     void handlePause();
-    bool executeNextTask();
+    bool executeNextTask(Worker& worker);
+
+    TaskPtr takeTask(Worker& worker);
+    TaskPtr stealTask(Worker& thief);
+    TaskPtr takeFirstExecutableTask(Worker& worker);
+    void finishTask(const TaskPtr& task);
 
     void executeTask(const TaskPtr& task);
 
+    void lockExecution();
+    void unlockExecution();
+
     void checkIfStepIsDone();
 
 private:
@@ -115,9 +242,13 @@ private:
 
     CpuAffinityPtr cpu_affinity_;
 
-    TimedQueuePtr timed_queue_;
+    mutable std::recursive_mutex realtime_mtx_;
+    RealtimeSettings realtime_;
+    bool memory_locked_;
 
-    std::thread scheduler_thread_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::map<TaskGenerator*, std::size_t> worker_assignment_;
+    std::size_t next_worker_;
 
     std::vector<TaskGeneratorPtr> generators_;
     std::map<TaskGenerator*, std::vector<slim_signal::ScopedConnection>> generator_connections_;
@@ -126,22 +257,35 @@ private:
     std::condition_variable_any pause_changed_;
 
     std::recursive_mutex tasks_mtx_;
-    struct greater
-    {
-        bool operator()(const TaskPtr& a, const TaskPtr& b) const
-        {
-            return a->getPriority() > b->getPriority();
-        }
-    };
+    std::size_t work_epoch_;
+
+    std::atomic<QueueType> queue_type_;
+    std::atomic<SchedulingPolicy> policy_;
+    std::atomic<std::size_t> deadline_misses_;
+    std::atomic<std::size_t> wakeups_;
+
+    std::mutex load_mtx_;
+    LoadStatistics load_;
+    std::chrono::steady_clock::time_point load_period_start_;
+    std::mutex inbox_mtx_;
+    TaskRingUniquePtr inbox_;
+    std::atomic<std::size_t> sleeping_workers_;
+
+    TimerWheelUniquePtr timers_;
 
-    std::multiset<TaskPtr, greater> tasks_;
+    std::mutex active_generators_mtx_;
+    std::set<TaskGenerator*> active_generators_;
 
     std::recursive_mutex state_mtx_;
     std::atomic<bool> running_;
     std::atomic<bool> pause_;
     std::atomic<bool> stepping_;
 
-    mutable std::recursive_mutex execution_mtx_;
+    std::mutex execution_mtx_;
+    std::condition_variable execution_changed_;
+    std::size_t executing_tasks_;
+    std::thread::id execution_owner_;
+    std::size_t execution_lock_depth_;
 };
 
 }  // namespace csapex
@@ -0,0 +1,47 @@
+#ifndef THREAD_PLACEMENT_H
+#define THREAD_PLACEMENT_H
+
+/// PROJECT
+#include <csapex/utility/cpu_topology.h>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief The ThreadPlacement class computes CPU affinities for thread groups, so that groups working on the same
+ * chain of nodes share a last level cache and NUMA node, and independent chains are spread over the machine.
+ */
+class CSAPEX_CORE_EXPORT ThreadPlacement
+{
+public:
+    struct Group
+    {
+        // the connected component of the nodes in this group, negative if unknown
+        int chain;
+        // the minimum distance of the group's nodes to a source, orders the groups along a chain
+        int depth;
+        // the number of threads of the group
+        std::size_t weight;
+    };
+
+public:
+    explicit ThreadPlacement(const CpuTopology& topology);
+
+    const CpuTopology& getTopology() const;
+
+    /**
+     * @brief place computes an affinity for each group, groups of unknown chains may run on all CPUs
+     * @param num_cpus the size of the resulting affinity vectors
+     */
+    std::vector<std::vector<bool>> place(const std::vector<Group>& groups, std::size_t num_cpus) const;
+
+private:
+    CpuTopology topology_;
+};
+
+}  // namespace csapex
+
+#endif  // THREAD_PLACEMENT_H
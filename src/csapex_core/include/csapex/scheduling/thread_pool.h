@@ -46,6 +46,12 @@ public:
     ThreadGroup* getGroup(int id);
     ThreadGroup* getGroupFor(TaskGenerator* generator);
 
+    /**
+     * @brief isManaged returns true, iff the group of the generator is chosen by this pool.
+     * Generators that were added to a group directly, like the replicas of a node, follow their owner instead.
+     */
+    bool isManaged(TaskGenerator* generator) const;
+
     std::string nextName();
 
     void add(TaskGenerator*) override;
@@ -66,6 +72,24 @@ public:
     void setPrivateThreadGroupCpuAffinity(const std::vector<bool>& affinity);
     std::vector<bool> getPrivateThreadGroupCpuAffinity() const;
 
+    /**
+     * @brief setAutomaticPlacement enables pinning the groups to CPUs based on the machine topology.
+     * Groups processing the same chain of nodes share a cache, independent chains are spread out.
+     * Disabling it restores the affinities the groups had before they were placed.
+     */
+    void setAutomaticPlacement(bool enabled);
+    bool isAutomaticPlacementEnabled() const;
+
+    /**
+     * @brief setPlacementChains tells the pool which chain and depth each generator belongs to
+     */
+    void setPlacementChains(const std::map<TaskGenerator*, std::pair<int, int>>& chains);
+
+    /**
+     * @brief getRebalancer returns the component that adapts the group assignments to the measured load
+     */
+    ThreadRebalancer* getRebalancer() const;
+
     void setSuppressExceptions(bool suppress_exceptions) override;
 
     void useProfiler(std::shared_ptr<Profiler> profiler) override;
@@ -73,6 +97,7 @@ public:
 public:
     slim_signal::Signal<void(ThreadGroupPtr)> group_created;
     slim_signal::Signal<void(ThreadGroupPtr)> group_removed;
+    slim_signal::Signal<void(bool)> automatic_placement_changed;
 
 private:
     slim_signal::Signal<void()> private_group_cpu_affinity_changed;
@@ -95,10 +120,12 @@ private:
     //    void clearGroup(ThreadGroup *group);
     void removeGroup(ThreadGroup* group);
 
+    void updatePlacement();
+    void restoreManualAffinities();
+
 private:
     ExceptionHandler& handler_;
 
-    TimedQueuePtr timed_queue_;
 
     bool enable_threading_;
     bool grouping_;
@@ -112,6 +139,14 @@ private:
     CpuAffinityPtr private_group_cpu_affinity_;
     std::map<ThreadGroup*, std::vector<slim_signal::ScopedConnection>> private_group_connections_;
 
+    bool automatic_placement_;
+    bool placing_;
+    ThreadPlacementUniquePtr placement_;
+    std::map<TaskGenerator*, std::pair<int, int>> placement_chains_;
+    std::map<const ThreadGroup*, std::vector<bool>> manual_affinities_;
+
+    ThreadRebalancerUniquePtr rebalancer_;
+
     bool suppress_exceptions_;
 };
 
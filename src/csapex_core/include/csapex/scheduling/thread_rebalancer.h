@@ -0,0 +1,110 @@
+#ifndef THREAD_REBALANCER_H
+#define THREAD_REBALANCER_H
+
+/// PROJECT
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/utility/slim_signal.hpp>
+#include <csapex/utility/yaml.h>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <chrono>
+#include <set>
+
+namespace csapex
+{
+/**
+ * @brief The ThreadRebalancer class periodically samples the load of all thread groups of a pool.
+ * It moves the most expensive generator of an overloaded group into a group of its own and merges
+ * groups that it created itself back together once they are idle.
+ * Each call to rebalance changes at most one assignment, so that the effect can be measured before the next step.
+ */
+class CSAPEX_CORE_EXPORT ThreadRebalancer
+{
+public:
+    explicit ThreadRebalancer(ThreadPool& pool);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    void setInterval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds getInterval() const;
+
+    /**
+     * @brief setMaximumGroupCount limits the number of groups, not counting private threads
+     */
+    void setMaximumGroupCount(std::size_t count);
+    std::size_t getMaximumGroupCount() const;
+
+    /**
+     * @brief setUtilizationLimits sets the fraction of time the workers of a group may be busy.
+     * Groups above high are split, groups below low are merged.
+     */
+    void setUtilizationLimits(double low, double high);
+    double getLowUtilization() const;
+    double getHighUtilization() const;
+
+    /**
+     * @brief setMaximumQueueWait sets how long tasks may wait on average before a group counts as overloaded
+     */
+    void setMaximumQueueWait(std::chrono::milliseconds wait);
+    std::chrono::milliseconds getMaximumQueueWait() const;
+
+    /**
+     * @brief tick rebalances, if it is enabled and the interval has passed since the last time
+     */
+    void tick();
+
+    /**
+     * @brief rebalance samples the load of all groups since the last call and applies at most one change
+     * @return true, iff the group assignments changed
+     */
+    bool rebalance();
+
+    /**
+     * @brief getLayout returns the thread settings as saved after the last change
+     */
+    const YAML::Node& getLayout() const;
+
+    void saveSettings(YAML::Node& node) const;
+    void loadSettings(const YAML::Node& node);
+
+public:
+    slim_signal::Signal<void(bool)> enabled_changed;
+    slim_signal::Signal<void()> rebalanced;
+
+private:
+    struct Sample
+    {
+        ThreadGroup* group;
+        ThreadGroup::LoadStatistics load;
+        double utilization;
+        bool automatic;
+    };
+
+    bool split(std::vector<Sample>& samples);
+    bool merge(std::vector<Sample>& samples);
+
+    double getUtilization(const Sample& sample, std::chrono::steady_clock::duration busy) const;
+
+private:
+    ThreadPool& pool_;
+
+    bool enabled_;
+    std::chrono::milliseconds interval_;
+    std::size_t max_groups_;
+    double low_utilization_;
+    double high_utilization_;
+    std::chrono::milliseconds max_queue_wait_;
+
+    std::chrono::steady_clock::time_point last_rebalance_;
+
+    // only groups created here are merged again, they are persisted so that this also works after loading
+    std::set<int> created_groups_;
+
+    YAML::Node layout_;
+};
+
+}  // namespace csapex
+
+#endif  // THREAD_REBALANCER_H
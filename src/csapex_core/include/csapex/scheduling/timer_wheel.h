@@ -0,0 +1,127 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+/// PROJECT
+#include <csapex/scheduling/scheduling_fwd.h>
+#include <csapex_core/csapex_core_export.h>
+
+/// SYSTEM
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief The TimerWheel class manages delayed tasks in a hierarchical timing wheel on the steady clock.
+ * Adding and cancelling a timer is O(1), expired tasks are collected by calling advance.
+ * Timers never expire early, but can be up to one tick late.
+ */
+class CSAPEX_CORE_EXPORT TimerWheel
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    enum
+    {
+        LEVELS = 4,
+        SLOT_BITS = 6,
+        SLOTS = 1 << SLOT_BITS
+    };
+
+private:
+    struct Timer;
+    typedef std::shared_ptr<Timer> TimerPtr;
+    typedef std::list<TimerPtr> Slot;
+
+    struct Timer
+    {
+        TaskPtr task;
+        std::uint64_t expiry;
+
+        std::size_t level = 0;
+        Slot* slot = nullptr;
+        Slot::iterator pos;
+    };
+
+public:
+    /**
+     * @brief The Handle class identifies a pending timer, it can be used to cancel it
+     */
+    class Handle
+    {
+    public:
+        Handle() = default;
+
+    private:
+        friend class TimerWheel;
+        explicit Handle(const TimerPtr& timer) : timer_(timer)
+        {
+        }
+
+        std::weak_ptr<Timer> timer_;
+    };
+
+public:
+    explicit TimerWheel(clock::duration tick = std::chrono::milliseconds(1));
+    ~TimerWheel();
+
+    Handle add(const TaskPtr& task, clock::time_point time);
+
+    /**
+     * @brief cancel removes a pending timer
+     * @return false, iff the timer has already expired or was cancelled before
+     */
+    bool cancel(const Handle& handle);
+
+    /**
+     * @brief remove cancels all timers of tasks belonging to the given generator
+     * @return the tasks of the cancelled timers
+     */
+    std::vector<TaskPtr> remove(TaskGenerator* generator);
+    void clear();
+
+    /**
+     * @brief advance moves the wheel forward to the given time
+     * @return all tasks whose timers have expired
+     */
+    std::vector<TaskPtr> advance(clock::time_point now = clock::now());
+
+    /**
+     * @brief nextExpiry returns a time at which advance has to be called next, or time_point::max if no timer is pending.
+     * This is the earlier of the next expiry on the lowest wheel and the next cascade of the lowest occupied upper wheel.
+     */
+    clock::time_point nextExpiry() const;
+
+    std::size_t size() const;
+    bool empty() const;
+
+private:
+    std::uint64_t toTicksCeil(clock::time_point time) const;
+    std::uint64_t toTicksFloor(clock::time_point time) const;
+    clock::time_point toTime(std::uint64_t ticks) const;
+
+    void insert(const TimerPtr& timer);
+    void unlink(Timer& timer);
+    void cascade(std::size_t level);
+
+private:
+    const clock::duration tick_;
+    const clock::time_point origin_;
+
+    mutable std::mutex mutex_;
+    std::uint64_t current_tick_;
+    std::array<std::array<Slot, SLOTS>, LEVELS> wheels_;
+    std::array<std::size_t, LEVELS> timers_per_level_;
+
+    std::atomic<std::size_t> size_;
+};
+
+}  // namespace csapex
+
+#endif  // TIMER_WHEEL_H
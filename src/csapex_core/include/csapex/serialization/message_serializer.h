@@ -14,6 +14,7 @@
 
 /// SYSTEM
 #include <functional>
+#include <unordered_map>
 
 HAS_MEM_FUNC(encode, has_yaml_implementation);
 
@@ -142,7 +143,7 @@ private:
     static void registerMessage(std::string type, YamlConverter converter);
 
 private:
-    std::map<std::string, YamlConverter> type_to_yaml_converter;
+    std::unordered_map<SymbolTable::Id, YamlConverter> type_to_yaml_converter;
 };
 
 template <typename T>
@@ -34,6 +34,9 @@
 #include <csapex/signal/slot.h>
 #include <csapex/utility/assert.h>
 
+/// SYSTEM
+#include <set>
+
 using namespace csapex;
 using namespace csapex::command;
 
@@ -135,6 +138,11 @@ Command::Ptr CommandFactory::setConnectionActive(int connection, bool active)
     return Command::Ptr(new ModifyConnection(graph_uuid, connection, active));
 }
 
+Command::Ptr CommandFactory::setConnectionBuffer(int connection, int buffer_size, OverflowPolicy overflow_policy)
+{
+    return Command::Ptr(new ModifyConnection(graph_uuid, connection, buffer_size, overflow_policy));
+}
+
 Command::Ptr CommandFactory::clearCommand()
 {
     return std::make_shared<ClearGraph>(graph_uuid);
@@ -343,9 +351,12 @@ CommandPtr CommandFactory::deleteThreadGroup(ThreadGroup* group)
 {
     command::Meta::Ptr cmd(new command::Meta(graph_uuid, "delete thread group"));
 
-    // first move all generators to the default thread
+    // first move all generators to the default thread, the replicas of a node share its UUID and follow it
+    std::set<UUID> moved;
     for (const TaskGeneratorPtr& generator : *group) {
-        cmd->add(std::make_shared<command::SwitchThread>(graph_uuid, generator->getUUID(), ThreadGroup::DEFAULT_GROUP_ID));
+        if (moved.insert(generator->getUUID()).second) {
+            cmd->add(std::make_shared<command::SwitchThread>(graph_uuid, generator->getUUID(), ThreadGroup::DEFAULT_GROUP_ID));
+        }
     }
 
     // then delete the group itself
@@ -0,0 +1,75 @@
+/// HEADER
+#include <csapex/command/freeze_graph.h>
+
+/// COMPONENT
+#include <csapex/command/command.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/command/command_serializer.h>
+#include <csapex/serialization/io/std_io.h>
+#include <csapex/serialization/io/csapex_io.h>
+
+/// SYSTEM
+#include <sstream>
+
+using namespace csapex;
+using namespace csapex::command;
+
+CSAPEX_REGISTER_COMMAND_SERIALIZER(FreezeGraph)
+
+FreezeGraph::FreezeGraph(const AUUID& parent_uuid, bool frozen) : CommandImplementation(parent_uuid), frozen_(frozen), was_frozen_(false)
+{
+}
+
+std::string FreezeGraph::getDescription() const
+{
+    std::stringstream ss;
+    ss << (frozen_ ? "freeze" : "thaw") << " graph " << graph_uuid;
+    return ss.str();
+}
+
+bool FreezeGraph::doExecute()
+{
+    GraphImplementationPtr graph = getGraph();
+    was_frozen_ = graph->isFrozen();
+
+    if (frozen_) {
+        graph->freeze();
+    } else {
+        graph->thaw();
+    }
+
+    return true;
+}
+
+bool FreezeGraph::doUndo()
+{
+    GraphImplementationPtr graph = getGraph();
+    if (was_frozen_) {
+        graph->freeze();
+    } else {
+        graph->thaw();
+    }
+
+    return true;
+}
+
+bool FreezeGraph::doRedo()
+{
+    return doExecute();
+}
+
+void FreezeGraph::serialize(SerializationBuffer& data, SemanticVersion& version) const
+{
+    Command::serialize(data, version);
+
+    data << frozen_;
+    data << was_frozen_;
+}
+
+void FreezeGraph::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
+{
+    Command::deserialize(data, version);
+
+    data >> frozen_;
+    data >> was_frozen_;
+}
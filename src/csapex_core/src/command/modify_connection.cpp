@@ -17,28 +17,65 @@ using namespace csapex::command;
 
 CSAPEX_REGISTER_COMMAND_SERIALIZER(ModifyConnection)
 
-ModifyConnection::ModifyConnection(const AUUID& parent_uuid, int connection_id, bool active) : CommandImplementation(parent_uuid), connection_id(connection_id), active(active)
+ModifyConnection::ModifyConnection(const AUUID& parent_uuid, int connection_id, bool active)
+  : CommandImplementation(parent_uuid)
+  , connection_id(connection_id)
+  , modify_buffer(false)
+  , was_active(false)
+  , active(active)
+  , was_buffer_size(1)
+  , buffer_size(1)
+  , was_overflow_policy(OverflowPolicy::BLOCK)
+  , overflow_policy(OverflowPolicy::BLOCK)
+{
+}
+
+ModifyConnection::ModifyConnection(const AUUID& parent_uuid, int connection_id, int buffer_size, OverflowPolicy overflow_policy)
+  : CommandImplementation(parent_uuid)
+  , connection_id(connection_id)
+  , modify_buffer(true)
+  , was_active(false)
+  , active(false)
+  , was_buffer_size(1)
+  , buffer_size(buffer_size)
+  , was_overflow_policy(OverflowPolicy::BLOCK)
+  , overflow_policy(overflow_policy)
 {
 }
 
 std::string ModifyConnection::getDescription() const
 {
     std::stringstream ss;
-    ss << "modified connection " << connection_id << " -> set active: " << active << " (was " << was_active << ")";
+    if (modify_buffer) {
+        ss << "modified connection " << connection_id << " -> set buffer size: " << buffer_size << " (was " << was_buffer_size << ")";
+    } else {
+        ss << "modified connection " << connection_id << " -> set active: " << active << " (was " << was_active << ")";
+    }
     return ss.str();
 }
 
 bool ModifyConnection::doExecute()
 {
     auto c = getGraph()->getConnectionWithId(connection_id);
-    was_active = c->isActive();
-    c->setActive(active);
+    if (modify_buffer) {
+        was_buffer_size = c->getBufferCapacity();
+        was_overflow_policy = c->getOverflowPolicy();
+        c->setBuffer(buffer_size, overflow_policy);
+    } else {
+        was_active = c->isActive();
+        c->setActive(active);
+    }
     return true;
 }
 
 bool ModifyConnection::doUndo()
 {
-    getGraph()->getConnectionWithId(connection_id)->setActive(was_active);
+    auto c = getGraph()->getConnectionWithId(connection_id);
+    if (modify_buffer) {
+        c->setBuffer(was_buffer_size, was_overflow_policy);
+    } else {
+        c->setActive(was_active);
+    }
     return true;
 }
 
@@ -54,6 +91,12 @@ void ModifyConnection::serialize(SerializationBuffer& data, SemanticVersion& ver
     data << connection_id;
     data << active;
     data << was_active;
+
+    data << modify_buffer;
+    data << buffer_size;
+    data << was_buffer_size;
+    data << overflow_policy;
+    data << was_overflow_policy;
 }
 
 void ModifyConnection::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
@@ -63,4 +106,10 @@ void ModifyConnection::deserialize(const SerializationBuffer& data, const Semant
     data >> connection_id;
     data >> active;
     data >> was_active;
+
+    data >> modify_buffer;
+    data >> buffer_size;
+    data >> was_buffer_size;
+    data >> overflow_policy;
+    data >> was_overflow_policy;
 }
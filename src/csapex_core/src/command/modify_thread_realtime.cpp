@@ -0,0 +1,103 @@
+/// HEADER
+#include <csapex/command/modify_thread_realtime.h>
+
+/// COMPONENT
+#include <csapex/command/command.h>
+#include <csapex/scheduling/thread_pool.h>
+#include <csapex/command/command_serializer.h>
+#include <csapex/serialization/io/std_io.h>
+
+/// SYSTEM
+#include <sstream>
+
+/// COMPONENT
+#include <csapex/utility/assert.h>
+
+using namespace csapex;
+using namespace csapex::command;
+
+CSAPEX_REGISTER_COMMAND_SERIALIZER(ModifyThreadRealtime)
+
+ModifyThreadRealtime::ModifyThreadRealtime(int thread_id, const ThreadGroup::RealtimeSettings& settings) : id(thread_id), settings(settings)
+{
+}
+
+std::string ModifyThreadRealtime::getDescription() const
+{
+    std::stringstream ss;
+    ss << "Modify real-time settings of thread " << id << " (";
+    switch (settings.policy) {
+        case ThreadGroup::RealtimePolicy::FIFO:
+            ss << "fifo " << settings.priority;
+            break;
+        case ThreadGroup::RealtimePolicy::ROUND_ROBIN:
+            ss << "round robin " << settings.priority;
+            break;
+        default:
+            ss << "none";
+            break;
+    }
+    if (settings.lock_memory) {
+        ss << ", locked memory";
+    }
+    if (settings.stack_prefault > 0) {
+        ss << ", prefault " << settings.stack_prefault << " bytes";
+    }
+    ss << ")";
+    return ss.str();
+}
+
+bool ModifyThreadRealtime::doExecute()
+{
+    if (id == ThreadGroup::PRIVATE_THREAD) {
+        throw std::runtime_error("cannot modify private groups");
+    }
+
+    ThreadGroup* group = getRootThreadPool()->getGroup(id);
+    apex_assert_hard(group);
+
+    old_settings = group->getRealtimeSettings();
+    group->setRealtimeSettings(settings);
+
+    return true;
+}
+
+bool ModifyThreadRealtime::doUndo()
+{
+    ThreadGroup* group = getRootThreadPool()->getGroup(id);
+    apex_assert_hard(group);
+
+    group->setRealtimeSettings(old_settings);
+
+    return true;
+}
+
+bool ModifyThreadRealtime::doRedo()
+{
+    return doExecute();
+}
+
+void ModifyThreadRealtime::serialize(SerializationBuffer& data, SemanticVersion& version) const
+{
+    Command::serialize(data, version);
+
+    data << id;
+    data << settings.policy;
+    data << settings.priority;
+    data << settings.lock_memory;
+    data << static_cast<uint64_t>(settings.stack_prefault);
+}
+
+void ModifyThreadRealtime::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
+{
+    Command::deserialize(data, version);
+
+    data >> id;
+    data >> settings.policy;
+    data >> settings.priority;
+    data >> settings.lock_memory;
+
+    uint64_t stack_prefault;
+    data >> stack_prefault;
+    settings.stack_prefault = stack_prefault;
+}
@@ -21,7 +21,8 @@ using namespace csapex::command;
 
 CSAPEX_REGISTER_COMMAND_SERIALIZER(SetMaximumExecutionFrequency)
 
-SetMaximumExecutionFrequency::SetMaximumExecutionFrequency(const AUUID& parent_uuid, const UUID& node, double frequency) : CommandImplementation(parent_uuid), uuid(node), frequency(frequency)
+SetMaximumExecutionFrequency::SetMaximumExecutionFrequency(const AUUID& parent_uuid, const UUID& node, double frequency, double deadline)
+  : CommandImplementation(parent_uuid), uuid(node), frequency(frequency), deadline(deadline)
 {
 }
 
@@ -29,6 +30,9 @@ std::string SetMaximumExecutionFrequency::getDescription() const
 {
     std::stringstream ss;
     ss << "set the frequency of " << uuid << " to " << frequency;
+    if (deadline >= 0.0) {
+        ss << " and the deadline to " << deadline << "s";
+    }
     return ss.str();
 }
 
@@ -39,8 +43,12 @@ bool SetMaximumExecutionFrequency::doExecute()
 
     NodeStatePtr state = node_handle->getNodeState();
     was_frequency = state->getMaximumFrequency();
+    was_deadline = state->getDeadline();
 
     state->setMaximumFrequency(frequency);
+    if (deadline >= 0.0) {
+        state->setDeadline(deadline);
+    }
 
     return true;
 }
@@ -53,6 +61,7 @@ bool SetMaximumExecutionFrequency::doUndo()
     NodeStatePtr state = node_handle->getNodeState();
 
     state->setMaximumFrequency(was_frequency);
+    state->setDeadline(was_deadline);
 
     return true;
 }
@@ -68,6 +77,7 @@ void SetMaximumExecutionFrequency::serialize(SerializationBuffer& data, Semantic
 
     data << uuid;
     data << frequency;
+    data << deadline;
 }
 
 void SetMaximumExecutionFrequency::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
@@ -76,4 +86,5 @@ void SetMaximumExecutionFrequency::deserialize(const SerializationBuffer& data,
 
     data >> uuid;
     data >> frequency;
+    data >> deadline;
 }
@@ -22,6 +22,7 @@
 #include <csapex/plugin/plugin_manager.hpp>
 #include <csapex/profiling/profiler_impl.h>
 #include <csapex/scheduling/thread_pool.h>
+#include <csapex/scheduling/thread_rebalancer.h>
 #include <csapex/serialization/snippet.h>
 #include <csapex/utility/assert.h>
 #include <csapex/utility/error_handling.h>
@@ -63,6 +64,9 @@ CsApexCore::CsApexCore(Settings& settings, ExceptionHandler& handler, csapex::Pl
     observe(thread_pool_->begin_step, begin_step);
     observe(thread_pool_->end_step, end_step);
 
+    // the new layout is saved with the graph
+    observe(thread_pool_->getRebalancer()->rebalanced, [this]() { dispatcher_->setDirty(); });
+
     observe(saved, [this]() {
         dispatcher_->setClean();
         dispatcher_->resetDirtyPoint();
@@ -341,6 +345,8 @@ void CsApexCore::startMainLoop()
         while (running_) {
             getCommandDispatcher()->executeLater();
 
+            thread_pool_->getRebalancer()->tick();
+
             running_changed_.wait_for(lock, std::chrono::milliseconds(10));
         }
 
@@ -575,6 +581,11 @@ void CsApexCore::load(const std::string& file)
 
         // finally load thread affinities, _after_ the nodes are loaded
         thread_pool_->loadSettings(node_map);
+
+        if (settings_.getTemporary<bool>("freeze_graph", false)) {
+            // the topology is not going to change, any edit falls back to dynamic execution
+            root_->getLocalGraph()->freeze();
+        }
     }
 
     load_needs_reset_ = true;
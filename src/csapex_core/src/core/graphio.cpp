@@ -31,12 +31,42 @@
 
 /// SYSTEM
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sys/types.h>
 
 using namespace csapex;
 
+namespace
+{
+std::string overflowPolicyToString(OverflowPolicy policy)
+{
+    switch (policy) {
+        case OverflowPolicy::DROP_OLDEST:
+            return "drop_oldest";
+        case OverflowPolicy::DROP_NEWEST:
+            return "drop_newest";
+        case OverflowPolicy::KEEP_LATEST:
+            return "keep_latest";
+        default:
+            return "block";
+    }
+}
+
+OverflowPolicy overflowPolicyFromString(const std::string& policy)
+{
+    if (policy == "drop_oldest") {
+        return OverflowPolicy::DROP_OLDEST;
+    } else if (policy == "drop_newest") {
+        return OverflowPolicy::DROP_NEWEST;
+    } else if (policy == "keep_latest") {
+        return OverflowPolicy::KEEP_LATEST;
+    }
+    return OverflowPolicy::BLOCK;
+}
+}  // namespace
+
 #define sendNotificationStreamGraphio(args)                                                                                                                                                            \
     {                                                                                                                                                                                                  \
         std::stringstream ss;                                                                                                                                                                          \
@@ -321,7 +351,7 @@ void GraphIO::saveConnections(YAML::Node& yaml)
 
 void GraphIO::saveConnections(YAML::Node& yaml, const std::vector<ConnectionDescription>& connections)
 {
-    std::unordered_map<UUID, std::vector<std::pair<UUID, std::string>>, UUID::Hasher> connection_map;
+    std::unordered_map<UUID, std::vector<const ConnectionDescription*>, UUID::Hasher> connection_map;
 
     for (const ConnectionDescription& connection : connections) {
         if (ignore_forwarding_connections_) {
@@ -330,9 +360,7 @@ void GraphIO::saveConnections(YAML::Node& yaml, const std::vector<ConnectionDesc
             }
         }
 
-        std::string type = connection.active ? "active" : "default";
-
-        connection_map[connection.from].push_back(std::make_pair(connection.to, type));
+        connection_map[connection.from].push_back(&connection);
 
         if (!connection.fulcrums.empty()) {
             YAML::Node fulcrum;
@@ -345,9 +373,21 @@ void GraphIO::saveConnections(YAML::Node& yaml, const std::vector<ConnectionDesc
     for (const auto& pair : connection_map) {
         YAML::Node entry(YAML::NodeType::Map);
         entry["uuid"] = pair.first.getFullName();
-        for (const auto& info : pair.second) {
-            entry["targets"].push_back(info.first.getFullName());
-            entry["types"].push_back(info.second);
+
+        bool buffered = std::any_of(pair.second.begin(), pair.second.end(),
+                                    [](const ConnectionDescription* c) { return c->buffer_size > 1 || c->overflow_policy == OverflowPolicy::KEEP_LATEST; });
+
+        for (const ConnectionDescription* connection : pair.second) {
+            entry["targets"].push_back(connection->to.getFullName());
+            entry["types"].push_back(connection->active ? "active" : "default");
+
+            // buffers are only written if needed to keep the files compatible
+            if (buffered) {
+                YAML::Node buffer(YAML::NodeType::Map);
+                buffer["size"] = connection->buffer_size;
+                buffer["policy"] = overflowPolicyToString(connection->overflow_policy);
+                entry["buffers"].push_back(buffer);
+            }
         }
         yaml["connections"].push_back(entry);
     }
@@ -398,6 +438,9 @@ void GraphIO::loadConnection(const YAML::Node& connection, SemanticVersion versi
     const YAML::Node& types = connection["types"];
     apex_assert_hard(!types.IsDefined() || (types.Type() == YAML::NodeType::Sequence && targets.size() == types.size()));
 
+    const YAML::Node& buffers = connection["buffers"];
+    apex_assert_hard(!buffers.IsDefined() || (buffers.Type() == YAML::NodeType::Sequence && targets.size() == buffers.size()));
+
     for (unsigned j = 0; j < targets.size(); ++j) {
         UUID to_uuid = readConnectorUUID(graph_.getLocalGraph()->shared_from_this(), targets[j]);
 
@@ -408,9 +451,21 @@ void GraphIO::loadConnection(const YAML::Node& connection, SemanticVersion versi
             connection_type = types[j].as<std::string>();
         }
 
+        int buffer_size = 1;
+        OverflowPolicy overflow_policy = OverflowPolicy::BLOCK;
+        if (buffers.IsDefined()) {
+            const YAML::Node& buffer = buffers[j];
+            if (buffer["size"].IsDefined()) {
+                buffer_size = buffer["size"].as<int>();
+            }
+            if (buffer["policy"].IsDefined()) {
+                overflow_policy = overflowPolicyFromString(buffer["policy"].as<std::string>());
+            }
+        }
+
         ConnectorPtr from = graph_.findConnectorNoThrow(from_uuid);
         if (from) {
-            loadConnection(from, to_uuid, connection_type, version);
+            loadConnection(from, to_uuid, connection_type, buffer_size, overflow_policy, version);
         } else {
             sendNotificationStreamGraphio("cannot load connection from '" << from_uuid << "' to '" << to_uuid << "', '" << from_uuid << "' doesn't exist.");
         }
@@ -503,7 +558,7 @@ void GraphIO::loadFulcrum(const YAML::Node& fulcrum, SemanticVersion version)
     }
 }
 
-void GraphIO::loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::string& connection_type, SemanticVersion version)
+void GraphIO::loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::string& connection_type, int buffer_size, OverflowPolicy overflow_policy, SemanticVersion version)
 {
     try {
         NodeHandle* target = graph_.getLocalGraph()->findNodeHandleForConnector(to_uuid);
@@ -522,6 +577,9 @@ void GraphIO::loadConnection(ConnectorPtr from, const UUID& to_uuid, const std::
             if (connection_type == "active") {
                 c->setActive(true);
             }
+            if (buffer_size > 1 || overflow_policy == OverflowPolicy::KEEP_LATEST) {
+                c->setBuffer(buffer_size, overflow_policy);
+            }
             graph_.getLocalGraph()->addConnection(c);
         }
 
@@ -126,6 +126,7 @@ void Connectable::disable()
 {
     if (enabled_) {
         enabled_ = false;
+        updateConnectionsEnabled();
         enabled_changed((bool)enabled_);
     }
 }
@@ -134,6 +135,7 @@ void Connectable::enable()
 {
     if (!enabled_) {
         enabled_ = true;
+        updateConnectionsEnabled();
         enabled_changed((bool)enabled_);
     }
 }
@@ -147,6 +149,14 @@ void Connectable::setEnabled(bool enabled)
     }
 }
 
+void Connectable::updateConnectionsEnabled()
+{
+    // the transitions have to know about the change before anyone is notified
+    for (const ConnectionPtr& c : connections_) {
+        c->updateEnabled();
+    }
+}
+
 bool Connectable::isEnabled() const
 {
     return enabled_;
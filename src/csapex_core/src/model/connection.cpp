@@ -10,13 +10,13 @@
 #include <csapex/signal/event.h>
 #include <csapex/core/settings.h>
 #include <csapex/model/fulcrum.h>
+#include <csapex/model/connection_state_counter.h>
 #include <csapex/utility/assert.h>
 #include <csapex/msg/no_message.h>
 #include <csapex/utility/debug.h>
-#include <csapex/model/node_handle.h>
-#include <csapex/model/node_state.h>
 
 /// SYSTEM
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -28,7 +28,21 @@ Connection::Connection(OutputPtr from, InputPtr to) : Connection(from, to, next_
 {
 }
 
-Connection::Connection(OutputPtr from, InputPtr to, int id) : from_(from), to_(to), id_(id), active_(false), detached_(false), state_(State::NOT_INITIALIZED)
+Connection::Connection(OutputPtr from, InputPtr to, int id)
+  : from_(from)
+  , to_(to)
+  , id_(id)
+  , active_(false)
+  , detached_(false)
+  , state_(State::NOT_INITIALIZED)
+  , source_state_(State::NOT_INITIALIZED)
+  , sink_counter_(nullptr)
+  , source_counter_(nullptr)
+  , counted_(false)
+  , buffer_capacity_(1)
+  , overflow_policy_(OverflowPolicy::BLOCK)
+  , dropped_tokens_(0)
+  , pipelining_(false)
 {
     from->enabled_changed.connect(source_enable_changed);
     to->enabled_changed.connect(sink_enabled_changed);
@@ -115,8 +129,10 @@ bool Connection::isDetached() const
 void Connection::reset()
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
-    state_ = Connection::State::NOT_INITIALIZED;
+    changeState(Connection::State::NOT_INITIALIZED);
     message_.reset();
+    buffer_.clear();
+    updateSourceState();
 }
 
 TokenPtr Connection::getToken() const
@@ -145,36 +161,94 @@ bool Connection::holdsActiveToken() const
 
 void Connection::setTokenProcessed()
 {
+    bool has_next = false;
+    bool producer_released = false;
     {
         std::unique_lock<std::recursive_mutex> lock(sync);
         if (getState() == State::DONE) {
             // std::cerr << *this << " is already done!" << std::endl;
             return;
         }
-        setState(State::DONE);
+        apex_assert_hard(state_ == State::READ);
+
+        State previous_source_state = source_state_;
+
+        // the next token is passed on in the same step, so that nobody observes the connection as done in between
+        if (!buffer_.empty()) {
+            message_ = buffer_.front();
+            buffer_.pop_front();
+            changeState(State::UNREAD);
+            has_next = true;
+        } else {
+            changeState(State::DONE);
+        }
+        updateSourceState();
+
+        // a buffered connection has released the producer long ago, notifying it again could end its next round prematurely
+        producer_released = previous_source_state != State::DONE && source_state_ == State::DONE;
     }
 
     // std::cerr << *this << " is done" << std::endl;
-    notifyMessageProcessed();
+    if (producer_released) {
+        notifyMessageProcessed();
+    }
+
+    if (has_next && !detached_) {
+        to_->notifyMessageAvailable(this);
+    }
 }
 
 void Connection::setToken(const TokenPtr& token, const bool silent)
 {
+    bool dropped = false;
     {
+        // only the per-edge state is copied, the payload is shared by all connections of the output
         TokenPtr msg = token->cloneAs<Token>();
 
         std::unique_lock<std::recursive_mutex> lock(sync);
         apex_assert_hard(msg != nullptr);
-        apex_assert_hard(state_ == State::NOT_INITIALIZED);
 
         if (!isActive() && msg->hasActivityModifier()) {
             // remove active flag if the connection is inactive
             msg->setActivityModifier(ActivityModifier::NONE);
         }
 
-        message_ = msg;
         ++seq_;
-        setState(State::UNREAD);
+
+        if (state_ == State::NOT_INITIALIZED) {
+            message_ = msg;
+            setState(State::UNREAD);
+
+        } else if (state_ == State::UNREAD && getEffectiveOverflowPolicy() == OverflowPolicy::KEEP_LATEST) {
+            // the consumer has not started with the held token, so it only gets to see the newer one
+            message_ = msg;
+            ++dropped_tokens_;
+            dropped = true;
+
+        } else {
+            // the consumer is still busy with the current token
+            apex_assert_hard(isBuffered());
+
+            if (static_cast<int>(buffer_.size()) + 1 >= getEffectiveCapacity()) {
+                OverflowPolicy policy = getEffectiveOverflowPolicy();
+                apex_assert_hard(policy != OverflowPolicy::BLOCK);
+                ++dropped_tokens_;
+                dropped = true;
+                if (policy == OverflowPolicy::DROP_OLDEST || policy == OverflowPolicy::KEEP_LATEST) {
+                    buffer_.pop_front();
+                } else {
+                    msg.reset();
+                }
+            }
+            if (msg) {
+                buffer_.push_back(msg);
+            }
+        }
+        updateSourceState();
+    }
+
+    if (dropped) {
+        token_dropped();
     }
 
     if(!silent) {
@@ -182,6 +256,84 @@ void Connection::setToken(const TokenPtr& token, const bool silent)
     }
 }
 
+void Connection::setBuffer(int capacity, OverflowPolicy policy)
+{
+    std::size_t dropped = 0;
+    {
+        std::unique_lock<std::recursive_mutex> lock(sync);
+        capacity = std::max(1, capacity);
+        if (capacity == buffer_capacity_ && policy == overflow_policy_) {
+            return;
+        }
+        buffer_capacity_ = capacity;
+        overflow_policy_ = policy;
+
+        // tokens that do not fit anymore are discarded, the current token stays
+        while (static_cast<int>(buffer_.size()) + 1 > getEffectiveCapacity() && !buffer_.empty()) {
+            if (policy == OverflowPolicy::KEEP_LATEST) {
+                buffer_.pop_front();
+            } else {
+                buffer_.pop_back();
+            }
+            ++dropped_tokens_;
+            ++dropped;
+        }
+        updateSourceState();
+    }
+
+    for (std::size_t i = 0; i < dropped; ++i) {
+        token_dropped();
+    }
+
+    connection_changed();
+}
+
+int Connection::getBufferCapacity() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return buffer_capacity_;
+}
+
+OverflowPolicy Connection::getOverflowPolicy() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return overflow_policy_;
+}
+
+bool Connection::isBuffered() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return getEffectiveCapacity() > 1;
+}
+
+int Connection::getEffectiveCapacity() const
+{
+    if (overflow_policy_ == OverflowPolicy::KEEP_LATEST) {
+        // one slot for the token being processed and one for the latest token that arrived meanwhile
+        return 2;
+    }
+    // a pipelining consumer needs one slot for the token it processes and one for the next
+    return std::max(buffer_capacity_, pipelining_ ? 2 : 1);
+}
+
+OverflowPolicy Connection::getEffectiveOverflowPolicy() const
+{
+    // the implicit pipelining slot never drops tokens
+    return buffer_capacity_ > 1 || overflow_policy_ == OverflowPolicy::KEEP_LATEST ? overflow_policy_ : OverflowPolicy::BLOCK;
+}
+
+std::size_t Connection::getBufferedTokenCount() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return buffer_.size();
+}
+
+std::size_t Connection::getDroppedTokenCount() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return dropped_tokens_;
+}
+
 int Connection::getSeq() const
 {
     return seq_;
@@ -193,6 +345,11 @@ void Connection::notifyMessageSet()
         return;
     }
     to_->notifyMessageAvailable(this);
+
+    if (isBuffered() && getSourceState() == State::DONE) {
+        // the token has been buffered, the producer does not have to wait for the consumer
+        notifyMessageProcessed();
+    }
 }
 
 void Connection::notifyMessageProcessed()
@@ -233,20 +390,121 @@ bool Connection::isSinkEnabled() const
     return to()->isEnabled();
 }
 
+void Connection::setPipelining(bool pipelining)
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    // queued tokens are kept, they are passed on as soon as the consumer is done
+    pipelining_ = pipelining;
+    updateSourceState();
+}
+
 bool Connection::isPipelining() const
 {
-    if (NodeHandlePtr node = std::dynamic_pointer_cast<NodeHandle>(to_->getOwner())) {
-        return node->getNodeState()->getExecutionMode() == ExecutionMode::PIPELINING;
-    }
-    return false;
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return pipelining_;
 }
 
 Connection::State Connection::getState() const
 {
-    std::unique_lock<std::recursive_mutex> lock(sync);
     return state_;
 }
 
+Connection::State Connection::getSourceState() const
+{
+    return source_state_;
+}
+
+Connection::State Connection::calculateSourceState() const
+{
+    int capacity = getEffectiveCapacity();
+    if (capacity <= 1 || state_ == State::NOT_INITIALIZED) {
+        return state_;
+    }
+    if (getEffectiveOverflowPolicy() == OverflowPolicy::BLOCK && static_cast<int>(buffer_.size()) + 1 >= capacity) {
+        return State::UNREAD;
+    }
+    return State::DONE;
+}
+
+void Connection::updateSourceState()
+{
+    State s = calculateSourceState();
+    State previous = source_state_.exchange(s);
+    if (counted_ && source_counter_) {
+        source_counter_->move(previous, s);
+    }
+}
+
+void Connection::changeState(State s)
+{
+    State previous = state_.exchange(s);
+    if (counted_ && sink_counter_) {
+        sink_counter_->move(previous, s);
+    }
+}
+
+void Connection::observeSinkState(ConnectionStateCounter* counter)
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    observeState(sink_counter_, counter, state_);
+}
+
+void Connection::observeSourceState(ConnectionStateCounter* counter)
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    observeState(source_counter_, counter, source_state_);
+}
+
+void Connection::stopObservingState(ConnectionStateCounter* counter)
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    if (sink_counter_ == counter) {
+        observeState(sink_counter_, nullptr, state_);
+    }
+    if (source_counter_ == counter) {
+        observeState(source_counter_, nullptr, source_state_);
+    }
+}
+
+void Connection::observeState(ConnectionStateCounter*& observer, ConnectionStateCounter* counter, State state)
+{
+    updateEnabled();
+
+    if (counted_ && observer) {
+        observer->remove(state);
+    }
+    observer = counter;
+    if (counted_ && observer) {
+        observer->add(state);
+    }
+}
+
+void Connection::updateEnabled()
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    bool enabled = from_ && to_ && isEnabled();
+    if (enabled == counted_) {
+        return;
+    }
+    counted_ = enabled;
+
+    // disabled connections are ignored by the transitions
+    if (sink_counter_) {
+        if (enabled) {
+            sink_counter_->add(state_);
+        } else {
+            sink_counter_->remove(state_);
+        }
+    }
+    if (source_counter_) {
+        if (enabled) {
+            source_counter_->add(source_state_);
+        } else {
+            source_counter_->remove(source_state_);
+        }
+    }
+}
+
 void Connection::setState(State s)
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
@@ -282,7 +540,8 @@ void Connection::setState(State s)
     // }
     // std::cerr << *this << "-> set state to " << str << std::endl;
 
-    state_ = s;
+    changeState(s);
+    updateSourceState();
 }
 
 OutputPtr Connection::from() const
@@ -312,7 +571,7 @@ int Connection::id() const
 ConnectionDescription Connection::getDescription() const
 {
     TokenDataConstPtr type = message_ ? message_->getTokenData() : makeEmpty<connection_types::AnyMessage>();
-    return ConnectionDescription(from_->getUUID(), to_->getUUID(), type, id_, seq_, isActive(), getFulcrumsCopy());
+    return ConnectionDescription(from_->getUUID(), to_->getUUID(), type, id_, seq_, isActive(), getFulcrumsCopy(), getBufferCapacity(), getOverflowPolicy());
 }
 
 bool Connection::contains(Connector* c) const
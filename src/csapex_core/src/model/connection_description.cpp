@@ -9,17 +9,38 @@
 
 using namespace csapex;
 
-ConnectionDescription::ConnectionDescription(const UUID& from, const UUID& to, const TokenDataConstPtr& type, int id, int seq, bool active, const std::vector<Fulcrum>& fulcrums)
-  : from(from), to(to), from_label(""), to_label(""), type(type), id(id), seq(seq), active(active), fulcrums(fulcrums)
+ConnectionDescription::ConnectionDescription(const UUID& from, const UUID& to, const TokenDataConstPtr& type, int id, int seq, bool active, const std::vector<Fulcrum>& fulcrums, int buffer_size,
+                                             OverflowPolicy overflow_policy)
+  : from(from)
+  , to(to)
+  , from_label("")
+  , to_label("")
+  , type(type)
+  , id(id)
+  , seq(seq)
+  , active(active)
+  , fulcrums(fulcrums)
+  , buffer_size(buffer_size)
+  , overflow_policy(overflow_policy)
 {
 }
 
 ConnectionDescription::ConnectionDescription(const ConnectionDescription& other)
-  : from(other.from), to(other.to), from_label(other.from_label), to_label(other.to_label), type(other.type), id(other.id), seq(other.seq), active(other.active), fulcrums(other.fulcrums)
+  : from(other.from)
+  , to(other.to)
+  , from_label(other.from_label)
+  , to_label(other.to_label)
+  , type(other.type)
+  , id(other.id)
+  , seq(other.seq)
+  , active(other.active)
+  , fulcrums(other.fulcrums)
+  , buffer_size(other.buffer_size)
+  , overflow_policy(other.overflow_policy)
 {
 }
 
-ConnectionDescription::ConnectionDescription()
+ConnectionDescription::ConnectionDescription() : buffer_size(1), overflow_policy(OverflowPolicy::BLOCK)
 {
 }
 
@@ -34,6 +55,8 @@ ConnectionDescription& ConnectionDescription::operator=(const ConnectionDescript
     active = other.active;
     fulcrums = other.fulcrums;
     seq = other.seq;
+    buffer_size = other.buffer_size;
+    overflow_policy = other.overflow_policy;
 
     return *this;
 }
@@ -54,6 +77,8 @@ void ConnectionDescription::serialize(SerializationBuffer& data, SemanticVersion
     data << active;
     data << fulcrums;
     data << seq;
+    data << buffer_size;
+    data << overflow_policy;
 }
 void ConnectionDescription::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
 {
@@ -66,4 +91,6 @@ void ConnectionDescription::deserialize(const SerializationBuffer& data, const S
     data >> active;
     data >> fulcrums;
     data >> seq;
+    data >> buffer_size;
+    data >> overflow_policy;
 }
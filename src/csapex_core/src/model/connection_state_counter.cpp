@@ -0,0 +1,92 @@
+/// HEADER
+#include <csapex/model/connection_state_counter.h>
+
+/// PROJECT
+#include <csapex/utility/assert.h>
+
+using namespace csapex;
+
+ConnectionStateCounter::ConnectionStateCounter() : counts_(0)
+{
+}
+
+int ConnectionStateCounter::shift(Connection::State state)
+{
+    return static_cast<int>(state) * BITS_PER_STATE;
+}
+
+void ConnectionStateCounter::add(Connection::State state)
+{
+    apex_assert_hard(count(state) < static_cast<int>(STATE_MASK));
+    counts_.fetch_add(std::uint64_t(1) << shift(state));
+}
+
+void ConnectionStateCounter::remove(Connection::State state)
+{
+    apex_assert_hard(count(state) > 0);
+    counts_.fetch_sub(std::uint64_t(1) << shift(state));
+}
+
+void ConnectionStateCounter::move(Connection::State from, Connection::State to)
+{
+    if (from == to) {
+        return;
+    }
+    apex_assert_hard(count(from) > 0);
+    // one atomic step, so that the connection is never seen twice or not at all
+    counts_.fetch_add((std::uint64_t(1) << shift(to)) - (std::uint64_t(1) << shift(from)));
+}
+
+int ConnectionStateCounter::count(std::uint64_t counts, Connection::State state)
+{
+    return static_cast<int>((counts >> shift(state)) & STATE_MASK);
+}
+
+int ConnectionStateCounter::total(std::uint64_t counts)
+{
+    return count(counts, Connection::State::NOT_INITIALIZED) + count(counts, Connection::State::UNREAD) + count(counts, Connection::State::READ);
+}
+
+int ConnectionStateCounter::countMatching(std::uint64_t counts, int state_bits)
+{
+    int matching = 0;
+    for (Connection::State state : { Connection::State::NOT_INITIALIZED, Connection::State::UNREAD, Connection::State::READ }) {
+        if (state_bits & (1 << static_cast<int>(state))) {
+            matching += count(counts, state);
+        }
+    }
+    return matching;
+}
+
+int ConnectionStateCounter::count(Connection::State state) const
+{
+    return count(counts_.load(), state);
+}
+
+int ConnectionStateCounter::total() const
+{
+    return total(counts_.load());
+}
+
+bool ConnectionStateCounter::areAll(Connection::State state) const
+{
+    std::uint64_t counts = counts_.load();
+    return countMatching(counts, 1 << static_cast<int>(state)) == total(counts);
+}
+
+bool ConnectionStateCounter::areAll(Connection::State a, Connection::State b) const
+{
+    std::uint64_t counts = counts_.load();
+    return countMatching(counts, (1 << static_cast<int>(a)) | (1 << static_cast<int>(b))) == total(counts);
+}
+
+bool ConnectionStateCounter::areAll(Connection::State a, Connection::State b, Connection::State c) const
+{
+    std::uint64_t counts = counts_.load();
+    return countMatching(counts, (1 << static_cast<int>(a)) | (1 << static_cast<int>(b)) | (1 << static_cast<int>(c))) == total(counts);
+}
+
+bool ConnectionStateCounter::isOne(Connection::State state) const
+{
+    return count(state) > 0;
+}
@@ -0,0 +1,45 @@
+/// HEADER
+#include <csapex/model/credit_account.h>
+
+/// PROJECT
+#include <csapex/utility/assert.h>
+
+using namespace csapex;
+
+CreditAccount::CreditAccount(int credits) : credits_(credits), available_(credits)
+{
+    apex_assert_hard(credits > 0);
+}
+
+int CreditAccount::getCredits() const
+{
+    return credits_;
+}
+
+int CreditAccount::getAvailableCredits() const
+{
+    return available_;
+}
+
+bool CreditAccount::hasCredit() const
+{
+    return available_ > 0;
+}
+
+void CreditAccount::take()
+{
+    --available_;
+}
+
+void CreditAccount::grant()
+{
+    int available = available_;
+    do {
+        if (available >= credits_) {
+            // token sets that were in flight before the account was created are not accounted for
+            return;
+        }
+    } while (!available_.compare_exchange_weak(available, available + 1));
+
+    credit_granted();
+}
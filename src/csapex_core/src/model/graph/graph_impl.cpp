@@ -3,6 +3,7 @@
 
 /// PROJECT
 #include <csapex/model/connection.h>
+#include <csapex/model/credit_account.h>
 #include <csapex/model/node_facade.h>
 #include <csapex/msg/input.h>
 #include <csapex/msg/output.h>
@@ -23,7 +24,7 @@
 
 using namespace csapex;
 
-GraphImplementation::GraphImplementation() : in_transaction_(false), nf_(nullptr)
+GraphImplementation::GraphImplementation() : in_transaction_(false), fusion_enabled_(true), frozen_(false), nf_(nullptr)
 {
 }
 
@@ -85,11 +86,26 @@ void GraphImplementation::clear()
 void GraphImplementation::addNode(NodeFacadeImplementationPtr nf)
 {
     apex_assert_hard_msg(nf, "NodeFacade added is not null");
+    thaw();
+
     graph::VertexPtr vertex = std::make_shared<graph::Vertex>(nf);
+    vertex->getNodeCharacteristics().is_replicable = nf->getNode()->isReplicable();
     vertices_.push_back(vertex);
 
     nf->getNodeHandle()->setVertex(vertex);
 
+    vertex_observations_[vertex.get()].push_back(nf->getNodeHandle()->getNodeState()->credits_changed.connect([this]() {
+        if (!in_transaction_) {
+            analyzeGraph();
+        }
+    }));
+    vertex_observations_[vertex.get()].push_back(nf->getNodeHandle()->getNodeState()->thread_changed.connect([this]() {
+        // only nodes that share a thread group are fused
+        if (!in_transaction_) {
+            calculateFusedChains();
+        }
+    }));
+
     sources_.insert(vertex);
     sinks_.insert(vertex);
 
@@ -116,6 +132,8 @@ std::vector<ConnectionDescription> GraphImplementation::enumerateAllConnections(
 
 void GraphImplementation::deleteNode(const UUID& uuid)
 {
+    thaw();
+
     NodeHandle* node_handle = findNodeHandle(uuid);
     node_handle->stop();
 
@@ -137,6 +155,10 @@ void GraphImplementation::deleteNode(const UUID& uuid)
     apex_assert_hard(removed);
     apex_assert_hard(removed == node_handle->getVertex());
 
+    vertex_observations_.erase(removed.get());
+    credit_grants_.erase(removed.get());
+    node_handle->setCreditAccounts({});
+
     sources_.erase(removed);
     sinks_.erase(removed);
 
@@ -170,6 +192,8 @@ std::size_t GraphImplementation::countNodes()
 bool GraphImplementation::addConnection(ConnectionPtr connection)
 {
     apex_assert_hard(connection);
+    thaw();
+
     edges_.push_back(connection);
 
     connection_observations_[connection.get()].push_back(connection->connection_changed.connect([this]() {
@@ -177,6 +201,9 @@ bool GraphImplementation::addConnection(ConnectionPtr connection)
             analyzeGraph();
         }
     }));
+    // the set of enabled connections is part of the frozen state
+    connection_observations_[connection.get()].push_back(connection->source_enable_changed.connect([this](bool) { thaw(); }));
+    connection_observations_[connection.get()].push_back(connection->sink_enabled_changed.connect([this](bool) { thaw(); }));
 
     if (!std::dynamic_pointer_cast<Event>(connection->from()) && !std::dynamic_pointer_cast<Slot>(connection->to())) {
         NodeHandle* n_from = findNodeHandleForConnector(connection->from()->getUUID());
@@ -210,8 +237,10 @@ bool GraphImplementation::addConnection(ConnectionPtr connection)
 void GraphImplementation::deleteConnection(ConnectionPtr connection)
 {
     apex_assert_hard(connection);
+    thaw();
 
-    connection_observations_[connection.get()].clear();
+    connection_observations_.erase(connection.get());
+    credit_refunds_.erase(connection.get());
 
     if (connection->isDetached()) {
         auto c = std::find(edges_.begin(), edges_.end(), connection);
@@ -322,9 +351,81 @@ void GraphImplementation::analyzeGraph()
 
     calculateDepths();
 
+    calculateFusedChains();
+
+    calculateCredits();
+
     state_changed();
 }
 
+void GraphImplementation::setFusionEnabled(bool enabled)
+{
+    if (fusion_enabled_ != enabled) {
+        fusion_enabled_ = enabled;
+        analyzeGraph();
+    }
+}
+
+bool GraphImplementation::isFusionEnabled() const
+{
+    return fusion_enabled_;
+}
+
+void GraphImplementation::freeze()
+{
+    thaw();
+
+    for (const graph::VertexPtr& vertex : vertices_) {
+        NodeFacadeImplementationPtr local_facade = std::dynamic_pointer_cast<NodeFacadeImplementation>(vertex->getNodeFacade());
+        apex_assert_hard(local_facade);
+
+        NodeHandle* nh = local_facade->getNodeHandle().get();
+        nh->freeze();
+        frozen_nodes_.push_back(nh);
+    }
+    for (GraphImplementation* child : getNestedGraphs()) {
+        child->freeze();
+    }
+
+    frozen_ = true;
+}
+
+void GraphImplementation::thaw()
+{
+    if (!frozen_) {
+        return;
+    }
+    frozen_ = false;
+
+    for (NodeHandle* nh : frozen_nodes_) {
+        nh->thaw();
+    }
+    for (GraphImplementation* child : getNestedGraphs()) {
+        child->thaw();
+    }
+
+    frozen_nodes_.clear();
+}
+
+bool GraphImplementation::isFrozen() const
+{
+    return frozen_;
+}
+
+std::vector<GraphImplementation*> GraphImplementation::getNestedGraphs() const
+{
+    std::vector<GraphImplementation*> result;
+    for (const graph::VertexPtr& vertex : vertices_) {
+        NodeFacadeImplementationPtr local_facade = std::dynamic_pointer_cast<NodeFacadeImplementation>(vertex->getNodeFacade());
+        if (local_facade && local_facade->getNodeHandle()->isGraph()) {
+            if (SubgraphNodePtr subgraph = std::dynamic_pointer_cast<SubgraphNode>(local_facade->getNode())) {
+                result.push_back(subgraph->getLocalGraph().get());
+            }
+        }
+    }
+    return result;
+}
+
 void GraphImplementation::buildConnectedComponents()
 {
     /* Find all connected sub components of this graph */
@@ -420,12 +521,18 @@ std::set<graph::Vertex*> GraphImplementation::findVerticesThatNeedMessages()
     for (const auto& v : vertices_) {
         if (v->getNodeFacade()->isProcessingNothingMessages()) {
             vertices_that_need_messages.insert(v.get());
-            break;
+            continue;
         }
 
         NodeFacadeImplementationPtr local_facade = std::dynamic_pointer_cast<NodeFacadeImplementation>(v->getNodeFacade());
         apex_assert_hard(local_facade);
 
+        if (local_facade->getNodeHandle()->getNodeState()->getCredits() > 0) {
+            // credits are only returned when the token sets arrive, so they must not be pruned on the way
+            vertices_that_need_messages.insert(v.get());
+            continue;
+        }
+
         for (const auto& c : local_facade->getNodeHandle()->getOutputTransition()->getConnections()) {
             if (c->to()->isEssential()) {
                 vertices_that_need_messages.insert(v.get());
@@ -592,6 +699,180 @@ void GraphImplementation::calculateDepths()
     }
 }
 
+void GraphImplementation::calculateFusedChains()
+{
+    // find chains of nodes that are only connected to their predecessor and successor by exactly one message connection.
+    // the nodes of such a chain can be executed back to back in one task, if they share a thread.
+
+    for (const graph::VertexPtr& vertex : vertices_) {
+        NodeCharacteristics& characteristics = vertex->getNodeCharacteristics();
+        characteristics.fused_chain = -1;
+        characteristics.fused_chain_position = -1;
+    }
+
+    if (!fusion_enabled_) {
+        return;
+    }
+
+    auto getNodeHandle = [](const graph::Vertex* vertex) -> NodeHandle* {
+        NodeFacadeImplementationPtr local_facade = std::dynamic_pointer_cast<NodeFacadeImplementation>(vertex->getNodeFacade());
+        apex_assert_hard(local_facade);
+        return local_facade->getNodeHandle().get();
+    };
+    auto countConnections = [](const NodeHandle* nh, bool outgoing) {
+        int connections = 0;
+        for (const ConnectablePtr& connector : nh->getExternalConnectors()) {
+            if (connector->isOutput() == outgoing) {
+                connections += connector->countConnections();
+            }
+        }
+        return connections;
+    };
+    auto isFusable = [&](const graph::Vertex* from, const graph::Vertex* to) {
+        if (from->getChildren().size() != 1 || to->getParents().size() != 1) {
+            return false;
+        }
+        NodeHandle* from_nh = getNodeHandle(from);
+        NodeHandle* to_nh = getNodeHandle(to);
+        if (from_nh->isGraph() || to_nh->isGraph()) {
+            return false;
+        }
+        if (from_nh->getNodeState()->getThreadId() != to_nh->getNodeState()->getThreadId()) {
+            return false;
+        }
+        // the only connection has to be a message connection, signals are never fused
+        return countConnections(from_nh, true) == 1 && from_nh->getOutputTransition()->getConnections().size() == 1 && countConnections(to_nh, false) == 1 &&
+               to_nh->getInputTransition()->getConnections().size() == 1;
+    };
+
+    int chain = 0;
+    for (const graph::VertexPtr& head : vertices_) {
+        std::vector<graph::VertexPtr> parents = head->getParents();
+        if (parents.size() == 1 && isFusable(parents.front().get(), head.get())) {
+            // not the start of a chain
+            continue;
+        }
+
+        int position = 0;
+        graph::Vertex* current = head.get();
+        while (current->getChildren().size() == 1) {
+            graph::Vertex* next = current->getChildren().front().get();
+            if (!isFusable(current, next)) {
+                break;
+            }
+            if (position == 0) {
+                current->getNodeCharacteristics().fused_chain = chain;
+                current->getNodeCharacteristics().fused_chain_position = position++;
+            }
+            next->getNodeCharacteristics().fused_chain = chain;
+            next->getNodeCharacteristics().fused_chain_position = position++;
+            current = next;
+        }
+
+        if (position > 0) {
+            ++chain;
+        }
+    }
+}
+
+void GraphImplementation::calculateCredits()
+{
+    // every node with credits limits the number of token sets that each of its sources may have in flight.
+    // a credit is returned when the node has processed a token set or when one was dropped on the way.
+
+    credit_grants_.clear();
+    credit_refunds_.clear();
+
+    auto getNodeHandle = [](const graph::Vertex* vertex) -> NodeHandle* {
+        NodeFacadeImplementationPtr local_facade = std::dynamic_pointer_cast<NodeFacadeImplementation>(vertex->getNodeFacade());
+        apex_assert_hard(local_facade);
+        return local_facade->getNodeHandle().get();
+    };
+    auto collect = [](graph::Vertex* start, bool upstream) {
+        std::set<graph::Vertex*> reached;
+        std::deque<graph::Vertex*> Q;
+        Q.push_back(start);
+        while (!Q.empty()) {
+            graph::Vertex* top = Q.back();
+            Q.pop_back();
+
+            for (const graph::VertexPtr& next : upstream ? top->getParents() : top->getChildren()) {
+                if (reached.insert(next.get()).second) {
+                    Q.push_back(next.get());
+                }
+            }
+        }
+        return reached;
+    };
+
+    // the vertices at both ends of each connection, looked up once instead of for every pair of source and sink
+    std::map<Connection*, std::pair<graph::Vertex*, graph::Vertex*>> ends_of_edge;
+    for (const ConnectionPtr& connection : edges_) {
+        NodeHandle* from = findNodeHandleForConnectorNoThrow(connection->from()->getUUID());
+        NodeHandle* to = findNodeHandleForConnectorNoThrow(connection->to()->getUUID());
+        if (from && to) {
+            ends_of_edge[connection.get()] = std::make_pair(from->getVertex().get(), to->getVertex().get());
+        }
+    }
+
+    std::map<graph::Vertex*, std::vector<CreditAccountPtr>> accounts_of_source;
+    std::map<Connection*, std::vector<CreditAccountPtr>> accounts_of_edge;
+
+    for (const graph::VertexPtr& sink : vertices_) {
+        int credits = getNodeHandle(sink.get())->getNodeState()->getCredits();
+        if (credits <= 0) {
+            continue;
+        }
+
+        std::set<graph::Vertex*> ancestors = collect(sink.get(), true);
+        std::set<graph::Vertex*> leading_to_sink = ancestors;
+        leading_to_sink.insert(sink.get());
+
+        std::vector<CreditAccountPtr> accounts_of_sink;
+        for (graph::Vertex* source : ancestors) {
+            if (!source->getParents().empty()) {
+                continue;
+            }
+
+            CreditAccountPtr account = std::make_shared<CreditAccount>(credits);
+            accounts_of_source[source].push_back(account);
+            accounts_of_sink.push_back(account);
+
+            std::set<graph::Vertex*> reachable = collect(source, false);
+            reachable.insert(source);
+
+            for (const auto& edge : ends_of_edge) {
+                if (reachable.find(edge.second.first) != reachable.end() && leading_to_sink.find(edge.second.second) != leading_to_sink.end()) {
+                    accounts_of_edge[edge.first].push_back(account);
+                }
+            }
+        }
+
+        if (!accounts_of_sink.empty()) {
+            NodeFacadeImplementationPtr local_facade = std::dynamic_pointer_cast<NodeFacadeImplementation>(sink->getNodeFacade());
+            credit_grants_[sink.get()] = local_facade->messages_processed.connect([accounts_of_sink]() {
+                for (const CreditAccountPtr& account : accounts_of_sink) {
+                    account->grant();
+                }
+            });
+        }
+    }
+
+    for (const auto& pair : accounts_of_edge) {
+        std::vector<CreditAccountPtr> accounts = pair.second;
+        credit_refunds_[pair.first].push_back(pair.first->token_dropped.connect([accounts]() {
+            for (const CreditAccountPtr& account : accounts) {
+                account->grant();
+            }
+        }));
+    }
+
+    for (const graph::VertexPtr& vertex : vertices_) {
+        auto pos = accounts_of_source.find(vertex.get());
+        getNodeHandle(vertex.get())->setCreditAccounts(pos != accounts_of_source.end() ? pos->second : std::vector<CreditAccountPtr>());
+    }
+}
+
 void GraphImplementation::checkNodeState(NodeHandle* nh)
 {
     // check if the node should be enabled
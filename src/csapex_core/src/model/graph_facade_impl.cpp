@@ -30,10 +30,15 @@ GraphFacadeImplementation::GraphFacadeImplementation(ThreadPool& executor, Graph
     observe(graph->connection_added, [this](const ConnectionDescription& ci) { connection_added(ci); });
     observe(graph->connection_removed, [this](const ConnectionDescription& ci) { connection_removed(ci); });
     observe(graph->state_changed, state_changed);
+    observe(graph->state_changed, [this]() { updateThreadPlacement(); });
 
     observe(graph_node_->forwarding_connector_added, forwarding_connector_added);
     observe(graph_node_->forwarding_connector_removed, forwarding_connector_removed);
 
+    if (!parent_) {
+        observe(executor_.automatic_placement_changed, [this](bool) { updateThreadPlacement(); });
+    }
+
     if (parent_) {
         // TODO: refactor!
         apex_assert_hard(graph_handle_);
@@ -516,6 +521,40 @@ void GraphFacadeImplementation::createSubgraphFacade(NodeFacadePtr nf)
     child_added(sub_graph_facade);
 }
 
+void GraphFacadeImplementation::updateThreadPlacement()
+{
+    // the chains are only unique within the root graph
+    if (parent_) {
+        parent_->updateThreadPlacement();
+        return;
+    }
+
+    if (!executor_.isAutomaticPlacementEnabled()) {
+        return;
+    }
+
+    std::map<TaskGenerator*, std::pair<int, int>> chains;
+    collectPlacementChains(chains, -1, 0);
+    executor_.setPlacementChains(chains);
+}
+
+void GraphFacadeImplementation::collectPlacementChains(std::map<TaskGenerator*, std::pair<int, int>>& chains, int chain, int depth) const
+{
+    for (const auto& pair : generators_) {
+        const UUID& uuid = pair.first;
+
+        // nodes inside of a sub graph belong to the chain of the sub graph node
+        int node_chain = parent_ ? chain : graph_->getComponent(uuid);
+        int node_depth = depth + std::max(0, graph_->getDepth(uuid));
+        chains[pair.second.get()] = std::make_pair(node_chain, node_depth);
+
+        auto child = children_.find(uuid);
+        if (child != children_.end()) {
+            child->second->collectPlacementChains(chains, node_chain, node_depth);
+        }
+    }
+}
+
 void GraphFacadeImplementation::clearBlock()
 {
     executor_.clear();
@@ -89,6 +89,11 @@ bool Node::canRunInSeparateProcess() const
     return true;
 }
 
+bool Node::isReplicable() const
+{
+    return false;
+}
+
 bool Node::canProcess() const
 {
     if (!node_handle_) {
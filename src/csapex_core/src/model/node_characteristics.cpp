@@ -16,6 +16,9 @@ NodeCharacteristics::NodeCharacteristics()
   ,
 
   is_leading_to_essential_vertex(false)
+  , fused_chain(-1)
+  , fused_chain_position(-1)
+  , is_replicable(false)
 {
 }
 
@@ -28,6 +31,9 @@ void NodeCharacteristics::serialize(SerializationBuffer& data, SemanticVersion&
     data << is_combined_by_joining_vertex;
     data << is_leading_to_joining_vertex;
     data << is_leading_to_essential_vertex;
+    data << fused_chain;
+    data << fused_chain_position;
+    data << is_replicable;
 }
 void NodeCharacteristics::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
 {
@@ -38,4 +44,7 @@ void NodeCharacteristics::deserialize(const SerializationBuffer& data, const Sem
     data >> is_combined_by_joining_vertex;
     data >> is_leading_to_joining_vertex;
     data >> is_leading_to_essential_vertex;
+    data >> fused_chain;
+    data >> fused_chain_position;
+    data >> is_replicable;
 }
@@ -142,6 +142,7 @@ NodeHandlePtr NodeConstructor::makeNodeHandle(const UUID& uuid, const UUIDProvid
         OutputTransitionPtr ot = std::make_shared<OutputTransition>();
         InputTransitionPtr it = std::make_shared<InputTransition>();
         NodeHandlePtr node_handle = std::make_shared<NodeHandle>(type_, uuid, node, uuid_provider, it, ot);
+        node_handle->setNodeConstructor(c);
         node->initialize(node_handle);
 
         if (!uuid.empty() && uuid_provider) {
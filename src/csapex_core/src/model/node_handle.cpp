@@ -3,6 +3,7 @@
 
 /// COMPONENT
 #include <csapex/model/connectable.h>
+#include <csapex/model/credit_account.h>
 #include <csapex/model/generic_state.h>
 #include <csapex/model/graph/graph_impl.h>
 #include <csapex/model/graph.h>
@@ -41,6 +42,10 @@ NodeHandle::NodeHandle(const std::string& type, const UUID& uuid, NodePtr node,
   ,
 
   uuid_provider_(uuid_provider)
+  , frozen_(false)
+  , frozen_is_source_(false)
+  , frozen_is_sink_(false)
+  , frozen_inputs_connected_(false)
   ,
 
   guard_(-1)
@@ -81,6 +86,10 @@ NodeHandle::NodeHandle(const std::string& type, const UUID& uuid, NodePtr node,
     });
     node_state_->logger_level_changed.connect([this]() { updateLoggerLevel(); });
     node_state_->muted_changed.connect([this]() { updateLoggerLevel(); });
+    node_state_->execution_mode_changed.connect([this]() {
+        // pipelining nodes let their predecessors produce the next token while they are still busy
+        transition_in_->setPipelining(node_state_->getExecutionMode() == ExecutionMode::PIPELINING);
+    });
 
     //    triggerNodeStateChanged();
 
@@ -135,6 +144,9 @@ bool NodeHandle::isIsolated() const
 
 bool NodeHandle::isSource() const
 {
+    if (frozen_) {
+        return frozen_is_source_;
+    }
     for (const InputPtr& in : external_inputs_) {
         if (!in->isOptional() || in->isConnected()) {
             return false;
@@ -146,9 +158,52 @@ bool NodeHandle::isSource() const
 
 bool NodeHandle::isSink() const
 {
+    if (frozen_) {
+        return frozen_is_sink_;
+    }
     return external_outputs_.empty() || !hasConnectionsOutgoing();
 }
 
+bool NodeHandle::areRequiredInputsConnected() const
+{
+    if (frozen_) {
+        return frozen_inputs_connected_;
+    }
+    for (const InputPtr& i : external_inputs_) {
+        if (!i->isOptional() && !i->hasEnabledConnection()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void NodeHandle::freeze()
+{
+    thaw();
+
+    frozen_is_source_ = isSource();
+    frozen_is_sink_ = isSink();
+    frozen_inputs_connected_ = areRequiredInputsConnected();
+
+    transition_in_->freeze();
+    transition_out_->freeze();
+
+    frozen_ = true;
+}
+
+void NodeHandle::thaw()
+{
+    frozen_ = false;
+
+    transition_in_->thaw();
+    transition_out_->thaw();
+}
+
+bool NodeHandle::isFrozen() const
+{
+    return frozen_;
+}
+
 bool NodeHandle::hasConnectionsIncoming() const
 {
     return transition_in_->hasConnection();
@@ -1091,6 +1146,42 @@ const Rate& NodeHandle::getRate() const
     return rate_;
 }
 
+void NodeHandle::setCreditAccounts(const std::vector<CreditAccountPtr>& accounts)
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    credit_connections_.clear();
+
+    credit_accounts_ = accounts;
+    for (const CreditAccountPtr& account : credit_accounts_) {
+        credit_connections_.emplace_back(account->credit_granted.connect([this]() { might_be_enabled(); }));
+    }
+}
+
+std::vector<CreditAccountPtr> NodeHandle::getCreditAccounts() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return credit_accounts_;
+}
+
+bool NodeHandle::hasCredits() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    for (const CreditAccountPtr& account : credit_accounts_) {
+        if (!account->hasCredit()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void NodeHandle::takeCredits()
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    for (const CreditAccountPtr& account : credit_accounts_) {
+        account->take();
+    }
+}
+
 void NodeHandle::setNodeRunner(NodeRunnerWeakPtr runner)
 {
     node_runner_ = runner;
@@ -1100,3 +1191,29 @@ NodeRunnerPtr NodeHandle::getNodeRunner() const
 {
     return node_runner_.lock();
 }
+
+void NodeHandle::setNodeConstructor(std::function<NodePtr()> constructor)
+{
+    node_constructor_ = constructor;
+}
+
+NodeHandlePtr NodeHandle::makeReplica(const UUIDProviderPtr& uuid_provider) const
+{
+    if (!node_constructor_ || isGraph()) {
+        return nullptr;
+    }
+
+    NodePtr node = node_constructor_();
+    if (!node) {
+        return nullptr;
+    }
+
+    // the replica uses the same UUID, so that its connectors can be mapped to the connectors of the original
+    UUID uuid = UUIDProvider::makeUUID_forced(uuid_provider, getUUID().getFullName());
+    NodeHandlePtr replica = std::make_shared<NodeHandle>(node_type_, uuid, node, uuid_provider, std::make_shared<InputTransition>(), std::make_shared<OutputTransition>());
+    node->initialize(replica);
+    node->setupParameters(*node);
+    node->setup(*replica);
+
+    return replica;
+}
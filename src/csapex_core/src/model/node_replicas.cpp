@@ -0,0 +1,458 @@
+/// HEADER
+#include <csapex/model/node_replicas.h>
+
+/// COMPONENT
+#include <csapex/model/node.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/token.h>
+#include <csapex/msg/input.h>
+#include <csapex/msg/output.h>
+#include <csapex/param/parameter.h>
+#include <csapex/scheduling/scheduler.h>
+#include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_generator.h>
+#include <csapex/utility/assert.h>
+#include <csapex/utility/exceptions.h>
+#include <csapex/utility/uuid_provider.h>
+
+/// SYSTEM
+#include <any>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+
+using namespace csapex;
+
+struct NodeReplicas::Entry
+{
+    // guarded by NodeReplicas::reorder_mutex_
+    bool done = false;
+    Result result;
+};
+
+struct NodeReplicas::Job
+{
+    std::vector<std::pair<UUID, TokenPtr>> inputs;
+    std::vector<std::pair<std::string, std::any>> parameters;
+    std::shared_ptr<Entry> entry;
+};
+
+/**
+ * @brief The Replica class executes the token sets of one copy of the node, one task at a time, on the scheduler of the original node
+ */
+class NodeReplicas::Replica : public TaskGenerator
+{
+public:
+    Replica(NodeReplicas* owner, UUIDProviderPtr uuid_provider, NodeHandlePtr handle)
+      : uuid_provider(uuid_provider), handle(handle), owner_(owner), scheduler_(nullptr), stepping_(false), executing_(false)
+    {
+    }
+
+    void createTask()
+    {
+        std::weak_ptr<TaskGenerator> self_weak = shared_from_this();
+        process_ = std::make_shared<Task>(std::string("process replica of ") + handle->getUUID().getFullName(),
+                                          [self_weak]() {
+                                              if (auto self = self_weak.lock()) {
+                                                  static_cast<Replica*>(self.get())->execute();
+                                              }
+                                          },
+                                          0, this);
+    }
+
+    void push(Job&& job)
+    {
+        {
+            std::unique_lock<std::recursive_mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        schedule();
+    }
+
+    /**
+     * @brief release stops the replica from processing, after this returns, the owner is no longer accessed
+     */
+    void release()
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        owner_ = nullptr;
+        jobs_.clear();
+        idle_.wait(lock, [this]() { return !executing_; });
+    }
+
+    void assignToScheduler(Scheduler* scheduler) override
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        apex_assert_hard(scheduler_ == nullptr);
+        scheduler_ = scheduler;
+        scheduler_->add(shared_from_this(), remaining_tasks_);
+        remaining_tasks_.clear();
+    }
+
+    Scheduler* getScheduler() const override
+    {
+        return scheduler_;
+    }
+
+    void detach() override
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        if (scheduler_) {
+            std::vector<TaskPtr> remaining = scheduler_->remove(this);
+            remaining_tasks_.insert(remaining_tasks_.end(), remaining.begin(), remaining.end());
+            scheduler_ = nullptr;
+        }
+    }
+
+    // pausing is handled by the thread group, the replicas only run when the original node dispatches to them
+    bool isPaused() const override
+    {
+        return false;
+    }
+    void setPause(bool /*pause*/) override
+    {
+    }
+
+    bool canStartStepping() const override
+    {
+        return true;
+    }
+    void setSteppingMode(bool stepping) override
+    {
+        stepping_ = stepping;
+    }
+    void step() override
+    {
+    }
+    bool isStepping() const override
+    {
+        return stepping_;
+    }
+    bool isStepDone() const override
+    {
+        // a step is done once the token sets that were dispatched during it are processed
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        return jobs_.empty() && !executing_;
+    }
+
+    UUID getUUID() const override
+    {
+        return handle->getUUID();
+    }
+
+    void setError(const std::string& /*msg*/) override
+    {
+        // errors are part of the result of the token set, see NodeReplicas::process
+    }
+
+    void reset() override
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        remaining_tasks_.clear();
+        if (!jobs_.empty()) {
+            // the scheduler has dropped the task, but the dispatched token sets still have to be finished
+            lock.unlock();
+            schedule();
+        }
+    }
+
+    void setSuppressExceptions(bool /*suppress_exceptions*/) override
+    {
+    }
+
+public:
+    // every replica needs its own provider, so that its connectors get the same UUIDs as the original ones
+    UUIDProviderPtr uuid_provider;
+    NodeHandlePtr handle;
+
+private:
+    void schedule()
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        if (scheduler_) {
+            scheduler_->schedule(process_);
+        } else if (remaining_tasks_.empty()) {
+            // handed to the next scheduler in assignToScheduler
+            remaining_tasks_.push_back(process_);
+        }
+    }
+
+    void execute()
+    {
+        NodeReplicas* owner;
+        Job job;
+        {
+            std::unique_lock<std::recursive_mutex> lock(mutex_);
+            if (!owner_ || jobs_.empty()) {
+                return;
+            }
+            owner = owner_;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+            executing_ = true;
+        }
+
+        owner->process(*this, job);
+        owner->finish(job.entry);
+
+        bool more;
+        {
+            std::unique_lock<std::recursive_mutex> lock(mutex_);
+            executing_ = false;
+            more = !jobs_.empty();
+        }
+        idle_.notify_all();
+
+        if (more) {
+            // one token set per task, so that the other tasks of the group are not starved
+            schedule();
+        } else if (stepping_) {
+            end_step();
+        }
+    }
+
+private:
+    mutable std::recursive_mutex mutex_;
+    std::condition_variable_any idle_;
+
+    NodeReplicas* owner_;
+    Scheduler* scheduler_;
+    std::atomic<bool> stepping_;
+
+    TaskPtr process_;
+    std::vector<TaskPtr> remaining_tasks_;
+
+    std::deque<Job> jobs_;
+    bool executing_;
+};
+
+NodeReplicas::NodeReplicas(NodeHandlePtr node_handle, int count, Scheduler* scheduler) : node_handle_(node_handle), next_replica_(0), last_sequence_number_(-1)
+{
+    for (int i = 0; i < count; ++i) {
+        UUIDProviderPtr uuid_provider = std::make_shared<UUIDProvider>();
+        NodeHandlePtr handle;
+        try {
+            handle = node_handle_->makeReplica(uuid_provider);
+        } catch (const std::exception& e) {
+            if (NodePtr node = node_handle_->getNode().lock()) {
+                node->aerr << "cannot create replica: " << e.what() << std::endl;
+            }
+        }
+        if (!handle) {
+            break;
+        }
+
+        std::shared_ptr<Replica> replica = std::make_shared<Replica>(this, uuid_provider, handle);
+        replica->createTask();
+        replicas_.push_back(replica);
+    }
+
+    std::set<std::string> all_parameters;
+    if (NodePtr node = node_handle_->getNode().lock()) {
+        for (const param::ParameterPtr& p : node->getParameters()) {
+            all_parameters.insert(p->name());
+            parameter_connections_.emplace_back(p->parameter_changed.connect([this](param::Parameter* p) {
+                std::unique_lock<std::mutex> lock(parameters_mutex_);
+                for (std::set<std::string>& outdated : outdated_parameters_) {
+                    outdated.insert(p->name());
+                }
+            }));
+        }
+    }
+    // the replicas were set up with the default values
+    outdated_parameters_.resize(replicas_.size(), all_parameters);
+
+    assignToScheduler(scheduler);
+}
+
+NodeReplicas::~NodeReplicas()
+{
+    parameter_connections_.clear();
+
+    for (const std::shared_ptr<Replica>& replica : replicas_) {
+        replica->release();
+        replica->detach();
+    }
+}
+
+void NodeReplicas::assignToScheduler(Scheduler* scheduler)
+{
+    for (const std::shared_ptr<Replica>& replica : replicas_) {
+        replica->detach();
+        if (scheduler) {
+            replica->assignToScheduler(scheduler);
+        }
+    }
+}
+
+int NodeReplicas::getCount() const
+{
+    return replicas_.size();
+}
+
+std::size_t NodeReplicas::getPendingCount() const
+{
+    std::unique_lock<std::mutex> lock(reorder_mutex_);
+    return reorder_buffer_.size();
+}
+
+bool NodeReplicas::canDispatch() const
+{
+    return !replicas_.empty() && getPendingCount() < replicas_.size();
+}
+
+void NodeReplicas::dispatch()
+{
+    apex_assert_hard(!replicas_.empty());
+
+    Job job;
+
+    long sequence_number = last_sequence_number_ + 1;
+    std::vector<Token::OriginsPtr> origins;
+    for (const InputPtr& input : node_handle_->getExternalInputs()) {
+        if (input->isParameter()) {
+            // changed parameters are forwarded by value below
+            continue;
+        }
+        if (TokenPtr token = input->getToken()) {
+            job.inputs.emplace_back(input->getUUID(), token);
+            origins.push_back(token->getOrigins());
+            sequence_number = std::max<long>(sequence_number, token->getSequenceNumber());
+        }
+    }
+
+    std::size_t replica_index = next_replica_;
+    next_replica_ = (next_replica_ + 1) % replicas_.size();
+
+    std::set<std::string> outdated;
+    {
+        std::unique_lock<std::mutex> lock(parameters_mutex_);
+        outdated.swap(outdated_parameters_[replica_index]);
+    }
+    if (NodePtr node = node_handle_->getNode().lock()) {
+        for (const std::string& name : outdated) {
+            if (!node->hasParameter(name)) {
+                continue;
+            }
+            param::ParameterPtr p = node->getParameter(name);
+            std::any value;
+            try {
+                param::Parameter::Lock lock = p->lock();
+                p->get_unsafe(value);
+            } catch (const std::exception&) {
+                // parameters without a value (e.g. triggers) are not replicated
+                continue;
+            }
+            job.parameters.emplace_back(name, value);
+        }
+    }
+
+    job.entry = std::make_shared<Entry>();
+    job.entry->result.sequence_number = sequence_number;
+    job.entry->result.origins = Token::mergeOrigins(origins);
+    {
+        std::unique_lock<std::mutex> lock(reorder_mutex_);
+        reorder_buffer_[sequence_number] = job.entry;
+        last_sequence_number_ = sequence_number;
+    }
+
+    replicas_[replica_index]->push(std::move(job));
+}
+
+bool NodeReplicas::takeNextResult(Result& result)
+{
+    std::unique_lock<std::mutex> lock(reorder_mutex_);
+    if (reorder_buffer_.empty()) {
+        return false;
+    }
+
+    auto oldest = reorder_buffer_.begin();
+    if (!oldest->second->done) {
+        return false;
+    }
+
+    result = std::move(oldest->second->result);
+    reorder_buffer_.erase(oldest);
+    return true;
+}
+
+void NodeReplicas::process(Replica& replica, Job& job)
+{
+    NodeHandle& handle = *replica.handle;
+    NodePtr node = handle.getNode().lock();
+    apex_assert_hard(node);
+
+    Result& result = job.entry->result;
+
+    try {
+        for (const auto& pair : job.parameters) {
+            if (!node->hasParameter(pair.first)) {
+                continue;
+            }
+            param::ParameterPtr p = node->getParameter(pair.first);
+            bool changed = false;
+            {
+                param::Parameter::Lock lock = p->lock();
+                changed = p->set_unsafe(pair.second);
+            }
+            if (changed) {
+                p->triggerChange();
+            }
+        }
+        for (auto& pair : node->getChangedParameters()) {
+            if (param::ParameterPtr p = pair.first.lock()) {
+                for (auto& cb : pair.second) {
+                    cb(p.get());
+                }
+            }
+        }
+
+        for (const auto& pair : job.inputs) {
+            if (InputPtr input = handle.getInput(pair.first)) {
+                input->setToken(pair.second);
+            }
+        }
+
+        node->process(handle, *node);
+
+        for (const OutputPtr& output : handle.getExternalOutputs()) {
+            if (TokenPtr token = output->getAddedToken()) {
+                if (OutputPtr original = node_handle_->getOutput(output->getUUID())) {
+                    result.outputs.emplace_back(original, token);
+                }
+            }
+        }
+
+    } catch (const std::exception& e) {
+        result.outputs.clear();
+        result.error = e.what();
+    } catch (const Failure&) {
+        result.outputs.clear();
+        result.failure = std::current_exception();
+    } catch (...) {
+        result.outputs.clear();
+        result.failure = std::make_exception_ptr(Failure("Unknown exception caught in NodeWorker."));
+    }
+
+    for (const InputPtr& input : handle.getExternalInputs()) {
+        input->free();
+    }
+    for (const OutputPtr& output : handle.getExternalOutputs()) {
+        output->clearBuffer();
+    }
+}
+
+void NodeReplicas::finish(const std::shared_ptr<Entry>& entry)
+{
+    bool oldest;
+    {
+        std::unique_lock<std::mutex> lock(reorder_mutex_);
+        entry->done = true;
+        oldest = !reorder_buffer_.empty() && reorder_buffer_.begin()->second == entry;
+    }
+
+    // results that overtook an older token set are only handed back together with it
+    if (oldest) {
+        result_available();
+    }
+}
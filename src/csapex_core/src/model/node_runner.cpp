@@ -12,13 +12,32 @@
 #include <csapex/utility/thread.h>
 #include <csapex/model/subgraph_node.h>
 #include <csapex/utility/exceptions.h>
+#include <csapex/model/graph/vertex.h>
+#include <csapex/model/node_characteristics.h>
 
 /// SYSTEM
 #include <memory>
 #include <iostream>
+#include <deque>
+#include <set>
 
 using namespace csapex;
 
+namespace
+{
+/**
+ * @brief The FusedDispatch struct collects the tasks of a fused chain that become ready while the chain is executed
+ */
+struct FusedDispatch
+{
+    Scheduler* scheduler;
+    std::deque<TaskPtr> pending;
+    std::set<const NodeRunner*> executed;
+};
+
+thread_local FusedDispatch* current_fused_dispatch = nullptr;
+}  // namespace
+
 NodeRunner::NodeRunner(NodeWorkerPtr worker)
   : worker_(worker)
   , nh_(worker->getNodeHandle())
@@ -28,6 +47,10 @@ NodeRunner::NodeRunner(NodeWorkerPtr worker)
   , possible_steps_(0)
   , step_done_(false)
   , guard_(-1)
+  , batch_size_(1)
+  , batch_time_slice_(std::chrono::milliseconds(1))
+  , batching_(false)
+  , batch_pending_(false)
   , waiting_for_execution_(false)
   , waiting_for_step_(false)
   , suppress_exceptions_(true)
@@ -43,6 +66,12 @@ NodeRunner::NodeRunner(NodeWorkerPtr worker)
     });
     max_frequency_ = nh_->getNodeState()->getMaximumFrequency();
     nh_->getRate().setFrequency(max_frequency_);
+
+    nh_->getNodeState()->deadline_changed.connect([this]() { deadline_ = nh_->getNodeState()->getDeadline(); });
+    deadline_ = nh_->getNodeState()->getDeadline();
+
+    nh_->getNodeState()->batch_size_changed.connect([this]() { batch_size_ = nh_->getNodeState()->getBatchSize(); });
+    batch_size_ = nh_->getNodeState()->getBatchSize();
 }
 
 NodeRunner::~NodeRunner()
@@ -160,6 +189,11 @@ void NodeRunner::assignToScheduler(Scheduler* scheduler)
 
     // generic task
     observe(nh_->execution_requested, [this](std::function<void()> cb) { schedule(std::make_shared<Task>("anonymous", cb, 0, this)); });
+
+    lock.unlock();
+
+    // the replicas of the node are executed by the same thread group
+    worker_->setScheduler(scheduler);
 }
 
 Scheduler* NodeRunner::getScheduler() const
@@ -170,6 +204,13 @@ Scheduler* NodeRunner::getScheduler() const
 void NodeRunner::scheduleProcess()
 {
     apex_assert_hard(guard_ == -1);
+    if (batching_) {
+        // the running batch picks up the new messages itself, or reschedules once it yields
+        batch_pending_ = true;
+        if (batching_) {
+            return;
+        }
+    }
     if (!paused_) {
         bool source = nh_->isSource();
         if (!source || !stepping_ || possible_steps_) {
@@ -177,6 +218,7 @@ void NodeRunner::scheduleProcess()
             // if(worker_->canExecute()) {
             if (!waiting_for_execution_) {
                 if(!execute_->isScheduled()) {
+                    updateDeadline(std::chrono::steady_clock::now());
                     schedule(execute_);
                 }
             }
@@ -185,6 +227,17 @@ void NodeRunner::scheduleProcess()
     }
 }
 
+void NodeRunner::updateDeadline(std::chrono::steady_clock::time_point release)
+{
+    // without an explicit deadline, an execution has to be done by the end of its period
+    double relative_deadline = deadline_ > 0.0 ? deadline_ : (max_frequency_ > 0.0 ? 1.0 / max_frequency_ : 0.0);
+    if (relative_deadline > 0.0) {
+        execute_->setDeadline(release + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(relative_deadline)));
+    } else {
+        execute_->setDeadline(std::chrono::steady_clock::time_point::max());
+    }
+}
+
 void NodeRunner::checkParameters()
 {
     worker_->handleChangedParameters();
@@ -195,12 +248,78 @@ void NodeRunner::notify()
     worker_->notifyMessagesProcessedDownstream();
 }
 
+bool NodeRunner::isFused() const
+{
+    graph::VertexPtr vertex = nh_->getVertex();
+    return vertex && vertex->getNodeCharacteristics().fused_chain >= 0;
+}
+
 void NodeRunner::execute()
 {
-    if (stepping_ && possible_steps_ <= 0) {
+    if (current_fused_dispatch || stepping_ || !isFused()) {
+        executeNode();
         return;
     }
 
+    // this node starts a fused dispatch: all nodes of its chain that become ready are executed
+    // directly in this task, instead of being handed to the scheduler one by one
+    FusedDispatch dispatch{ scheduler_, {}, { this } };
+    current_fused_dispatch = &dispatch;
+    try {
+        executeNode();
+        while (!dispatch.pending.empty()) {
+            TaskPtr task = dispatch.pending.front();
+            dispatch.pending.pop_front();
+            task->setScheduled(false);
+            if (!dispatch.scheduler->executeInline(task)) {
+                // the node is executing on another worker of the group, the task has to wait for its turn
+                dispatch.scheduler->schedule(task);
+            }
+        }
+    } catch (...) {
+        // hand the remaining tasks back to the scheduler
+        current_fused_dispatch = nullptr;
+        for (const TaskPtr& task : dispatch.pending) {
+            task->setScheduled(false);
+            dispatch.scheduler->schedule(task);
+        }
+        throw;
+    }
+    current_fused_dispatch = nullptr;
+}
+
+void NodeRunner::executeNode()
+{
+    if (batch_size_ <= 1 || stepping_) {
+        processOnce();
+        return;
+    }
+
+    // process up to batch_size_ ready token sets in one dispatch, but yield to the other tasks of the
+    // thread group after the time slice is used up
+    batching_ = true;
+    auto end_of_slice = std::chrono::steady_clock::now() + batch_time_slice_;
+    for (int i = 0; i < batch_size_; ++i) {
+        if (!processOnce() || worker_->isProcessing() || !worker_->canExecute()) {
+            break;
+        }
+        if (std::chrono::steady_clock::now() >= end_of_slice) {
+            break;
+        }
+    }
+    batching_ = false;
+
+    if (batch_pending_.exchange(false)) {
+        scheduleProcess();
+    }
+}
+
+bool NodeRunner::processOnce()
+{
+    if (stepping_ && possible_steps_ <= 0) {
+        return false;
+    }
+
     apex_assert_hard(guard_ == -1);
     if (worker_->canExecute()) {
         if (max_frequency_ > 0.0) {
@@ -212,9 +331,11 @@ void NodeRunner::execute()
                 auto now = std::chrono::system_clock::now();
 
                 if (next_process > now) {
+                    // the next period starts when the task is released
+                    updateDeadline(std::chrono::steady_clock::now() + (next_process - now));
                     scheduleDelayed(execute_, next_process);
                     waiting_for_execution_ = true;
-                    return;
+                    return false;
                 }
             }
         }
@@ -231,9 +352,10 @@ void NodeRunner::execute()
 
         try {
             if (worker_->canExecute()) {
-                if (!worker_->startProcessingMessages()) {
-                    possible_steps_++;
+                if (worker_->startProcessingMessages()) {
+                    return true;
                 }
+                possible_steps_++;
             }
         } catch (const std::exception& e) {
             if (!suppress_exceptions_)
@@ -261,10 +383,23 @@ void NodeRunner::execute()
         //can_step_++;
         waiting_for_execution_ = false;
     }
+
+    return false;
 }
 
 void NodeRunner::schedule(TaskPtr task)
 {
+    if (current_fused_dispatch && current_fused_dispatch->scheduler == scheduler_ && scheduler_ && isFused()) {
+        // every node is executed at most once per fused dispatch, so that the chain cannot starve the other tasks
+        bool may_run_inline = task != execute_ || current_fused_dispatch->executed.insert(this).second;
+        if (may_run_inline) {
+            if (task->markScheduled()) {
+                current_fused_dispatch->pending.push_back(task);
+            }
+            return;
+        }
+    }
+
     std::unique_lock<std::recursive_mutex> lock(mutex_);
     remaining_tasks_.push_back(task);
 
@@ -284,13 +419,17 @@ void NodeRunner::scheduleDelayed(TaskPtr task, std::chrono::system_clock::time_p
 
 void NodeRunner::detach()
 {
-    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
 
-    if (scheduler_) {
-        auto t = scheduler_->remove(this);
-        remaining_tasks_.insert(remaining_tasks_.end(), t.begin(), t.end());
-        scheduler_ = nullptr;
+        if (scheduler_) {
+            auto t = scheduler_->remove(this);
+            remaining_tasks_.insert(remaining_tasks_.end(), t.begin(), t.end());
+            scheduler_ = nullptr;
+        }
     }
+
+    worker_->setScheduler(nullptr);
 }
 
 bool NodeRunner::isPaused() const
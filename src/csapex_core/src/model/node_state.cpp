@@ -9,6 +9,7 @@
 #include <csapex/serialization/io/std_io.h>
 
 /// SYSTEM
+#include <algorithm>
 #include <iostream>
 
 using namespace csapex;
@@ -18,6 +19,10 @@ NodeState::NodeState(const NodeHandle* parent)
   ,
 
   max_frequency_(0.0)
+  , deadline_(0.0)
+  , batch_size_(1)
+  , replicas_(1)
+  , credits_(0)
   , z_(0)
   , minimized_(false)
   , muted_(false)
@@ -57,6 +62,10 @@ NodeState& NodeState::operator=(const NodeState& rhs)
 {
     // first change all values
     max_frequency_ = rhs.max_frequency_;
+    deadline_ = rhs.deadline_;
+    batch_size_ = rhs.batch_size_;
+    replicas_ = rhs.replicas_;
+    credits_ = rhs.credits_;
     pos_ = rhs.pos_;
     enabled_ = rhs.enabled_;
     active_ = rhs.active_;
@@ -80,6 +89,10 @@ NodeState& NodeState::operator=(const NodeState& rhs)
 
     // then trigger the signals
     (max_frequency_changed)();
+    (deadline_changed)();
+    (batch_size_changed)();
+    (replicas_changed)();
+    (credits_changed)();
     (pos_changed)();
     (enabled_changed)();
     (active_changed)();
@@ -110,6 +123,61 @@ double NodeState::getMaximumFrequency() const
     return max_frequency_;
 }
 
+void NodeState::setDeadline(double seconds)
+{
+    if (deadline_ != seconds) {
+        deadline_ = seconds;
+        (deadline_changed)();
+    }
+}
+
+double NodeState::getDeadline() const
+{
+    return deadline_;
+}
+
+void NodeState::setBatchSize(int size)
+{
+    size = std::max(1, size);
+    if (batch_size_ != size) {
+        batch_size_ = size;
+        (batch_size_changed)();
+    }
+}
+
+int NodeState::getBatchSize() const
+{
+    return batch_size_;
+}
+
+void NodeState::setReplicas(int replicas)
+{
+    replicas = std::max(1, replicas);
+    if (replicas_ != replicas) {
+        replicas_ = replicas;
+        (replicas_changed)();
+    }
+}
+
+int NodeState::getReplicas() const
+{
+    return replicas_;
+}
+
+void NodeState::setCredits(int credits)
+{
+    credits = std::max(0, credits);
+    if (credits_ != credits) {
+        credits_ = credits;
+        (credits_changed)();
+    }
+}
+
+int NodeState::getCredits() const
+{
+    return credits_;
+}
+
 Point NodeState::getPos() const
 {
     return pos_;
@@ -320,6 +388,10 @@ void NodeState::writeYaml(YAML::Node& out) const
         out["uuid"] = parent_->getUUID().getFullName();
     }
     out["max_frequency"] = max_frequency_;
+    out["deadline"] = deadline_;
+    out["batch_size"] = batch_size_;
+    out["replicas"] = replicas_;
+    out["credits"] = credits_;
     out["label"] = label_;
     out["pos"][0] = pos_.x;
     out["pos"][1] = pos_.y;
@@ -378,6 +450,18 @@ void NodeState::readYaml(const YAML::Node& node)
     if (node["max_frequency"].IsDefined()) {
         setMaximumFrequency(node["max_frequency"].as<double>());
     }
+    if (node["deadline"].IsDefined()) {
+        setDeadline(node["deadline"].as<double>());
+    }
+    if (node["batch_size"].IsDefined()) {
+        setBatchSize(node["batch_size"].as<int>());
+    }
+    if (node["replicas"].IsDefined()) {
+        setReplicas(node["replicas"].as<int>());
+    }
+    if (node["credits"].IsDefined()) {
+        setCredits(node["credits"].as<int>());
+    }
 
     if (node["minimized"].IsDefined()) {
         setMinimized(node["minimized"].as<bool>());
@@ -469,6 +553,10 @@ void NodeState::readYaml(const YAML::Node& node)
 void NodeState::serialize(SerializationBuffer& data, SemanticVersion& version) const
 {
     data << max_frequency_;
+    data << deadline_;
+    data << batch_size_;
+    data << replicas_;
+    data << credits_;
 
     data << label_;
     data << pos_.x << pos_.y;
@@ -502,6 +590,10 @@ void NodeState::serialize(SerializationBuffer& data, SemanticVersion& version) c
 void NodeState::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
 {
     data >> max_frequency_;
+    data >> deadline_;
+    data >> batch_size_;
+    data >> replicas_;
+    data >> credits_;
 
     data >> label_;
     data >> pos_.x >> pos_.y;
@@ -3,12 +3,14 @@
 
 /// COMPONENT
 #include <csapex/factory/node_factory_impl.h>
+#include <csapex/model/connection.h>
 #include <csapex/model/generic_state.h>
 #include <csapex/model/graph/vertex.h>
 #include <csapex/model/node.h>
 #include <csapex/model/node_handle.h>
 #include <csapex/model/node_modifier.h>
 #include <csapex/model/node_modifier.h>
+#include <csapex/model/node_replicas.h>
 #include <csapex/model/node_state.h>
 #include <csapex/model/subgraph_node.h>
 #include <csapex/msg/any_message.h>
@@ -49,6 +51,8 @@ NodeWorker::NodeWorker(NodeHandlePtr node_handle)
   , trigger_deactivated_(nullptr)
   , slot_enable_(nullptr)
   , slot_disable_(nullptr)
+  , scheduler_(nullptr)
+  , replicas_outdated_(true)
   , guard_(-1)
 {
     //    node_handle->setNodeWorker(this);
@@ -139,6 +143,11 @@ NodeWorker::NodeWorker(NodeHandlePtr node_handle)
         enabled(e);
     });
 
+    observe(node_handle_->getNodeState()->replicas_changed, [this]() {
+        replicas_outdated_ = true;
+        triggerTryProcess();
+    });
+
     NodePtr node = node_handle_->getNode().lock();
 
     observe(node->getParameterState()->parameter_changed, [this](param::Parameter* p) { triggerTryProcess(); });
@@ -149,6 +158,8 @@ NodeWorker::~NodeWorker()
 {
     stopObserving();
 
+    resetReplicas();
+
     std::unique_lock<std::recursive_mutex> lock(sync);
 
     destroyed();
@@ -221,6 +232,11 @@ bool NodeWorker::isProcessing() const
     return is_processing_;
 }
 
+bool NodeWorker::isReplicated() const
+{
+    return getReplicas() != nullptr;
+}
+
 bool NodeWorker::isProcessingEnabled() const
 {
     return node_handle_->getNodeState()->isEnabled();
@@ -239,6 +255,19 @@ bool NodeWorker::canProcess() const
     if (!hasNode()) {
         return false;
     }
+    if (!node_handle_->hasCredits()) {
+        // the downstream sinks have not processed enough of the previous token sets
+        return false;
+    }
+    if (std::shared_ptr<NodeReplicas> replicas = getReplicas()) {
+        if (!replicas->canDispatch()) {
+            return false;
+        }
+        if (replicas->getPendingCount() > 0 && (replicas_outdated_ || !isProcessingEnabled() || hasIncomingMarker())) {
+            // token sets that are not processed by a replica would overtake the pending ones
+            return false;
+        }
+    }
     NodePtr node = getNode();
     if (!node->canProcess()) {
         return false;
@@ -249,20 +278,7 @@ bool NodeWorker::canProcess() const
 
 bool NodeWorker::canReceive() const
 {
-    for (const InputPtr& i : node_handle_->getExternalInputs()) {
-        if (i->isOptional()) {
-            // optional -> do nothing
-        } else {
-            if (!i->isConnected()) {
-                // !optional, !connected
-                return false;
-            } else if (!i->hasEnabledConnection()) {
-                // !optional, connected, !enabled
-                return false;
-            }
-        }
-    }
-    return true;
+    return node_handle_->areRequiredInputsConnected();
 }
 
 bool NodeWorker::canSend() const
@@ -316,6 +332,9 @@ void NodeWorker::reset()
 
     setProcessing(false);
 
+    resetReplicas();
+    replicas_outdated_ = true;
+
     node_handle_->getOutputTransition()->reset();
     node_handle_->getInputTransition()->reset();
 
@@ -509,6 +528,136 @@ void NodeWorker::rememberExecutionMode()
     apex_assert_hard(current_exec_mode_);
 }
 
+void NodeWorker::setScheduler(Scheduler* scheduler)
+{
+    std::unique_lock<std::mutex> lock(replicas_mutex_);
+    scheduler_ = scheduler;
+    if (replicas_) {
+        replicas_->assignToScheduler(scheduler);
+    }
+}
+
+std::shared_ptr<NodeReplicas> NodeWorker::getReplicas() const
+{
+    std::unique_lock<std::mutex> lock(replicas_mutex_);
+    return replicas_;
+}
+
+void NodeWorker::resetReplicas()
+{
+    std::shared_ptr<NodeReplicas> replicas;
+    {
+        std::unique_lock<std::mutex> lock(replicas_mutex_);
+        // replicas that are still finishing must not request any more executions
+        replica_results_connection_.disconnect();
+        replicas.swap(replicas_);
+    }
+    // the running replica tasks are awaited by whoever releases the last reference, outside of the lock
+    replicas.reset();
+}
+
+void NodeWorker::updateReplicas()
+{
+    replicas_outdated_ = false;
+
+    NodePtr node = node_handle_->getNode().lock();
+    graph::VertexPtr vertex = node_handle_->getVertex();
+    bool replicable = node && vertex && vertex->getNodeCharacteristics().is_replicable && !node->isAsynchronous();
+
+    int count = node_handle_->getNodeState()->getReplicas();
+    if (!replicable || count <= 1) {
+        resetReplicas();
+        return;
+    }
+    std::shared_ptr<NodeReplicas> current = getReplicas();
+    if (current && current->getCount() == count) {
+        return;
+    }
+
+    resetReplicas();
+
+    Scheduler* scheduler;
+    {
+        std::unique_lock<std::mutex> lock(replicas_mutex_);
+        scheduler = scheduler_;
+    }
+    std::shared_ptr<NodeReplicas> replicas = std::make_shared<NodeReplicas>(node_handle_, count, scheduler);
+    if (replicas->getCount() > 1) {
+        std::unique_lock<std::mutex> lock(replicas_mutex_);
+        if (scheduler_ != scheduler) {
+            // the node has been moved to another thread group in the meantime
+            replicas->assignToScheduler(scheduler_);
+        }
+        replica_results_connection_ = replicas->result_available.connect([this]() { node_handle_->execution_requested([this]() { sendReplicaResults(); }); });
+        replicas_ = replicas;
+    }
+}
+
+void NodeWorker::dispatchToReplica(NodeReplicas& replicas)
+{
+    replicas.dispatch();
+
+    stopActiveProfilerInterval();
+
+    {
+        // like a pipelining node, the inputs are released right away. The outputs are sent once the replica is done.
+        std::unique_lock<std::recursive_mutex> lock(current_exec_mode_mutex_);
+        current_exec_mode_ = ExecutionMode::PIPELINING;
+    }
+
+    signalMessagesProcessed(false);
+
+    triggerTryProcess();
+}
+
+void NodeWorker::sendReplicaResults()
+{
+    std::shared_ptr<NodeReplicas> replicas = getReplicas();
+    if (!replicas) {
+        return;
+    }
+
+    NodeReplicas::Result result;
+    while (node_handle_->getOutputTransition()->canStartSendingMessages() && replicas->takeNextResult(result)) {
+        // errors are reported like the ones of the node itself, see processNode
+        if (result.failure) {
+            std::rethrow_exception(result.failure);
+        }
+        if (!result.error.empty()) {
+            setError(true, result.error);
+        }
+
+        for (const auto& pair : result.outputs) {
+            pair.first->addMessage(pair.second);
+        }
+
+        bool active = node_handle_->isActive();
+        bool has_sent_activator_message = node_handle_->getOutputTransition()->sendMessages(active, result.origins);
+        if (active && has_sent_activator_message) {
+            node_handle_->setActive(false);
+        }
+
+        if (trigger_process_done_->isConnected()) {
+            msg::trigger(trigger_process_done_);
+        }
+    }
+
+    triggerTryProcess();
+}
+
+bool NodeWorker::hasIncomingMarker() const
+{
+    for (const InputPtr& input : node_handle_->getExternalInputs()) {
+        for (const ConnectionPtr& c : input->getConnections()) {
+            TokenPtr token = c->getToken();
+            if (token && std::dynamic_pointer_cast<connection_types::MarkerMessage const>(token->getTokenData())) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void NodeWorker::startProfilerInterval(TracingType type)
 {
     if (profiler_->isEnabled()) {
@@ -581,6 +730,13 @@ bool NodeWorker::startProcessingMessages()
         handleChangedParameters();
     }
 
+    if (replicas_outdated_) {
+        std::shared_ptr<NodeReplicas> replicas = getReplicas();
+        if (!replicas || replicas->getPendingCount() == 0) {
+            updateReplicas();
+        }
+    }
+
     {
         std::unique_lock<std::recursive_mutex> lock(sync);
         apex_assert_hard(isEnabled());
@@ -600,6 +756,10 @@ bool NodeWorker::startProcessingMessages()
 
         setProcessing(true);
 
+        node_handle_->takeCredits();
+
+        current_token_origins_ = collectTokenOrigins();
+
         updateParameterValues();
     }
 
@@ -643,8 +803,15 @@ bool NodeWorker::startProcessingMessages()
 
         startProfilerInterval(TracingType::PROCESS);
 
-        // actually call the process function
-        processNode();
+        recordTokenLatencies();
+
+        if (std::shared_ptr<NodeReplicas> replicas = getReplicas()) {
+            // a copy of the node processes the messages concurrently, markers have been handled above
+            dispatchToReplica(*replicas);
+        } else {
+            // actually call the process function
+            processNode();
+        }
         return true;
     }
 }
@@ -655,6 +822,42 @@ bool NodeWorker::startProcessingSlot(const SlotWeakPtr& slot)
     return true;
 }
 
+Token::OriginsPtr NodeWorker::collectTokenOrigins() const
+{
+    std::vector<Token::OriginsPtr> origins;
+    for (const InputPtr& input : node_handle_->getExternalInputs()) {
+        if (TokenPtr token = input->getToken()) {
+            origins.push_back(token->getOrigins());
+        }
+    }
+    return Token::mergeOrigins(origins);
+}
+
+Token::OriginsPtr NodeWorker::getOutgoingTokenOrigins() const
+{
+    if (node_handle_->isSource()) {
+        // the token set enters the graph here
+        auto origins = std::make_shared<std::vector<Token::Origin>>();
+        origins->push_back(Token::Origin{ node_handle_->getUUID().getFullName(), std::chrono::steady_clock::now() });
+        return origins;
+    }
+    return current_token_origins_;
+}
+
+void NodeWorker::recordTokenLatencies()
+{
+    if (!current_token_origins_ || !profiler_->isEnabled() || !node_handle_->isSink()) {
+        return;
+    }
+
+    using microseconds = std::chrono::duration<double, std::micro>;
+    auto now = std::chrono::steady_clock::now();
+    std::string key = node_handle_->getUUID().getFullName();
+    for (const Token::Origin& origin : *current_token_origins_) {
+        profiler_->addLatency(key, origin.source, std::chrono::duration_cast<microseconds>(now - origin.stamp).count());
+    }
+}
+
 void NodeWorker::pruneExecution()
 {
     signalMessagesProcessed(true);
@@ -724,7 +927,7 @@ void NodeWorker::forwardMessages()
 
     lock.unlock();
     // TRACE getNode()->ainfo << "send messages" << std::endl;
-    bool has_sent_activator_message = node_handle_->getOutputTransition()->sendMessages(active);
+    bool has_sent_activator_message = node_handle_->getOutputTransition()->sendMessages(active, getOutgoingTokenOrigins());
     lock.lock();
 
     sendEvents(active);
@@ -771,6 +974,10 @@ void NodeWorker::notifyMessagesProcessedDownstream()
         // TRACE APEX_DEBUG_TRACE getNode()->aerr << "cannot notify, no current exec mode" << std::endl;
     }
 
+    if (isReplicated()) {
+        sendReplicaResults();
+    }
+
     triggerTryProcess();
 }
 
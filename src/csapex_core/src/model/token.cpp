@@ -1,14 +1,32 @@
 /// HEADER
 #include <csapex/model/token.h>
 
+/// PROJECT
+#include <csapex/model/token_data.h>
+#include <csapex/msg/no_message.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <thread>
+
 using namespace csapex;
 
-Token::Token(const TokenDataConstPtr& token) : data_(token), activity_modifier_(ActivityModifier::NONE), seq_no_(-1)
+Token::Token(const TokenDataConstPtr& token) : data_(token), data_owned_(false), retained_(false), retained_claims_(0), activity_modifier_(ActivityModifier::NONE), seq_no_(-1)
+{
+}
+
+Token::Token() : data_owned_(false), retained_(false), retained_claims_(0), activity_modifier_(ActivityModifier::NONE), seq_no_(-1)
 {
 }
 
-Token::Token() : activity_modifier_(ActivityModifier::NONE), seq_no_(-1)
+Token::Token(const Token& other) : Token()
 {
+    cloneData(other);
+}
+
+Token::~Token()
+{
+    releaseTokenData();
 }
 
 void Token::setActivityModifier(ActivityModifier active)
@@ -31,6 +49,90 @@ TokenDataConstPtr Token::getTokenData() const
     return data_;
 }
 
+TokenDataPtr Token::getMutableTokenData()
+{
+    if (!data_) {
+        return nullptr;
+    }
+    if (!data_owned_ && !claimTokenData()) {
+        TokenDataConstPtr copy = data_->cloneAs<TokenData>();
+        releaseTokenData();
+        data_ = copy;
+    }
+    data_owned_ = true;
+    // the payload has been created mutable and nobody else can observe it anymore
+    return std::const_pointer_cast<TokenData>(data_);
+}
+
+bool Token::isTokenDataShared() const
+{
+    return !data_owned_ && data_ && (retained_ || data_.use_count() > 1 + data_->retaining_tokens_.load());
+}
+
+void Token::markAsRetained()
+{
+    if (retained_ || !data_) {
+        return;
+    }
+    retained_ = true;
+    retained_claims_ = data_->claims_.load();
+    ++data_->retaining_tokens_;
+}
+
+bool Token::isRetained() const
+{
+    return retained_;
+}
+
+bool Token::claimTokenData() const
+{
+    if (retained_) {
+        return false;
+    }
+
+    // the claim is announced before looking for republishers: a concurrent republisher either sees it and waits for
+    // the decision, or is seen by it and makes the claim fail
+    ++data_->pending_claims_;
+    bool claimed = data_->republishing_tokens_.load() == 0 && data_.use_count() == 1 + data_->retaining_tokens_.load();
+    if (claimed) {
+        ++data_->claims_;
+    }
+    --data_->pending_claims_;
+    return claimed;
+}
+
+TokenDataConstPtr Token::shareTokenData() const
+{
+    if (!retained_) {
+        return data_;
+    }
+
+    TokenDataConstPtr shared;
+    ++data_->republishing_tokens_;
+    // a claim that is in progress may have missed this republisher, so wait until it is decided
+    while (data_->pending_claims_.load() > 0) {
+        std::this_thread::yield();
+    }
+    if (data_->claims_.load() == retained_claims_) {
+        shared = data_;
+    } else {
+        // a consumer is modifying the payload, handing it out again would be a race
+        shared = std::make_shared<connection_types::NoMessage>();
+    }
+    --data_->republishing_tokens_;
+    return shared;
+}
+
+void Token::releaseTokenData()
+{
+    if (retained_) {
+        --data_->retaining_tokens_;
+        retained_ = false;
+    }
+    data_.reset();
+    data_owned_ = false;
+}
+
 int Token::getSequenceNumber() const
 {
     return seq_no_;
@@ -41,11 +143,62 @@ void Token::setSequenceNumber(int seq_no) const
     seq_no_ = seq_no;
 }
 
+Token::OriginsPtr Token::getOrigins() const
+{
+    return origins_;
+}
+
+void Token::setOrigins(const OriginsPtr& origins)
+{
+    origins_ = origins;
+}
+
+Token::OriginsPtr Token::mergeOrigins(const std::vector<OriginsPtr>& origins)
+{
+    OriginsPtr first;
+    bool differ = false;
+    for (const OriginsPtr& o : origins) {
+        if (!o) {
+            continue;
+        }
+        if (!first) {
+            first = o;
+        } else if (o != first) {
+            differ = true;
+        }
+    }
+
+    if (!differ) {
+        // the common case of a single input does not need to allocate
+        return first;
+    }
+
+    auto merged = std::make_shared<std::vector<Origin>>(*first);
+    for (const OriginsPtr& o : origins) {
+        if (!o || o == first) {
+            continue;
+        }
+        for (const Origin& origin : *o) {
+            auto pos = std::find_if(merged->begin(), merged->end(), [&origin](const Origin& existing) { return existing.source == origin.source; });
+            if (pos == merged->end()) {
+                merged->push_back(origin);
+            } else {
+                pos->stamp = std::min(pos->stamp, origin.stamp);
+            }
+        }
+    }
+    return merged;
+}
+
 bool Token::cloneData(const Token& other)
 {
-    data_ = other.data_->cloneAs<TokenData>();
+    TokenDataConstPtr data = other.shareTokenData();
+    releaseTokenData();
+    data_ = data;
+    other.data_owned_ = false;
     activity_modifier_ = other.activity_modifier_;
     seq_no_ = other.seq_no_;
+    origins_ = other.origins_;
 
     return true;
 }
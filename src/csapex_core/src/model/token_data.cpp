@@ -3,6 +3,7 @@
 
 /// COMPONENT
 #include <csapex/msg/message.h>
+#include <csapex/msg/message_type_registry.h>
 #include <csapex/msg/token_traits.h>
 #include <csapex/utility/assert.h>
 #include <csapex/serialization/io/std_io.h>
@@ -12,16 +13,25 @@
 
 using namespace csapex;
 
-TokenData::TokenData()
+TokenData::TokenData() : type_id_(SymbolTable::EMPTY), descriptive_name_id_(SymbolTable::EMPTY), dynamic_type_id_(MessageTypeRegistry::UNKNOWN), retaining_tokens_(0), republishing_tokens_(0), claims_(0), pending_claims_(0)
 {
 }
 
-TokenData::TokenData(const std::string& type_name) : type_name_(type_name)
+TokenData::TokenData(const std::string& type_name) : TokenData(SymbolTable::intern(type_name))
 {
-    setDescriptiveName(type_name);
 }
 
-TokenData::TokenData(const std::string& type_name, const std::string& descriptive_name) : type_name_(type_name), descriptive_name_(descriptive_name)
+TokenData::TokenData(const std::string& type_name, const std::string& descriptive_name)
+  : type_id_(SymbolTable::intern(type_name)), descriptive_name_id_(SymbolTable::intern(descriptive_name)), dynamic_type_id_(MessageTypeRegistry::UNKNOWN), retaining_tokens_(0), republishing_tokens_(0), claims_(0), pending_claims_(0)
+{
+}
+
+TokenData::TokenData(SymbolTable::Id type_id) : type_id_(type_id), descriptive_name_id_(type_id), dynamic_type_id_(MessageTypeRegistry::UNKNOWN), retaining_tokens_(0), republishing_tokens_(0), claims_(0), pending_claims_(0)
+{
+}
+
+TokenData::TokenData(const TokenData& other)
+  : Streamable(other), type_id_(other.type_id_), descriptive_name_id_(other.descriptive_name_id_), dynamic_type_id_(MessageTypeRegistry::UNKNOWN), retaining_tokens_(0), republishing_tokens_(0), claims_(0), pending_claims_(0)
 {
 }
 
@@ -29,9 +39,29 @@ TokenData::~TokenData()
 {
 }
 
+TokenData& TokenData::operator=(const TokenData& other)
+{
+    // the dynamic type of this object does not change by assigning another one to it
+    type_id_ = other.type_id_;
+    descriptive_name_id_ = other.descriptive_name_id_;
+    return *this;
+}
+
+TokenData::TypeId TokenData::lookupDynamicTypeId() const
+{
+    TypeId id = MessageTypeRegistry::getDynamicId(*this);
+    dynamic_type_id_.store(id, std::memory_order_relaxed);
+    return id;
+}
+
 void TokenData::setDescriptiveName(const std::string& name)
 {
-    descriptive_name_ = name;
+    descriptive_name_id_ = SymbolTable::intern(name);
+}
+
+void TokenData::setDescriptiveName(SymbolTable::Id descriptive_name_id)
+{
+    descriptive_name_id_ = descriptive_name_id;
 }
 
 bool TokenData::canConnectTo(const TokenData* other_side) const
@@ -41,28 +71,44 @@ bool TokenData::canConnectTo(const TokenData* other_side) const
 
 bool TokenData::acceptsConnectionFrom(const TokenData* other_side) const
 {
-    return type_name_ == other_side->typeName();
+    return type_id_ == other_side->typeId();
 }
 
 std::string TokenData::descriptiveName() const
 {
-    return descriptive_name_;
+    return SymbolTable::lookup(descriptive_name_id_);
+}
+
+const std::string& TokenData::typeName() const
+{
+    return SymbolTable::lookup(type_id_);
 }
 
-std::string TokenData::typeName() const
+SymbolTable::Id TokenData::typeId() const
 {
-    return type_name_;
+    return type_id_;
 }
 
 void TokenData::serialize(SerializationBuffer& data, SemanticVersion& version) const
 {
-    data << type_name_;
-    data << descriptive_name_;
+    // ids are only valid in this process, so the names are transmitted
+    data << SymbolTable::lookup(type_id_);
+    data << SymbolTable::lookup(descriptive_name_id_);
 }
 void TokenData::deserialize(const SerializationBuffer& data, const SemanticVersion& version)
 {
-    data >> type_name_;
-    data >> descriptive_name_;
+    std::string type_name;
+    std::string descriptive_name;
+    data >> type_name;
+    data >> descriptive_name;
+
+    // the names of every message type in this process are known, received names are not interned
+    if (!SymbolTable::find(type_name, type_id_)) {
+        throw std::runtime_error(std::string("cannot deserialize, unknown type name: ") + type_name);
+    }
+    if (!SymbolTable::find(descriptive_name, descriptive_name_id_)) {
+        throw std::runtime_error(std::string("cannot deserialize, unknown descriptive name: ") + descriptive_name);
+    }
 }
 
 TokenData::Ptr TokenData::toType() const
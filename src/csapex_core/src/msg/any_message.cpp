@@ -9,7 +9,7 @@ CSAPEX_REGISTER_MESSAGE(csapex::connection_types::AnyMessage)
 using namespace csapex;
 using namespace connection_types;
 
-AnyMessage::AnyMessage() : Message(type<AnyMessage>::name(), "/", 0)
+AnyMessage::AnyMessage() : Message(serializationSymbol<AnyMessage>(), "/", 0)
 {
 }
 
@@ -12,11 +12,20 @@ CSAPEX_REGISTER_MESSAGE_WITH_NAME(csapex::connection_types::GenericVectorMessage
 using namespace csapex;
 using namespace connection_types;
 
-GenericVectorMessage::GenericVectorMessage(EntryInterface::Ptr pimpl, const std::string& frame_id, Message::Stamp stamp) : Message(type<GenericVectorMessage>::name(), frame_id, stamp), pimpl(pimpl)
+namespace
+{
+SymbolTable::Id anythingSymbol()
+{
+    static const SymbolTable::Id id = SymbolTable::intern("Anything");
+    return id;
+}
+}  // namespace
+
+GenericVectorMessage::GenericVectorMessage(EntryInterface::Ptr pimpl, const std::string& frame_id, Message::Stamp stamp) : Message(serializationSymbol<GenericVectorMessage>(), frame_id, stamp), pimpl(pimpl)
 {
 }
 
-GenericVectorMessage::GenericVectorMessage() : Message(type<GenericVectorMessage>::name(), "/", 0), pimpl(std::make_shared<InstancedImplementation>(std::make_shared<AnyMessage>()))
+GenericVectorMessage::GenericVectorMessage() : Message(serializationSymbol<GenericVectorMessage>(), "/", 0), pimpl(std::make_shared<InstancedImplementation>(std::make_shared<AnyMessage>()))
 {
 }
 
@@ -37,7 +46,7 @@ std::string GenericVectorMessage::descriptiveName() const
 
 /// ANYTHING
 
-GenericVectorMessage::AnythingImplementation::AnythingImplementation() : EntryInterface("Anything")
+GenericVectorMessage::AnythingImplementation::AnythingImplementation() : EntryInterface(anythingSymbol())
 {
 }
 
@@ -50,9 +59,9 @@ void GenericVectorMessage::AnythingImplementation::decode(const YAML::Node& node
 
 bool GenericVectorMessage::AnythingImplementation::canConnectTo(const TokenData* other_side) const
 {
-    if (dynamic_cast<const EntryInterface*>(other_side)) {
+    if (MessageTypeRegistry::cast<EntryInterface>(other_side)) {
         return true;
-    } else if (dynamic_cast<const GenericVectorMessage*>(other_side)) {
+    } else if (MessageTypeRegistry::cast<GenericVectorMessage>(other_side)) {
         return true;
     } else {
         auto type = toType();
@@ -62,9 +71,9 @@ bool GenericVectorMessage::AnythingImplementation::canConnectTo(const TokenData*
 
 bool GenericVectorMessage::AnythingImplementation::acceptsConnectionFrom(const TokenData* other_side) const
 {
-    if (dynamic_cast<const EntryInterface*>(other_side)) {
+    if (MessageTypeRegistry::cast<EntryInterface>(other_side)) {
         return true;
-    } else if (dynamic_cast<const GenericVectorMessage*>(other_side)) {
+    } else if (MessageTypeRegistry::cast<GenericVectorMessage>(other_side)) {
         return true;
     } else {
         return dynamic_cast<const AnyMessage*>(other_side) != nullptr;
@@ -82,12 +91,12 @@ void GenericVectorMessage::AnythingImplementation::deserialize(const Serializati
 
 // INSTANCED
 
-GenericVectorMessage::InstancedImplementation::InstancedImplementation(TokenData::ConstPtr type) : EntryInterface("Anything"), type_(type)
+GenericVectorMessage::InstancedImplementation::InstancedImplementation(TokenData::ConstPtr type) : EntryInterface(anythingSymbol()), type_(type)
 {
     apex_assert_hard(type_);
 }
 
-GenericVectorMessage::InstancedImplementation::InstancedImplementation() : EntryInterface("Anything"), type_(new AnyMessage)
+GenericVectorMessage::InstancedImplementation::InstancedImplementation() : EntryInterface(anythingSymbol()), type_(new AnyMessage)
 {
     apex_assert_hard(type_);
 }
@@ -104,10 +113,10 @@ bool GenericVectorMessage::InstancedImplementation::cloneData(const GenericVecto
 
 bool GenericVectorMessage::InstancedImplementation::canConnectTo(const TokenData* other_side) const
 {
-    if (const EntryInterface* ei = dynamic_cast<const EntryInterface*>(other_side)) {
+    if (const EntryInterface* ei = MessageTypeRegistry::cast<EntryInterface>(other_side)) {
         return nestedType()->canConnectTo(ei->nestedType().get());
     } else {
-        const GenericVectorMessage* vec = dynamic_cast<const GenericVectorMessage*>(other_side);
+        const GenericVectorMessage* vec = MessageTypeRegistry::cast<GenericVectorMessage>(other_side);
         if (vec != 0) {
             return vec->canConnectTo(this);
         } else {
@@ -120,7 +129,7 @@ bool GenericVectorMessage::InstancedImplementation::canConnectTo(const TokenData
 
 bool GenericVectorMessage::InstancedImplementation::acceptsConnectionFrom(const TokenData* other_side) const
 {
-    if (const EntryInterface* ei = dynamic_cast<const EntryInterface*>(other_side)) {
+    if (const EntryInterface* ei = MessageTypeRegistry::cast<EntryInterface>(other_side)) {
         return nestedType()->canConnectTo(ei->nestedType().get());
     } else {
         return false;
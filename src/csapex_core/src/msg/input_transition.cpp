@@ -15,11 +15,11 @@
 
 using namespace csapex;
 
-InputTransition::InputTransition(delegate::Delegate0<> activation_fn) : Transition(activation_fn), forwarded_(false), processed_(false)
+InputTransition::InputTransition(delegate::Delegate0<> activation_fn) : Transition(activation_fn), forwarded_(false), processed_(false), pipelining_(false)
 {
 }
 
-InputTransition::InputTransition() : Transition(), forwarded_(false), processed_(false)
+InputTransition::InputTransition() : Transition(), forwarded_(false), processed_(false), pipelining_(false)
 {
 }
 
@@ -100,10 +100,27 @@ void InputTransition::reset()
     Transition::reset();
 }
 
+void InputTransition::setPipelining(bool pipelining)
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    pipelining_ = pipelining;
+    for (const ConnectionPtr& connection : connections_) {
+        connection->setPipelining(pipelining);
+    }
+}
+
+bool InputTransition::isPipelining() const
+{
+    std::unique_lock<std::recursive_mutex> lock(sync);
+    return pipelining_;
+}
+
 void InputTransition::connectionAdded(Connection* connection)
 {
     Transition::connectionAdded(connection);
 
+    connection->setPipelining(isPipelining());
+
     bool read = isOneConnection(Connection::State::READ);
     bool unread = isOneConnection(Connection::State::UNREAD);
 
@@ -148,11 +165,9 @@ bool InputTransition::isEnabled() const
     }
 
     // TODO: is this necessary?
-    for (const ConnectionPtr& connection : connections_) {
-        if (connection->isEnabled() && connection->getState() == Connection::State::NOT_INITIALIZED) {
-            APEX_DEBUG_CERR << "not enabled because a connection is not initialized" << std::endl;
-            return false;
-        }
+    if (isOneConnection(Connection::State::NOT_INITIALIZED)) {
+        APEX_DEBUG_CERR << "not enabled because a connection is not initialized" << std::endl;
+        return false;
     }
 
     // if(!areAllConnections(Connection::State::READ)) {
@@ -264,7 +279,8 @@ void InputTransition::forwardMessages()
                 ConnectionPtr connection = connections.front();
                 auto s = connection->getState();
                 apex_assert_hard(s == Connection::State::READ || s == Connection::State::UNREAD);
-                TokenPtr token = connection->getToken();
+                // reading marks the token as taken, so that a connection keeping only the latest token cannot replace it anymore
+                TokenPtr token = connection->readToken();
                 apex_assert_hard(token != nullptr);
                 input->setToken(token);
             } else {
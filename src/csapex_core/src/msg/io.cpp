@@ -17,6 +17,14 @@ TokenDataConstPtr csapex::msg::getMessage(Input* input)
     return token->getTokenData();
 }
 
+TokenDataPtr csapex::msg::getMutableMessage(Input* input)
+{
+    apex_assert_hard_msg(input->isEnabled(), "you have requested a message from a disabled input");
+    auto token = input->getToken();
+    apex_assert_hard_msg(token, "tried to read from an empty input");
+    return token->getMutableTokenData();
+}
+
 bool csapex::msg::hasMessage(Input* input)
 {
     return input->hasMessage() && input->isEnabled();
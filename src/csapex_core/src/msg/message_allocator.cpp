@@ -3,7 +3,7 @@
 
 using namespace csapex;
 
-MessageAllocator::MessageAllocator() : allocator_(nullptr)
+MessageAllocator::MessageAllocator() : allocator_(nullptr), pooling_(true), pool_capacity_(8), pool_hits_(0), pool_misses_(0)
 {
 }
 
@@ -11,3 +11,59 @@ MessageAllocator::~MessageAllocator()
 {
     delete allocator_;
 }
+
+void MessageAllocator::setPooling(bool pooling)
+{
+    pooling_ = pooling;
+    if (!pooling_) {
+        clearPool();
+    }
+}
+
+bool MessageAllocator::isPooling() const
+{
+    return pooling_;
+}
+
+void MessageAllocator::setPoolCapacity(std::size_t capacity)
+{
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    pool_capacity_ = capacity;
+    for (auto& pair : pools_) {
+        pair.second->setCapacity(capacity);
+    }
+}
+
+std::size_t MessageAllocator::getPoolCapacity() const
+{
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    return pool_capacity_;
+}
+
+std::size_t MessageAllocator::getPoolSize() const
+{
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    std::size_t size = 0;
+    for (const auto& pair : pools_) {
+        size += pair.second->size();
+    }
+    return size;
+}
+
+void MessageAllocator::clearPool()
+{
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    pools_.clear();
+}
+
+std::size_t MessageAllocator::getPoolHits() const
+{
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    return pool_hits_;
+}
+
+std::size_t MessageAllocator::getPoolMisses() const
+{
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    return pool_misses_;
+}
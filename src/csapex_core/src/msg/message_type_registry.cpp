@@ -0,0 +1,132 @@
+/// HEADER
+#include <csapex/msg/message_type_registry.h>
+
+/// PROJECT
+#include <csapex/utility/assert.h>
+
+/// SYSTEM
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+using namespace csapex;
+
+namespace
+{
+// the relations are only cached for this many types, checks involving further types fall back to dynamic_cast
+constexpr std::size_t MAX_TYPES = 1024;
+
+enum Relation : std::uint8_t
+{
+    RELATION_UNKNOWN = 0,
+    RELATION_SUBTYPE,
+    RELATION_UNRELATED
+};
+
+struct Registry
+{
+    Registry() : rows()
+    {
+        // id 0 is reserved for UNKNOWN
+        checks.push_back(nullptr);
+    }
+
+    MessageTypeRegistry::Id assign(const std::type_info& type)
+    {
+        auto pos = ids.find(std::type_index(type));
+        if (pos != ids.end()) {
+            return pos->second;
+        }
+        apex_assert_hard_msg(checks.size() <= std::numeric_limits<MessageTypeRegistry::Id>::max(), "too many message types");
+        MessageTypeRegistry::Id id = static_cast<MessageTypeRegistry::Id>(checks.size());
+        checks.push_back(nullptr);
+        ids.emplace(std::type_index(type), id);
+        return id;
+    }
+
+    std::mutex mutex;
+    std::unordered_map<std::type_index, MessageTypeRegistry::Id> ids;
+    std::vector<MessageTypeRegistry::InstanceCheck> checks;
+
+    // rows[type][target] is the relation of the two types, a row is created when the first token of its type is seen
+    std::atomic<std::atomic<std::uint8_t>*> rows[MAX_TYPES];
+};
+
+Registry& registry()
+{
+    // never destroyed, tokens in static storage might still be checked during shutdown
+    static Registry* registry = new Registry;
+    return *registry;
+}
+}  // namespace
+
+MessageTypeRegistry::Id MessageTypeRegistry::getId(const std::type_info& type)
+{
+    Registry& r = registry();
+    std::unique_lock<std::mutex> lock(r.mutex);
+    return r.assign(type);
+}
+
+MessageTypeRegistry::Id MessageTypeRegistry::getId(const std::type_info& type, InstanceCheck check)
+{
+    Registry& r = registry();
+    std::unique_lock<std::mutex> lock(r.mutex);
+    Id id = r.assign(type);
+    r.checks[id] = check;
+    return id;
+}
+
+std::size_t MessageTypeRegistry::size()
+{
+    Registry& r = registry();
+    std::unique_lock<std::mutex> lock(r.mutex);
+    return r.checks.size() - 1;
+}
+
+MessageTypeRegistry::Id MessageTypeRegistry::getDynamicId(const TokenData& data)
+{
+    Registry& r = registry();
+    std::unique_lock<std::mutex> lock(r.mutex);
+    Id id = r.assign(typeid(data));
+
+    if (id < MAX_TYPES && !r.rows[id].load(std::memory_order_acquire)) {
+        // relate the new type to all known types while we have an instance of it
+        std::atomic<std::uint8_t>* row = new std::atomic<std::uint8_t>[MAX_TYPES];
+        for (std::size_t target = 0; target < MAX_TYPES; ++target) {
+            std::uint8_t relation = RELATION_UNKNOWN;
+            if (target < r.checks.size() && r.checks[target]) {
+                relation = r.checks[target](data) ? RELATION_SUBTYPE : RELATION_UNRELATED;
+            }
+            row[target].store(relation, std::memory_order_relaxed);
+        }
+        r.rows[id].store(row, std::memory_order_release);
+    }
+
+    return id;
+}
+
+bool MessageTypeRegistry::isSubtype(Id type, Id target, const TokenData& data, InstanceCheck check)
+{
+    if (type >= MAX_TYPES || target >= MAX_TYPES) {
+        return check(data);
+    }
+
+    Registry& r = registry();
+    std::atomic<std::uint8_t>* row = r.rows[type].load(std::memory_order_acquire);
+    if (!row) {
+        return check(data);
+    }
+
+    std::uint8_t relation = row[target].load(std::memory_order_relaxed);
+    if (relation == RELATION_UNKNOWN) {
+        // the target type was not known when the row was created, the result is the same for all tokens of this type
+        bool subtype = check(data);
+        row[target].store(subtype ? RELATION_SUBTYPE : RELATION_UNRELATED, std::memory_order_relaxed);
+        return subtype;
+    }
+    return relation == RELATION_SUBTYPE;
+}
@@ -64,7 +64,7 @@ void Output::notifyMessageProcessed()
         processing_lock.unlock();
 
         for (const ConnectionPtr& connection : connections_) {
-            apex_assert_hard(connection->getState() == Connection::State::DONE);
+            apex_assert_hard(connection->getSourceState() == Connection::State::DONE);
         }
         message_processed(shared_from_this());
     } else {
@@ -93,7 +93,7 @@ void Output::notifyMessageProcessed(Connection* connection)
 //     }
 
     for (auto connection : connections_) {
-        if (connection->getState() != Connection::State::DONE) {
+        if (connection->getSourceState() != Connection::State::DONE) {
             // std::cerr << getUUID() << " :::: " << *connection << "-> is not yet done " << std::endl;
             return;
         }
@@ -181,7 +181,7 @@ bool Output::isConnected() const
 bool Output::canReceiveToken() const
 {
     for (const ConnectionPtr& connection : connections_) {
-        if (connection->getState() != Connection::State::NOT_INITIALIZED) {
+        if (connection->getSourceState() != Connection::State::NOT_INITIALIZED) {
             return false;
         }
     }
@@ -191,7 +191,7 @@ bool Output::canReceiveToken() const
 bool Output::canSendMessages() const
 {
     for (const ConnectionPtr& connection : connections_) {
-        if (connection->getState() == Connection::State::NOT_INITIALIZED) {
+        if (connection->getSourceState() == Connection::State::NOT_INITIALIZED) {
             return false;
         }
     }
@@ -222,6 +222,9 @@ void Output::publish()
         }
     }
 
+    // every connection has its own token now, ours is only kept to republish the payload
+    msg->markAsRetained();
+
     for (auto connection : connections_) {
         if (connection->isEnabled()) {
             connection->notifyMessageSet();
@@ -242,6 +245,7 @@ void Output::republish()
         auto msg = getToken();
         apex_assert_hard(msg);
 
+        // the retained token carries a NoMessage instead, if the payload has been claimed by a consumer in the meantime
         for (auto connection : connections_) {
             if (connection->isEnabled() && connection->getState() == Connection::State::DONE) {
                 connection->setToken(msg);
@@ -124,6 +124,12 @@ long OutputTransition::getSequenceNumber() const
     return sequence_number_;
 }
 
+void OutputTransition::observeConnectionState(Connection& connection, ConnectionStateCounter* counter)
+{
+    // buffered connections release the producer before the consumer is done
+    connection.observeSourceState(counter);
+}
+
 bool OutputTransition::isEnabled() const
 {
     return canStartSendingMessages();
@@ -148,7 +154,7 @@ bool OutputTransition::canStartSendingMessages() const
     return areAllConnections(Connection::State::DONE, Connection::State::NOT_INITIALIZED);
 }
 
-bool OutputTransition::sendMessages(bool is_active)
+bool OutputTransition::sendMessages(bool is_active, const Token::OriginsPtr& origins)
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
 
@@ -160,6 +166,9 @@ bool OutputTransition::sendMessages(bool is_active)
         const OutputPtr& output = pair.second;
         if (output->isEnabled()) {
             has_sent_activator_message |= output->commitMessages(is_active);
+            if (origins) {
+                output->getToken()->setOrigins(origins);
+            }
         }
     }
 
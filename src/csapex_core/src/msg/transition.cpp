@@ -5,9 +5,11 @@
 #include <csapex/model/node_handle.h>
 #include <csapex/model/connection.h>
 #include <csapex/model/connectable.h>
+#include <csapex/model/connection_state_counter.h>
 #include <csapex/utility/assert.h>
 
 /// SYSTEM
+#include <algorithm>
 #include <iostream>
 
 using namespace csapex;
@@ -22,6 +24,9 @@ Transition::Transition()
 
 Transition::~Transition()
 {
+    for (const ConnectionPtr& connection : connections_) {
+        connection->stopObservingState(&state_counter_);
+    }
 }
 
 void Transition::setActivationFunction(delegate::Delegate0<> activation_fn)
@@ -32,7 +37,9 @@ void Transition::setActivationFunction(delegate::Delegate0<> activation_fn)
 void Transition::addConnection(ConnectionPtr connection)
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
+    thaw();
     connections_.push_back(connection);
+    observeConnectionState(*connection, &state_counter_);
     lock.unlock();
 
     connectionAdded(connection.get());
@@ -41,8 +48,10 @@ void Transition::addConnection(ConnectionPtr connection)
 void Transition::removeConnection(ConnectionPtr connection)
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
+    thaw();
     for (auto it = connections_.begin(); it != connections_.end(); ++it) {
         if (*it == connection) {
+            connection->stopObservingState(&state_counter_);
             connections_.erase(it);
             break;
         }
@@ -63,61 +72,70 @@ void Transition::checkIfEnabled()
     }
 }
 
-bool Transition::areAllConnections(Connection::State state) const
+void Transition::observeConnectionState(Connection& connection, ConnectionStateCounter* counter)
+{
+    connection.observeSinkState(counter);
+}
+
+void Transition::freeze()
 {
     std::unique_lock<std::recursive_mutex> lock(sync);
+
+    auto snapshot = std::make_shared<std::vector<ConnectionPtr>>();
     for (const ConnectionPtr& connection : connections_) {
-        if (connection->isEnabled() && connection->getState() != state) {
-            return false;
+        if (connection->isEnabled()) {
+            snapshot->push_back(connection);
         }
     }
-    return true;
+
+    std::shared_ptr<const std::vector<ConnectionPtr>> frozen = snapshot;
+    std::atomic_store(&frozen_connections_, frozen);
+}
+
+void Transition::thaw()
+{
+    // readers that still iterate the old snapshot keep it alive, so removed connections are released once they are done
+    std::atomic_store(&frozen_connections_, std::shared_ptr<const std::vector<ConnectionPtr>>());
+}
+
+bool Transition::isFrozen() const
+{
+    return std::atomic_load(&frozen_connections_) != nullptr;
+}
+
+std::shared_ptr<const std::vector<ConnectionPtr>> Transition::getFrozenConnections() const
+{
+    return std::atomic_load(&frozen_connections_);
+}
+
+bool Transition::areAllConnections(Connection::State state) const
+{
+    return state_counter_.areAll(state);
 }
 
 bool Transition::areAllConnections(Connection::State a, Connection::State b) const
 {
-    std::unique_lock<std::recursive_mutex> lock(sync);
-    for (const ConnectionPtr& connection : connections_) {
-        auto s = connection->getState();
-        if (connection->isEnabled() && s != a && s != b) {
-            return false;
-        }
-    }
-    return true;
+    return state_counter_.areAll(a, b);
 }
 
 bool Transition::areAllConnections(Connection::State a, Connection::State b, Connection::State c) const
 {
-    std::unique_lock<std::recursive_mutex> lock(sync);
-    for (const ConnectionPtr& connection : connections_) {
-        auto s = connection->getState();
-        if (connection->isEnabled() && s != a && s != b && s != c) {
-            return false;
-        }
-    }
-    return true;
+    return state_counter_.areAll(a, b, c);
 }
 
 bool Transition::isOneConnection(Connection::State state) const
 {
-    std::unique_lock<std::recursive_mutex> lock(sync);
-    for (const ConnectionPtr& connection : connections_) {
-        if (connection->isEnabled() && connection->getState() == state) {
-            return true;
-        }
-    }
-    return false;
+    return state_counter_.isOne(state);
+}
+
+int Transition::countConnections(Connection::State state) const
+{
+    return state_counter_.count(state);
 }
 
 bool Transition::hasConnection() const
 {
-    std::unique_lock<std::recursive_mutex> lock(sync);
-    for (const ConnectionPtr& connection : connections_) {
-        if (connection->isEnabled()) {
-            return true;
-        }
-    }
-    return false;
+    return state_counter_.total() > 0;
 }
 bool Transition::hasConnection(const ConnectionPtr& c) const
 {
@@ -135,6 +153,10 @@ bool Transition::hasConnection(Connection* connection) const
 }
 bool Transition::hasActiveConnection() const
 {
+    if (std::shared_ptr<const std::vector<ConnectionPtr>> frozen = getFrozenConnections()) {
+        return std::any_of(frozen->begin(), frozen->end(), [](const ConnectionPtr& connection) { return connection->isActive(); });
+    }
+
     std::unique_lock<std::recursive_mutex> lock(sync);
     for (const ConnectionPtr& connection : connections_) {
         if (connection->isEnabled() && connection->isActive()) {
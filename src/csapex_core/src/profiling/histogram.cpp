@@ -0,0 +1,82 @@
+/// HEADER
+#include <csapex/profiling/histogram.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <cmath>
+
+using namespace csapex;
+
+constexpr std::size_t Histogram::BUCKETS;
+
+Histogram::Histogram() : buckets_(BUCKETS, 0), count_(0), sum_(0.0), max_(0.0)
+{
+}
+
+void Histogram::add(double value)
+{
+    value = std::max(0.0, value);
+
+    std::size_t bucket = 0;
+    if (value >= 1.0) {
+        int exponent;
+        std::frexp(value, &exponent);
+        bucket = std::min<std::size_t>(exponent, BUCKETS - 1);
+    }
+
+    ++buckets_[bucket];
+    ++count_;
+    sum_ += value;
+    max_ = std::max(max_, value);
+}
+
+void Histogram::reset()
+{
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    sum_ = 0.0;
+    max_ = 0.0;
+}
+
+std::size_t Histogram::count() const
+{
+    return count_;
+}
+
+double Histogram::getMean() const
+{
+    return count_ > 0 ? sum_ / count_ : 0.0;
+}
+
+double Histogram::getMax() const
+{
+    return max_;
+}
+
+double Histogram::getPercentile(double p) const
+{
+    if (count_ == 0) {
+        return 0.0;
+    }
+
+    std::size_t rank = std::max<std::size_t>(1, std::ceil(std::min(1.0, std::max(0.0, p)) * count_));
+    std::size_t seen = 0;
+    for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+        seen += buckets_[bucket];
+        if (seen >= rank) {
+            // the bound of the bucket can be far off for the last, sparsely populated buckets
+            return std::min(getUpperBound(bucket), max_);
+        }
+    }
+    return max_;
+}
+
+const std::vector<std::size_t>& Histogram::getBuckets() const
+{
+    return buckets_;
+}
+
+double Histogram::getUpperBound(std::size_t bucket)
+{
+    return std::ldexp(1.0, bucket);
+}
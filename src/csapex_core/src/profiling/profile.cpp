@@ -22,6 +22,11 @@ void Profile::reset()
     }
     count_ = 0;
     timer_history_pos_ = 0;
+
+    std::unique_lock<std::mutex> lock(records_mutex_);
+    counters_.clear();
+    histograms_.clear();
+    latencies_.clear();
 }
 
 Timer::Ptr Profile::getTimer() const
@@ -61,6 +66,62 @@ ProfilerStats Profile::getStats(const std::string& name) const
     return res;
 }
 
+std::size_t Profile::getCounter(const std::string& name) const
+{
+    std::unique_lock<std::mutex> lock(records_mutex_);
+    auto pos = counters_.find(name);
+    if (pos == counters_.end()) {
+        return 0;
+    }
+    return pos->second;
+}
+
+std::map<std::string, std::size_t> Profile::getCounters() const
+{
+    std::unique_lock<std::mutex> lock(records_mutex_);
+    return counters_;
+}
+
+void Profile::incrementCounter(const std::string& name, std::size_t amount)
+{
+    std::unique_lock<std::mutex> lock(records_mutex_);
+    counters_[name] += amount;
+}
+
+Histogram Profile::getHistogram(const std::string& name) const
+{
+    std::unique_lock<std::mutex> lock(records_mutex_);
+    auto pos = histograms_.find(name);
+    if (pos == histograms_.end()) {
+        return Histogram();
+    }
+    return pos->second;
+}
+
+std::map<std::string, Histogram> Profile::getHistograms() const
+{
+    std::unique_lock<std::mutex> lock(records_mutex_);
+    return histograms_;
+}
+
+void Profile::addToHistogram(const std::string& name, double value)
+{
+    std::unique_lock<std::mutex> lock(records_mutex_);
+    histograms_[name].add(value);
+}
+
+std::map<std::string, Histogram> Profile::getLatencies() const
+{
+    std::unique_lock<std::mutex> lock(records_mutex_);
+    return latencies_;
+}
+
+void Profile::addLatency(const std::string& source, double value)
+{
+    std::unique_lock<std::mutex> lock(records_mutex_);
+    latencies_[source].add(value);
+}
+
 void Profile::addInterval(Interval::Ptr interval)
 {
     timer_history_[timer_history_pos_] = interval;
@@ -1,6 +1,9 @@
 /// HEADER
 #include <csapex/profiling/profiler.h>
 
+/// SYSTEM
+#include <tuple>
+
 using namespace csapex;
 
 Profiler::Profiler(bool enabled, int history) : enabled_(false), history_length_(history)
@@ -17,10 +20,16 @@ Timer::Ptr Profiler::getTimer(const std::string& key)
 
 const Profile& Profiler::getProfile(const std::string& key)
 {
+    return findOrCreateProfile(key);
+}
+
+Profile& Profiler::findOrCreateProfile(const std::string& key)
+{
+    std::unique_lock<std::mutex> lock(profiles_mutex_);
+
     auto pos = profiles_.find(key);
     if (pos == profiles_.end()) {
-        profiles_.emplace(key, Profile(key, history_length_, enabled_));
-        Profile& profile = profiles_.at(key);
+        Profile& profile = profiles_.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(key, history_length_, enabled_)).first->second;
 
         profile.timer->finished.connect([this](Interval::Ptr) { updated(); });
 
@@ -32,6 +41,21 @@ const Profile& Profiler::getProfile(const std::string& key)
     return pos->second;
 }
 
+void Profiler::incrementCounter(const std::string& key, const std::string& counter, std::size_t amount)
+{
+    findOrCreateProfile(key).incrementCounter(counter, amount);
+}
+
+void Profiler::addToHistogram(const std::string& key, const std::string& histogram, double value)
+{
+    findOrCreateProfile(key).addToHistogram(histogram, value);
+}
+
+void Profiler::addLatency(const std::string& key, const std::string& source, double value)
+{
+    findOrCreateProfile(key).addLatency(source, value);
+}
+
 void Profiler::setEnabled(bool enabled)
 {
     if (enabled == enabled_) {
@@ -39,10 +63,13 @@ void Profiler::setEnabled(bool enabled)
     }
 
     enabled_ = enabled;
-    for (auto& pair : profiles_) {
-        Profile& profile = pair.second;
-        Timer::Ptr timer = profile.timer;
-        timer->setEnabled(enabled_);
+    {
+        std::unique_lock<std::mutex> lock(profiles_mutex_);
+        for (auto& pair : profiles_) {
+            Profile& profile = pair.second;
+            Timer::Ptr timer = profile.timer;
+            timer->setEnabled(enabled_);
+        }
     }
 
     enabled_changed(enabled_);
@@ -55,6 +82,7 @@ bool Profiler::isEnabled() const
 
 void Profiler::reset()
 {
+    std::unique_lock<std::mutex> lock(profiles_mutex_);
     for (auto& pair : profiles_) {
         Profile& profile = pair.second;
         profile.reset();
@@ -6,7 +6,14 @@
 
 using namespace csapex;
 
-Task::Task(const std::string& name, std::function<void()> callback, long priority, TaskGenerator* parent) : parent_(parent), name_(name), callback_(callback), priority_(priority), scheduled_(false)
+Task::Task(const std::string& name, std::function<void()> callback, long priority, TaskGenerator* parent)
+  : parent_(parent)
+  , name_(name)
+  , callback_(callback)
+  , priority_(priority)
+  , scheduled_(false)
+  , deadline_(std::chrono::steady_clock::time_point::max().time_since_epoch().count())
+  , enqueue_time_(0)
 {
 }
 
@@ -48,3 +55,33 @@ void Task::setScheduled(bool scheduled)
 {
     scheduled_ = scheduled;
 }
+
+bool Task::markScheduled()
+{
+    return !scheduled_.exchange(true);
+}
+
+void Task::setDeadline(std::chrono::steady_clock::time_point deadline)
+{
+    deadline_ = deadline.time_since_epoch().count();
+}
+
+std::chrono::steady_clock::time_point Task::getDeadline() const
+{
+    return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(deadline_.load()));
+}
+
+bool Task::hasDeadline() const
+{
+    return getDeadline() != std::chrono::steady_clock::time_point::max();
+}
+
+void Task::setEnqueueTime(std::chrono::steady_clock::time_point time)
+{
+    enqueue_time_ = time.time_since_epoch().count();
+}
+
+std::chrono::steady_clock::time_point Task::getEnqueueTime() const
+{
+    return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(enqueue_time_.load()));
+}
@@ -0,0 +1,48 @@
+/// HEADER
+#include <csapex/scheduling/task_ring.h>
+
+/// PROJECT
+#include <csapex/scheduling/task.h>
+
+/// SYSTEM
+#include <algorithm>
+
+using namespace csapex;
+
+std::size_t TaskRing::bucketOf(long priority)
+{
+    return static_cast<std::size_t>(std::min<long>(std::max<long>(priority, 0), BUCKETS - 1));
+}
+
+TaskRing::TaskRing(std::size_t capacity_per_bucket)
+{
+    for (std::unique_ptr<MpscRing<TaskPtr>>& bucket : buckets_) {
+        bucket.reset(new MpscRing<TaskPtr>(capacity_per_bucket));
+    }
+}
+
+bool TaskRing::push(const TaskPtr& task)
+{
+    return buckets_[bucketOf(task->getPriority())]->push(task);
+}
+
+TaskPtr TaskRing::pop()
+{
+    TaskPtr task;
+    for (std::size_t i = BUCKETS; i > 0; --i) {
+        if (buckets_[i - 1]->pop(task)) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool TaskRing::empty() const
+{
+    for (const std::unique_ptr<MpscRing<TaskPtr>>& bucket : buckets_) {
+        if (!bucket->empty()) {
+            return false;
+        }
+    }
+    return true;
+}
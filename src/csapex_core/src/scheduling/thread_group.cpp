@@ -3,32 +3,112 @@
 
 /// PROJECT
 #include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_ring.h>
+#include <csapex/scheduling/timer_wheel.h>
 #include <csapex/utility/thread.h>
 #include <csapex/scheduling/task_generator.h>
 #include <csapex/utility/assert.h>
 #include <csapex/utility/cpu_affinity.h>
 #include <csapex/utility/exceptions.h>
 #include <csapex/core/exception_handler.h>
-#include <csapex/scheduling/timed_queue.h>
 #include <csapex/profiling/profiler.h>
 #include <csapex/profiling/trace.h>
 #include <csapex/utility/yaml.h>
 
 /// SYSTEM
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#if !WIN32
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 using namespace csapex;
 
+namespace
+{
+// mlockall affects the whole process, so memory stays locked as long as one group requests it
+std::mutex memory_lock_mtx;
+std::size_t memory_lock_count = 0;
+
+#if !WIN32
+__attribute__((noinline)) void prefaultStack(std::size_t bytes)
+{
+    if (bytes == 0) {
+        return;
+    }
+    // the pages stay mapped after returning, so later stack growth does not cause page faults
+    volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+    std::size_t page = sysconf(_SC_PAGESIZE);
+    for (std::size_t offset = 0; offset < bytes; offset += page) {
+        stack[offset] = 0;
+    }
+}
+#endif
+}  // namespace
+
+bool ThreadGroup::RealtimeSettings::operator==(const RealtimeSettings& other) const
+{
+    return policy == other.policy && priority == other.priority && lock_memory == other.lock_memory && stack_prefault == other.stack_prefault;
+}
+
+bool ThreadGroup::RealtimeSettings::operator!=(const RealtimeSettings& other) const
+{
+    return !operator==(other);
+}
+
 int ThreadGroup::next_id_ = ThreadGroup::MINIMUM_THREAD_ID;
 
-ThreadGroup::ThreadGroup(TimedQueuePtr timed_queue, ExceptionHandler& handler, int id, std::string name)
-  : handler_(handler), destroyed_(false), id_(id), name_(name), cpu_affinity_(new CpuAffinity), timed_queue_(timed_queue), running_(false), pause_(false), stepping_(false)
+ThreadGroup::ThreadGroup(ExceptionHandler& handler, int id, std::string name)
+  : handler_(handler)
+  , destroyed_(false)
+  , id_(id)
+  , name_(name)
+  , cpu_affinity_(new CpuAffinity)
+  , memory_locked_(false)
+  , next_worker_(0)
+  , work_epoch_(0)
+  , queue_type_(QueueType::LOCKED)
+  , policy_(SchedulingPolicy::PRIORITY)
+  , deadline_misses_(0)
+  , wakeups_(0)
+  , inbox_(new TaskRing(INBOX_CAPACITY))
+  , sleeping_workers_(0)
+  , timers_(new TimerWheel)
+  , running_(false)
+  , pause_(false)
+  , stepping_(false)
+  , executing_tasks_(0)
+  , execution_lock_depth_(0)
 {
     next_id_ = std::max(next_id_, id + 1);
     setup();
 }
-ThreadGroup::ThreadGroup(TimedQueuePtr timed_queue, ExceptionHandler& handler, std::string name)
-  : handler_(handler), destroyed_(false), id_(next_id_++), name_(name), cpu_affinity_(new CpuAffinity), timed_queue_(timed_queue), running_(false), pause_(false), stepping_(false)
+ThreadGroup::ThreadGroup(ExceptionHandler& handler, std::string name)
+  : handler_(handler)
+  , destroyed_(false)
+  , id_(next_id_++)
+  , name_(name)
+  , cpu_affinity_(new CpuAffinity)
+  , memory_locked_(false)
+  , next_worker_(0)
+  , work_epoch_(0)
+  , queue_type_(QueueType::LOCKED)
+  , policy_(SchedulingPolicy::PRIORITY)
+  , deadline_misses_(0)
+  , wakeups_(0)
+  , inbox_(new TaskRing(INBOX_CAPACITY))
+  , sleeping_workers_(0)
+  , timers_(new TimerWheel)
+  , running_(false)
+  , pause_(false)
+  , stepping_(false)
+  , executing_tasks_(0)
+  , execution_lock_depth_(0)
 {
     setup();
 }
@@ -39,7 +119,7 @@ ThreadGroup::~ThreadGroup()
     for (const TaskGeneratorPtr& tg : generators_copy) {
         tg->detach();
     }
-    if (running_ || scheduler_thread_.joinable()) {
+    if (running_ || thread().joinable()) {
         stop();
     }
     destroyed_ = true;
@@ -47,15 +127,15 @@ ThreadGroup::~ThreadGroup()
 
 void ThreadGroup::setup()
 {
+    load_period_start_ = std::chrono::steady_clock::now();
+
+    resizeWorkers(1);
+
     cpu_affinity_->affinity_changed.connect([this](const CpuAffinity*) { updateAffinity(); });
 }
 
 void ThreadGroup::updateAffinity()
 {
-    if (!scheduler_thread_.joinable()) {
-        return;
-    }
-
 #if WIN32
     // TODO: implement for other platforms
 #else
@@ -67,10 +147,74 @@ void ThreadGroup::updateAffinity()
             CPU_SET(cpu, &cpuset);
         }
     }
-    int rc = pthread_setaffinity_np(scheduler_thread_.native_handle(), sizeof(cpu_set_t), &cpuset);
-    if (rc != 0) {
-        std::cerr << "failed to set cpu affinity in thread " << name_ << std::endl;
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        if (!worker->thread.joinable()) {
+            continue;
+        }
+        int rc = pthread_setaffinity_np(worker->thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+        if (rc != 0) {
+            std::cerr << "failed to set cpu affinity in thread " << name_ << std::endl;
+        }
+    }
+#endif
+}
+
+void ThreadGroup::updateRealtimePolicy()
+{
+#if WIN32
+    // TODO: implement for other platforms
+#else
+    RealtimeSettings settings = getRealtimeSettings();
+
+    int policy = SCHED_OTHER;
+    switch (settings.policy) {
+        case RealtimePolicy::FIFO:
+            policy = SCHED_FIFO;
+            break;
+        case RealtimePolicy::ROUND_ROBIN:
+            policy = SCHED_RR;
+            break;
+        default:
+            break;
+    }
+
+    sched_param param{};
+    param.sched_priority = std::max(sched_get_priority_min(policy), std::min(sched_get_priority_max(policy), settings.priority));
+
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        if (!worker->thread.joinable()) {
+            continue;
+        }
+        int rc = pthread_setschedparam(worker->thread.native_handle(), policy, &param);
+        if (rc != 0) {
+            std::cerr << "failed to set scheduling policy in thread " << name_ << ": " << std::strerror(rc) << std::endl;
+        }
+    }
+#endif
+}
+
+void ThreadGroup::updateMemoryLock(bool lock)
+{
+#if WIN32
+    // TODO: implement for other platforms
+#else
+    std::unique_lock<std::mutex> guard(memory_lock_mtx);
+    if (lock == memory_locked_) {
+        return;
+    }
+
+    if (lock) {
+        if (memory_lock_count == 0 && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            std::cerr << "failed to lock memory for thread " << name_ << ": " << std::strerror(errno) << std::endl;
+            return;
+        }
+        ++memory_lock_count;
+    } else {
+        if (--memory_lock_count == 0) {
+            munlockall();
+        }
     }
+    memory_locked_ = lock;
 #endif
 }
 
@@ -101,9 +245,109 @@ CpuAffinityPtr ThreadGroup::getCpuAffinity() const
     return cpu_affinity_;
 }
 
+ThreadGroup::RealtimeSettings ThreadGroup::getRealtimeSettings() const
+{
+    std::unique_lock<std::recursive_mutex> lock(realtime_mtx_);
+    return realtime_;
+}
+
+void ThreadGroup::setRealtimeSettings(const RealtimeSettings& settings)
+{
+    {
+        std::unique_lock<std::recursive_mutex> lock(realtime_mtx_);
+        if (settings == realtime_) {
+            return;
+        }
+        realtime_ = settings;
+        realtime_.stack_prefault = std::min<std::size_t>(realtime_.stack_prefault, MAX_STACK_PREFAULT);
+    }
+
+    if (running_) {
+        updateRealtimePolicy();
+        updateMemoryLock(settings.lock_memory);
+    }
+
+    scheduler_changed();
+}
+
 const std::thread& ThreadGroup::thread() const
 {
-    return scheduler_thread_;
+    return workers_.front()->thread;
+}
+
+std::size_t ThreadGroup::getWorkerCount() const
+{
+    return workers_.size();
+}
+
+void ThreadGroup::setWorkerCount(std::size_t workers)
+{
+    apex_assert_hard(workers > 0);
+    if (workers == workers_.size()) {
+        return;
+    }
+
+    bool was_running = running_;
+    if (was_running) {
+        stopWorkers();
+    }
+
+    resizeWorkers(workers);
+
+    if (was_running) {
+        running_ = true;
+        startWorkers();
+    }
+
+    scheduler_changed();
+}
+
+void ThreadGroup::resizeWorkers(std::size_t workers)
+{
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+
+    if (!workers_.empty()) {
+        drainInbox();
+    }
+
+    std::vector<TaskPtr> queued;
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        apex_assert_hard(!worker->thread.joinable());
+        queued.insert(queued.end(), worker->tasks.begin(), worker->tasks.end());
+    }
+
+    workers_.clear();
+    for (std::size_t i = 0; i < workers; ++i) {
+        std::unique_ptr<Worker> worker(new Worker);
+        worker->index = i;
+        workers_.push_back(std::move(worker));
+    }
+
+    // re-distribute the queued tasks, this keeps the order of tasks per generator intact
+    worker_assignment_.clear();
+    next_worker_ = 0;
+    for (const TaskPtr& task : queued) {
+        getWorkerFor(task->getParent()).tasks.push_back(task);
+    }
+
+    // queues of different workers might have been merged, the stable sort keeps the order within each generator
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        std::stable_sort(worker->tasks.begin(), worker->tasks.end(), [this](const TaskPtr& a, const TaskPtr& b) { return isBefore(a, b); });
+    }
+}
+
+ThreadGroup::Worker& ThreadGroup::getWorkerFor(TaskGenerator* generator)
+{
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+
+    auto pos = worker_assignment_.find(generator);
+    if (pos != worker_assignment_.end()) {
+        return *workers_.at(pos->second);
+    }
+
+    std::size_t index = next_worker_++ % workers_.size();
+    worker_assignment_[generator] = index;
+    return *workers_.at(index);
 }
 
 std::size_t ThreadGroup::size() const
@@ -116,6 +360,69 @@ bool ThreadGroup::isEmpty() const
     return generators_.empty();
 }
 
+Scheduler::QueueType ThreadGroup::getQueueType() const
+{
+    return queue_type_;
+}
+
+void ThreadGroup::setQueueType(QueueType type)
+{
+    if (type != queue_type_) {
+        queue_type_ = type;
+        scheduler_changed();
+    }
+}
+
+Scheduler::SchedulingPolicy ThreadGroup::getSchedulingPolicy() const
+{
+    return policy_;
+}
+
+void ThreadGroup::setSchedulingPolicy(SchedulingPolicy policy)
+{
+    if (policy == policy_) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+        drainInbox();
+
+        policy_ = policy;
+
+        // the queues are kept sorted, so they have to be re-ordered for the new policy
+        for (const std::unique_ptr<Worker>& worker : workers_) {
+            std::unique_lock<std::mutex> worker_lock(worker->tasks_mtx);
+            std::stable_sort(worker->tasks.begin(), worker->tasks.end(), [this](const TaskPtr& a, const TaskPtr& b) { return isBefore(a, b); });
+        }
+    }
+
+    scheduler_changed();
+}
+
+std::size_t ThreadGroup::getDeadlineMissCount() const
+{
+    return deadline_misses_;
+}
+
+std::size_t ThreadGroup::getWakeupCount() const
+{
+    return wakeups_;
+}
+
+ThreadGroup::LoadStatistics ThreadGroup::takeLoadStatistics()
+{
+    std::unique_lock<std::mutex> lock(load_mtx_);
+    auto now = std::chrono::steady_clock::now();
+
+    LoadStatistics result;
+    std::swap(result, load_);
+    result.period = now - load_period_start_;
+    load_period_start_ = now;
+
+    return result;
+}
+
 void ThreadGroup::setPause(bool pause)
 {
     if (pause != pause_) {
@@ -154,10 +461,11 @@ void ThreadGroup::step()
 {
     begin_step();
 
-    std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
+    lockExecution();
     for (auto generator : generators_) {
         generator->step();
     }
+    unlockExecution();
 }
 
 bool ThreadGroup::isStepping() const
@@ -198,55 +506,89 @@ bool ThreadGroup::isStepDone() const
 
 void ThreadGroup::start()
 {
-    std::unique_lock<std::recursive_mutex> lock(state_mtx_);
-    if (scheduler_thread_.joinable()) {
-        running_ = false;
-        pause_changed_.notify_all();
-        lock.unlock();
-
-        scheduler_thread_.join();
+    if (thread().joinable()) {
+        stopWorkers();
     }
 
     running_ = true;
 
-    scheduler_thread_ = std::thread([this]() {
-        csapex::thread::set_name((name_).c_str());
-        updateAffinity();
+    startWorkers();
+}
+
+void ThreadGroup::startWorkers()
+{
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w]() {
+            if (w->index == 0) {
+                csapex::thread::set_name((name_).c_str());
+            } else {
+                csapex::thread::set_name((name_ + ":" + std::to_string(w->index)).c_str());
+            }
+
+#if !WIN32
+            prefaultStack(getRealtimeSettings().stack_prefault);
+#endif
 
-        schedulingLoop();
-    });
+            schedulingLoop(*w);
+        });
+    }
+
+    updateAffinity();
+    updateRealtimePolicy();
+    updateMemoryLock(getRealtimeSettings().lock_memory);
 }
 
-void ThreadGroup::stop()
+void ThreadGroup::stopWorkers()
 {
     {
         std::unique_lock<std::recursive_mutex> lock(state_mtx_);
         running_ = false;
         pause_changed_.notify_all();
     }
-    {
-        std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
-    }
     {
         std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
         work_available_.notify_all();
-        if (scheduler_thread_.joinable()) {
-            lock.unlock();
-
-            scheduler_thread_.join();
+    }
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
         }
+    }
 
-        auto gen = generators_;
-        for (const TaskGeneratorPtr& tg : gen) {
-            tg->detach();
-        }
+    updateMemoryLock(false);
+}
+
+void ThreadGroup::stop()
+{
+    {
+        std::unique_lock<std::recursive_mutex> lock(state_mtx_);
+        running_ = false;
+        pause_changed_.notify_all();
+    }
 
-        apex_assert_hard(generators_.empty());
+    // wait for the currently executed tasks
+    lockExecution();
+    unlockExecution();
 
-        generator_connections_.clear();
+    stopWorkers();
 
-        clear();
+    std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
+
+    auto gen = generators_;
+
+    // generators of other groups might still schedule tasks here, they lock their own mutex before ours
+    lock.unlock();
+    for (const TaskGeneratorPtr& tg : gen) {
+        tg->detach();
     }
+    lock.lock();
+
+    apex_assert_hard(generators_.empty());
+
+    generator_connections_.clear();
+
+    clear();
 }
 
 bool ThreadGroup::isRunning() const
@@ -258,13 +600,29 @@ void ThreadGroup::clear()
 {
     {
         std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
-        tasks_.clear();
+        timers_->clear();
+        drainInbox();
+        for (const std::unique_ptr<Worker>& worker : workers_) {
+            std::unique_lock<std::mutex> worker_lock(worker->tasks_mtx);
+            for (const TaskPtr& task : worker->tasks) {
+                task->setScheduled(false);
+            }
+            worker->tasks.clear();
+        }
     }
 
-    std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
-    for (auto generator : generators_) {
+    // resetting a node can remove the generators of its replicas from this group
+    std::vector<TaskGeneratorPtr> generators;
+    {
+        std::unique_lock<std::recursive_mutex> lock(state_mtx_);
+        generators = generators_;
+    }
+
+    lockExecution();
+    for (auto generator : generators) {
         generator->reset();
     }
+    unlockExecution();
 }
 
 void ThreadGroup::add(TaskGeneratorPtr generator)
@@ -311,15 +669,25 @@ std::vector<TaskPtr> ThreadGroup::remove(TaskGenerator* generator)
 
     TaskGeneratorPtr removed;
 
-    for (auto it = tasks_.begin(); it != tasks_.end();) {
-        TaskPtr task = *it;
-        if (task->getParent() == generator) {
-            remaining_tasks.push_back(task);
-            it = tasks_.erase(it);
-        } else {
-            ++it;
+    // pending timers are not kept, the generator decides again whether to delay its tasks
+    remaining_tasks = timers_->remove(generator);
+
+    drainInbox();
+
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        std::unique_lock<std::mutex> worker_lock(worker->tasks_mtx);
+        for (auto it = worker->tasks.begin(); it != worker->tasks.end();) {
+            TaskPtr task = *it;
+            if (task->getParent() == generator) {
+                task->setScheduled(false);
+                remaining_tasks.push_back(task);
+                it = worker->tasks.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
+    worker_assignment_.erase(generator);
 
     for (auto it = generators_.begin(); it != generators_.end();) {
         if (it->get() == generator) {
@@ -334,6 +702,11 @@ std::vector<TaskPtr> ThreadGroup::remove(TaskGenerator* generator)
 
     generator_connections_[generator].clear();
 
+    {
+        std::unique_lock<std::mutex> load_lock(load_mtx_);
+        load_.generators.erase(generator);
+    }
+
     generator_removed(removed);
 
     return remaining_tasks;
@@ -343,54 +716,197 @@ void ThreadGroup::schedule(TaskPtr task)
 {
     apex_assert_hard(!destroyed_);
 
+    // the scheduled flag is only reset when the task is dequeued, so a set flag means that the task is already queued
+    if (!task->markScheduled()) {
+        return;
+    }
+    task->setEnqueueTime(std::chrono::steady_clock::now());
+
+    if (queue_type_ == QueueType::LOCK_FREE && inbox_->push(task)) {
+        // the workers check the inbox before going to sleep, so only sleeping workers have to be notified
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_workers_ > 0) {
+            std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+            ++work_epoch_;
+            work_available_.notify_one();
+        }
+        return;
+    }
+
     std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
 
-    if (!tasks_.empty()) {
-        //        for(const TaskPtr& t : tasks_) {
-        for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
-            const TaskPtr& t = *it;
-            if (t.get() == task.get()) {
-                return;
-            }
+    // tasks that are still in the inbox have been scheduled before this one
+    drainInbox();
+
+    enqueue(task);
+
+    ++work_epoch_;
+    if (workers_.size() == 1) {
+        work_available_.notify_all();
+    } else {
+        work_available_.notify_one();
+    }
+}
+
+void ThreadGroup::enqueue(const TaskPtr& task)
+{
+    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+
+    Worker& worker = getWorkerFor(task->getParent());
+
+    std::unique_lock<std::mutex> worker_lock(worker.tasks_mtx);
+
+    // insert after all tasks that are not ordered after this one, in the usual case of equal priorities this is the end
+    auto is_before = [this](const TaskPtr& a, const TaskPtr& b) { return isBefore(a, b); };
+    if (worker.tasks.empty() || !is_before(task, worker.tasks.back())) {
+        worker.tasks.push_back(task);
+    } else {
+        worker.tasks.insert(std::upper_bound(worker.tasks.begin(), worker.tasks.end(), task, is_before), task);
+    }
+
+    ProfilerPtr profiler = getProfiler();
+    if (profiler && profiler->isEnabled()) {
+        profiler->addToHistogram(getName(), "queue depth", worker.tasks.size());
+    }
+}
+
+bool ThreadGroup::isBefore(const TaskPtr& a, const TaskPtr& b) const
+{
+    if (policy_ == SchedulingPolicy::EARLIEST_DEADLINE_FIRST) {
+        auto deadline_a = a->getDeadline();
+        auto deadline_b = b->getDeadline();
+        if (deadline_a != deadline_b) {
+            return deadline_a < deadline_b;
         }
     }
+    return a->getPriority() > b->getPriority();
+}
 
-    tasks_.insert(task);
+void ThreadGroup::drainInbox()
+{
+    if (inbox_->empty()) {
+        return;
+    }
 
-    task->setScheduled(true);
+    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+    std::unique_lock<std::mutex> inbox_lock(inbox_mtx_);
 
-    work_available_.notify_all();
+    std::size_t drained = 0;
+    while (TaskPtr task = inbox_->pop()) {
+        enqueue(task);
+        ++drained;
+    }
+
+    if (drained > 0 && workers_.size() > 1) {
+        // the tasks might be queued at other workers
+        ++work_epoch_;
+        work_available_.notify_all();
+    }
 }
 
 void ThreadGroup::scheduleDelayed(TaskPtr schedulable, std::chrono::system_clock::time_point time)
 {
-    timed_queue_->schedule(shared_from_this(), schedulable, time);
+    // convert once, so that the timer is not affected by later changes of the wall clock
+    scheduleDelayed(schedulable, std::chrono::steady_clock::now() + (time - std::chrono::system_clock::now()));
+}
+
+void ThreadGroup::scheduleDelayed(TaskPtr schedulable, std::chrono::steady_clock::time_point time)
+{
+    apex_assert_hard(!destroyed_);
+
+    timers_->add(schedulable, time);
+
+    // sleeping workers have to update the time they wake up at
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_workers_ > 0) {
+        std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+        ++work_epoch_;
+        work_available_.notify_all();
+    }
+}
+
+bool ThreadGroup::executeInline(TaskPtr task)
+{
+    // the generator is claimed like a worker does, so that its tasks are still executed one at a time
+    if (TaskGenerator* generator = task->getParent()) {
+        std::unique_lock<std::mutex> active_lock(active_generators_mtx_);
+        if (!active_generators_.insert(generator).second) {
+            return false;
+        }
+    }
+
+    // this is called from a task that is already executing, so it is not counted again for lockExecution
+    try {
+        task->execute();
+    } catch (...) {
+        finishTask(task);
+        throw;
+    }
+    finishTask(task);
+
+    return true;
+}
+
+std::size_t ThreadGroup::fireTimers()
+{
+    if (timers_->empty()) {
+        return 0;
+    }
+
+    std::vector<TaskPtr> expired = timers_->advance();
+    for (const TaskPtr& task : expired) {
+        schedule(task);
+    }
+    return expired.size();
 }
 
-void ThreadGroup::schedulingLoop()
+void ThreadGroup::schedulingLoop(Worker& worker)
 {
     while (running_) {
-        bool keep_executing = waitForTasks();
+        bool keep_executing = waitForTasks(worker);
         while (running_ && keep_executing) {
             handlePause();
 
-            keep_executing = executeNextTask();
+            keep_executing = executeNextTask(worker);
         }
     }
 }
 
-bool ThreadGroup::waitForTasks()
+bool ThreadGroup::waitForTasks(Worker& worker)
 {
     std::unique_lock<std::recursive_mutex> lock(tasks_mtx_);
-    while (tasks_.empty()) {
-        work_available_.wait_for(lock, std::chrono::seconds(1));
+    // the worker sleeps until something changed since it last failed to find an executable task
+    while (worker.starved && worker.starved_epoch == work_epoch_) {
+        // producers using the inbox only notify sleeping workers, so the inbox has to be checked after announcing
+        ++sleeping_workers_;
+        if (!inbox_->empty()) {
+            --sleeping_workers_;
+            break;
+        }
+
+        // delayed tasks are fired by the workers, so sleep at most until the next timer expires
+        auto timeout = std::min(std::chrono::steady_clock::now() + std::chrono::seconds(1), timers_->nextExpiry());
+        work_available_.wait_until(lock, timeout);
+        --sleeping_workers_;
+
+        ++wakeups_;
+        ProfilerPtr profiler = getProfiler();
+        if (profiler && profiler->isEnabled()) {
+            profiler->incrementCounter(getName(), "wakeups");
+        }
 
         if (!running_) {
             return false;
         }
+
+        if (fireTimers() > 0) {
+            break;
+        }
     }
 
-    return true;
+    worker.starved = false;
+
+    return running_;
 }
 
 void ThreadGroup::handlePause()
@@ -401,35 +917,137 @@ void ThreadGroup::handlePause()
     }
 }
 
-bool ThreadGroup::executeNextTask()
+bool ThreadGroup::executeNextTask(Worker& worker)
 {
-    std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
-    if (!tasks_.empty()) {
-        TaskPtr task = *tasks_.begin();
-        tasks_.erase(tasks_.begin());
+    {
+        // remember the state that was used to search for a task, see waitForTasks
+        std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+        worker.starved_epoch = work_epoch_;
+    }
 
-        task->setScheduled(false);
+    TaskPtr task = takeTask(worker);
+    if (!task) {
+        task = stealTask(worker);
+    }
 
-        tasks_lock.unlock();
+    if (!task) {
+        worker.starved = true;
+        return false;
+    }
 
-        {
-            std::unique_lock<std::recursive_mutex> state_lock(state_mtx_);
-            if (running_) {
-                state_lock.unlock();
+    {
+        std::unique_lock<std::recursive_mutex> state_lock(state_mtx_);
+        if (!running_) {
+            finishTask(task);
+            return false;
+        }
+    }
 
-                executeTask(task);
-                return true;
-            }
+    executeTask(task);
+    finishTask(task);
+
+    return true;
+}
+
+TaskPtr ThreadGroup::takeTask(Worker& worker)
+{
+    fireTimers();
+    drainInbox();
+
+    return takeFirstExecutableTask(worker);
+}
+
+TaskPtr ThreadGroup::stealTask(Worker& thief)
+{
+    for (std::size_t offset = 1, n = workers_.size(); offset < n; ++offset) {
+        Worker& victim = *workers_[(thief.index + offset) % n];
+        if (TaskPtr task = takeFirstExecutableTask(victim)) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+TaskPtr ThreadGroup::takeFirstExecutableTask(Worker& worker)
+{
+    std::unique_lock<std::mutex> worker_lock(worker.tasks_mtx);
+    if (worker.tasks.empty()) {
+        return nullptr;
+    }
+
+    // tasks of a generator that is currently executing on another worker have to wait.
+    // scanning from the front guarantees that the tasks of one generator are executed in order.
+    std::unique_lock<std::mutex> active_lock(active_generators_mtx_);
+    for (auto it = worker.tasks.begin(); it != worker.tasks.end(); ++it) {
+        TaskGenerator* generator = (*it)->getParent();
+        if (generator == nullptr || active_generators_.insert(generator).second) {
+            TaskPtr task = *it;
+            worker.tasks.erase(it);
+            // reset the flag while the queue is locked, so that the task can be re-scheduled while it is executed
+            task->setScheduled(false);
+            return task;
         }
     }
 
-    return false;
+    return nullptr;
+}
+
+void ThreadGroup::finishTask(const TaskPtr& task)
+{
+    if (TaskGenerator* generator = task->getParent()) {
+        std::unique_lock<std::mutex> active_lock(active_generators_mtx_);
+        active_generators_.erase(generator);
+    }
+
+    if (workers_.size() > 1) {
+        // tasks of this generator might be executable by another worker now
+        std::unique_lock<std::recursive_mutex> tasks_lock(tasks_mtx_);
+        ++work_epoch_;
+        work_available_.notify_one();
+    }
+}
+
+void ThreadGroup::lockExecution()
+{
+    std::unique_lock<std::mutex> lock(execution_mtx_);
+    if (execution_lock_depth_ > 0 && execution_owner_ == std::this_thread::get_id()) {
+        ++execution_lock_depth_;
+        return;
+    }
+
+    execution_changed_.wait(lock, [this]() { return execution_lock_depth_ == 0; });
+    execution_owner_ = std::this_thread::get_id();
+    execution_lock_depth_ = 1;
+
+    // new tasks are blocked from here on, wait for the running ones
+    execution_changed_.wait(lock, [this]() { return executing_tasks_ == 0; });
+}
+
+void ThreadGroup::unlockExecution()
+{
+    std::unique_lock<std::mutex> lock(execution_mtx_);
+    apex_assert_hard(execution_lock_depth_ > 0);
+    if (--execution_lock_depth_ == 0) {
+        execution_owner_ = std::thread::id();
+        execution_changed_.notify_all();
+    }
 }
 
 void ThreadGroup::executeTask(const TaskPtr& task)
 {
+    {
+        std::unique_lock<std::mutex> lock(execution_mtx_);
+        execution_changed_.wait(lock, [this]() { return execution_lock_depth_ == 0 || execution_owner_ == std::this_thread::get_id(); });
+        ++executing_tasks_;
+    }
+
+    // the deadline can already be changed for the next execution while this one is running
+    auto deadline = task->getDeadline();
+
+    auto start = std::chrono::steady_clock::now();
+    auto wait = start - task->getEnqueueTime();
+
     try {
-        std::unique_lock<std::recursive_mutex> state_lock(execution_mtx_);
         ProfilerPtr profiler = getProfiler();
         Trace::Ptr interlude;
         if (profiler && profiler->isEnabled()) {
@@ -439,6 +1057,30 @@ void ThreadGroup::executeTask(const TaskPtr& task)
 
         task->execute();
 
+        auto end = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> load_lock(load_mtx_);
+            load_.busy += end - start;
+            load_.wait += wait;
+            ++load_.tasks;
+            if (TaskGenerator* generator = task->getParent()) {
+                load_.generators[generator] += end - start;
+            }
+        }
+
+        if (profiler && profiler->isEnabled()) {
+            using microseconds = std::chrono::duration<double, std::micro>;
+            profiler->addToHistogram(getName(), "queue wait", std::chrono::duration_cast<microseconds>(wait).count());
+            profiler->addToHistogram(getName(), "execution", std::chrono::duration_cast<microseconds>(end - start).count());
+        }
+
+        if (deadline != std::chrono::steady_clock::time_point::max() && end > deadline) {
+            ++deadline_misses_;
+            if (profiler && profiler->isEnabled()) {
+                profiler->incrementCounter(getName(), "deadline misses");
+            }
+        }
+
     } catch (const std::exception& e) {
         TaskGenerator* gen = task->getParent();
         if (gen) {
@@ -452,8 +1094,17 @@ void ThreadGroup::executeTask(const TaskPtr& task)
 
     } catch (...) {
         std::cerr << "Uncaught exception of unknown type and origin in execution of task " << task->getName() << "!" << std::endl;
+        {
+            std::unique_lock<std::mutex> lock(execution_mtx_);
+            --executing_tasks_;
+            execution_changed_.notify_all();
+        }
         throw;
     }
+
+    std::unique_lock<std::mutex> lock(execution_mtx_);
+    --executing_tasks_;
+    execution_changed_.notify_all();
 }
 
 std::vector<TaskGeneratorPtr>::iterator ThreadGroup::begin()
@@ -479,6 +1130,25 @@ std::vector<TaskGeneratorPtr>::const_iterator ThreadGroup::end() const
 void ThreadGroup::saveSettings(YAML::Node& node)
 {
     node["affinity"] = cpu_affinity_->get();
+    node["workers"] = workers_.size();
+    node["queue"] = queue_type_ == QueueType::LOCK_FREE ? "lock_free" : "locked";
+    node["policy"] = policy_ == SchedulingPolicy::EARLIEST_DEADLINE_FIRST ? "edf" : "priority";
+
+    RealtimeSettings realtime = getRealtimeSettings();
+    switch (realtime.policy) {
+        case RealtimePolicy::FIFO:
+            node["realtime_policy"] = "fifo";
+            break;
+        case RealtimePolicy::ROUND_ROBIN:
+            node["realtime_policy"] = "round_robin";
+            break;
+        default:
+            node["realtime_policy"] = "none";
+            break;
+    }
+    node["realtime_priority"] = realtime.priority;
+    node["lock_memory"] = realtime.lock_memory;
+    node["stack_prefault"] = realtime.stack_prefault;
 }
 
 void ThreadGroup::loadSettings(const YAML::Node& node)
@@ -487,4 +1157,35 @@ void ThreadGroup::loadSettings(const YAML::Node& node)
         std::vector<bool> affinity = node["affinity"].as<std::vector<bool>>();
         cpu_affinity_->set(affinity);
     }
+    if (node["workers"].IsDefined()) {
+        setWorkerCount(std::max<std::size_t>(1, node["workers"].as<std::size_t>()));
+    }
+    if (node["queue"].IsDefined()) {
+        setQueueType(node["queue"].as<std::string>() == "lock_free" ? QueueType::LOCK_FREE : QueueType::LOCKED);
+    }
+    if (node["policy"].IsDefined()) {
+        setSchedulingPolicy(node["policy"].as<std::string>() == "edf" ? SchedulingPolicy::EARLIEST_DEADLINE_FIRST : SchedulingPolicy::PRIORITY);
+    }
+
+    RealtimeSettings realtime = getRealtimeSettings();
+    if (node["realtime_policy"].IsDefined()) {
+        std::string policy = node["realtime_policy"].as<std::string>();
+        if (policy == "fifo") {
+            realtime.policy = RealtimePolicy::FIFO;
+        } else if (policy == "round_robin") {
+            realtime.policy = RealtimePolicy::ROUND_ROBIN;
+        } else {
+            realtime.policy = RealtimePolicy::NONE;
+        }
+    }
+    if (node["realtime_priority"].IsDefined()) {
+        realtime.priority = node["realtime_priority"].as<int>();
+    }
+    if (node["lock_memory"].IsDefined()) {
+        realtime.lock_memory = node["lock_memory"].as<bool>();
+    }
+    if (node["stack_prefault"].IsDefined()) {
+        realtime.stack_prefault = node["stack_prefault"].as<std::size_t>();
+    }
+    setRealtimeSettings(realtime);
 }
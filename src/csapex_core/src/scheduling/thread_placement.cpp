@@ -0,0 +1,106 @@
+/// HEADER
+#include <csapex/scheduling/thread_placement.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <map>
+
+using namespace csapex;
+
+ThreadPlacement::ThreadPlacement(const CpuTopology& topology) : topology_(topology)
+{
+}
+
+const CpuTopology& ThreadPlacement::getTopology() const
+{
+    return topology_;
+}
+
+std::vector<std::vector<bool>> ThreadPlacement::place(const std::vector<Group>& groups, std::size_t num_cpus) const
+{
+    std::vector<std::vector<bool>> result(groups.size(), std::vector<bool>(num_cpus, true));
+
+    std::vector<std::vector<unsigned>> domains = topology_.getCacheDomains();
+    if (domains.size() < 2) {
+        // all CPUs share the same cache anyway
+        return result;
+    }
+
+    std::vector<int> domain_node(domains.size(), 0);
+    for (std::size_t d = 0; d < domains.size(); ++d) {
+        for (const CpuTopology::Cpu& cpu : topology_.getCpus()) {
+            if (cpu.id == domains[d].front()) {
+                domain_node[d] = cpu.numa_node;
+            }
+        }
+    }
+
+    std::map<int, std::vector<std::size_t>> chains;
+    std::map<int, std::size_t> chain_weight;
+    for (std::size_t i = 0; i < groups.size(); ++i) {
+        if (groups[i].chain >= 0) {
+            chains[groups[i].chain].push_back(i);
+            chain_weight[groups[i].chain] += groups[i].weight;
+        }
+    }
+
+    // the heaviest chains are placed first, so that they get a domain of their own if possible
+    std::vector<int> order;
+    for (const auto& pair : chains) {
+        order.push_back(pair.first);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return chain_weight[a] > chain_weight[b]; });
+
+    std::vector<std::size_t> load(domains.size(), 0);
+    auto utilization = [&](std::size_t d) { return double(load[d]) / domains[d].size(); };
+
+    auto least_loaded = [&](int numa_node) {
+        std::size_t best = domains.size();
+        for (std::size_t d = 0; d < domains.size(); ++d) {
+            if (numa_node >= 0 && domain_node[d] != numa_node) {
+                continue;
+            }
+            if (best == domains.size() || utilization(d) < utilization(best)) {
+                best = d;
+            }
+        }
+        return best;
+    };
+
+    for (int chain : order) {
+        std::vector<std::size_t>& members = chains[chain];
+        std::stable_sort(members.begin(), members.end(), [&](std::size_t a, std::size_t b) { return groups[a].depth < groups[b].depth; });
+
+        std::size_t domain = least_loaded(-1);
+        for (std::size_t index : members) {
+            const Group& group = groups[index];
+
+            // a chain that does not fit into its domain continues in a neighboring one, preferably on the same NUMA node
+            if (load[domain] > 0 && load[domain] + group.weight > domains[domain].size()) {
+                std::size_t candidate = least_loaded(domain_node[domain]);
+                if (utilization(candidate) >= utilization(domain)) {
+                    candidate = least_loaded(-1);
+                }
+                if (utilization(candidate) < utilization(domain)) {
+                    domain = candidate;
+                }
+            }
+
+            load[domain] += group.weight;
+
+            std::vector<bool> affinity(num_cpus, false);
+            bool any = false;
+            for (unsigned cpu : domains[domain]) {
+                if (cpu < num_cpus) {
+                    affinity[cpu] = true;
+                    any = true;
+                }
+            }
+            if (any) {
+                result[index] = affinity;
+            }
+        }
+    }
+
+    return result;
+}
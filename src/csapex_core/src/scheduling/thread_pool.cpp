@@ -5,27 +5,46 @@
 #include <csapex/utility/yaml_io.hpp>
 #include <csapex/utility/thread.h>
 #include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/thread_placement.h>
+#include <csapex/scheduling/thread_rebalancer.h>
 #include <csapex/scheduling/task.h>
 #include <csapex/scheduling/task_generator.h>
-#include <csapex/scheduling/timed_queue.h>
 #include <csapex/utility/cpu_affinity.h>
+#include <csapex/utility/cpu_topology.h>
 
 /// SYSTEM
 #include <set>
 #include <unordered_map>
 #include <iostream>
+#include <limits>
 
 using namespace csapex;
 
 ThreadPool::ThreadPool(ExceptionHandler& handler, bool enable_threading, bool grouping, bool initially_paused)
-  : handler_(handler), timed_queue_(new TimedQueue), enable_threading_(enable_threading), grouping_(grouping), private_group_cpu_affinity_(new CpuAffinity), suppress_exceptions_(true)
+  : handler_(handler)
+  , enable_threading_(enable_threading)
+  , grouping_(grouping)
+  , private_group_cpu_affinity_(new CpuAffinity)
+  , automatic_placement_(false)
+  , placing_(false)
+  , placement_(new ThreadPlacement(CpuTopology()))
+  , rebalancer_(new ThreadRebalancer(*this))
+  , suppress_exceptions_(true)
 {
     setPause(initially_paused);
     setup();
 }
 
 ThreadPool::ThreadPool(Executor* parent, ExceptionHandler& handler, bool enable_threading, bool grouping, bool initially_paused)
-  : handler_(handler), enable_threading_(enable_threading), grouping_(grouping), private_group_cpu_affinity_(new CpuAffinity), suppress_exceptions_(true)
+  : handler_(handler)
+  , enable_threading_(enable_threading)
+  , grouping_(grouping)
+  , private_group_cpu_affinity_(new CpuAffinity)
+  , automatic_placement_(false)
+  , placing_(false)
+  , placement_(new ThreadPlacement(CpuTopology()))
+  , rebalancer_(new ThreadRebalancer(*this))
+  , suppress_exceptions_(true)
 {
     setPause(initially_paused);
     setup();
@@ -33,7 +52,7 @@ ThreadPool::ThreadPool(Executor* parent, ExceptionHandler& handler, bool enable_
 }
 void ThreadPool::setup()
 {
-    default_group_ = std::make_shared<ThreadGroup>(timed_queue_, handler_, ThreadGroup::DEFAULT_GROUP_ID, "default");
+    default_group_ = std::make_shared<ThreadGroup>(handler_, ThreadGroup::DEFAULT_GROUP_ID, "default");
     default_group_->useProfiler(getProfiler());
     default_group_->setPause(isPaused());
 
@@ -71,9 +90,6 @@ void ThreadPool::performStep()
 
 void ThreadPool::start()
 {
-    if (timed_queue_) {
-        timed_queue_->start();
-    }
     for (auto g : groups_) {
         g->start();
     }
@@ -84,9 +100,6 @@ void ThreadPool::stop()
     // resume, otherwise nothing will stop here
     setPause(false);
 
-    if (timed_queue_) {
-        timed_queue_->stop();
-    }
     for (auto g : groups_) {
         g->stop();
     }
@@ -95,6 +108,14 @@ void ThreadPool::stop()
     apex_assert_hard(group_assignment_.empty());
     apex_assert_hard(groups_.empty());
     groups_.push_back(default_group_);
+
+    for (auto it = manual_affinities_.begin(); it != manual_affinities_.end();) {
+        if (it->first == default_group_.get()) {
+            ++it;
+        } else {
+            it = manual_affinities_.erase(it);
+        }
+    }
 }
 
 bool ThreadPool::isRunning() const
@@ -162,6 +183,7 @@ void ThreadPool::remove(TaskGenerator* task)
     task->detach();
     group_assignment_.erase(task);
     group_connection_.erase(task);
+    placement_chains_.erase(task);
 }
 
 std::size_t ThreadPool::getGroupCount() const
@@ -226,9 +248,16 @@ void ThreadPool::assignGeneratorToGroup(TaskGenerator* task, ThreadGroup* group)
                 removeGroup(old_group);
             }
         }
+
+        updatePlacement();
     }
 }
 
+bool ThreadPool::isManaged(TaskGenerator* generator) const
+{
+    return group_assignment_.find(generator) != group_assignment_.end();
+}
+
 bool ThreadPool::isInPrivateThread(TaskGenerator* task) const
 {
     return isInGroup(task, ThreadGroup::PRIVATE_THREAD);
@@ -246,7 +275,7 @@ bool ThreadPool::isInGroup(TaskGenerator* task, int id) const
 void ThreadPool::usePrivateThreadFor(TaskGenerator* task)
 {
     if (!isInPrivateThread(task)) {
-        ThreadGroupPtr group = std::make_shared<ThreadGroup>(timed_queue_, handler_, ThreadGroup::PRIVATE_THREAD, task->getUUID().getShortName());
+        ThreadGroupPtr group = std::make_shared<ThreadGroup>(handler_, ThreadGroup::PRIVATE_THREAD, task->getUUID().getShortName());
 
         group->getCpuAffinity()->set(private_group_cpu_affinity_->get());
 
@@ -260,7 +289,12 @@ void ThreadPool::usePrivateThreadFor(TaskGenerator* task)
 
         ThreadGroupWeakPtr group_weak = group;
         private_group_connections_[group.get()].push_back(
-            group->getCpuAffinity()->affinity_changed.connect([this](const CpuAffinity* affinity) { private_group_cpu_affinity_->set(affinity->get()); }));
+            group->getCpuAffinity()->affinity_changed.connect([this](const CpuAffinity* affinity) {
+                // automatically placed private groups have individual affinities
+                if (!placing_) {
+                    private_group_cpu_affinity_->set(affinity->get());
+                }
+            }));
 
         private_group_connections_[group.get()].push_back(private_group_cpu_affinity_changed.connect([this, group_weak]() {
             if (ThreadGroupPtr group = group_weak.lock()) {
@@ -320,9 +354,9 @@ ThreadGroup* ThreadPool::createGroup(const std::string& name, int id)
 {
     ThreadGroupPtr group;
     if (id > 0) {
-        group = std::make_shared<ThreadGroup>(timed_queue_, handler_, id, name);
+        group = std::make_shared<ThreadGroup>(handler_, id, name);
     } else {
-        group = std::make_shared<ThreadGroup>(timed_queue_, handler_, name);
+        group = std::make_shared<ThreadGroup>(handler_, name);
     }
     group->setPause(isPaused());
     group->useProfiler(getProfiler());
@@ -346,6 +380,7 @@ void ThreadPool::removeGroup(int id)
         if (group->id() == id) {
             apex_assert_hard(group->isEmpty());
             groups_.erase(it);
+            manual_affinities_.erase(group.get());
 
             group_removed(group);
             return;
@@ -360,6 +395,7 @@ void ThreadPool::removeGroup(ThreadGroup* group)
             apex_assert_hard(group->isEmpty());
             group_removed(*it);
             groups_.erase(it);
+            manual_affinities_.erase(group);
 
             return;
         }
@@ -395,6 +431,91 @@ std::vector<bool> ThreadPool::getPrivateThreadGroupCpuAffinity() const
     return private_group_cpu_affinity_->get();
 }
 
+void ThreadPool::setAutomaticPlacement(bool enabled)
+{
+    if (enabled != automatic_placement_) {
+        automatic_placement_ = enabled;
+        if (automatic_placement_) {
+            updatePlacement();
+        } else {
+            restoreManualAffinities();
+        }
+
+        automatic_placement_changed(automatic_placement_);
+    }
+}
+
+bool ThreadPool::isAutomaticPlacementEnabled() const
+{
+    return automatic_placement_;
+}
+
+void ThreadPool::setPlacementChains(const std::map<TaskGenerator*, std::pair<int, int>>& chains)
+{
+    placement_chains_ = chains;
+    updatePlacement();
+}
+
+ThreadRebalancer* ThreadPool::getRebalancer() const
+{
+    return rebalancer_.get();
+}
+
+void ThreadPool::updatePlacement()
+{
+    if (!automatic_placement_) {
+        return;
+    }
+
+    // a group belongs to the chain most of its generators belong to
+    std::vector<ThreadPlacement::Group> requests;
+    for (const ThreadGroupPtr& group : groups_) {
+        std::map<int, std::size_t> votes;
+        int depth = std::numeric_limits<int>::max();
+        for (const TaskGeneratorPtr& generator : *group) {
+            auto pos = placement_chains_.find(generator.get());
+            if (pos != placement_chains_.end() && pos->second.first >= 0) {
+                ++votes[pos->second.first];
+                depth = std::min(depth, pos->second.second);
+            }
+        }
+
+        ThreadPlacement::Group request{ -1, depth, group->getWorkerCount() };
+        std::size_t max_votes = 0;
+        for (const auto& vote : votes) {
+            if (vote.second > max_votes) {
+                max_votes = vote.second;
+                request.chain = vote.first;
+            }
+        }
+        requests.push_back(request);
+    }
+
+    std::vector<std::vector<bool>> affinities = placement_->place(requests, private_group_cpu_affinity_->getNumCpus());
+
+    placing_ = true;
+    for (std::size_t i = 0; i < groups_.size(); ++i) {
+        // only the affinity from before the first placement is kept, later ones were chosen by the placement itself
+        manual_affinities_.emplace(groups_[i].get(), groups_[i]->getCpuAffinity()->get());
+        groups_[i]->getCpuAffinity()->set(affinities[i]);
+    }
+    placing_ = false;
+}
+
+void ThreadPool::restoreManualAffinities()
+{
+    placing_ = true;
+    for (const ThreadGroupPtr& group : groups_) {
+        auto pos = manual_affinities_.find(group.get());
+        if (pos != manual_affinities_.end()) {
+            group->getCpuAffinity()->set(pos->second);
+        }
+    }
+    placing_ = false;
+
+    manual_affinities_.clear();
+}
+
 void ThreadPool::saveSettings(YAML::Node& node)
 {
     YAML::Node threads(YAML::NodeType::Map);
@@ -413,6 +534,11 @@ void ThreadPool::saveSettings(YAML::Node& node)
     }
     threads["groups"] = groups;
     threads["private_affinity"] = private_group_cpu_affinity_->get();
+    threads["automatic_placement"] = automatic_placement_;
+
+    YAML::Node rebalancer;
+    rebalancer_->saveSettings(rebalancer);
+    threads["rebalancer"] = rebalancer;
 
     YAML::Node assignments;
     for (std::map<TaskGenerator*, ThreadGroup*>::const_iterator it = group_assignment_.begin(); it != group_assignment_.end(); ++it) {
@@ -437,6 +563,11 @@ void ThreadPool::loadSettings(YAML::Node& node)
             private_group_cpu_affinity_->set(a);
         }
 
+        const YAML::Node& automatic_placement = threads["automatic_placement"];
+        if (automatic_placement.IsDefined()) {
+            setAutomaticPlacement(automatic_placement.as<bool>());
+        }
+
         const YAML::Node& groups = threads["groups"];
         if (groups.IsDefined()) {
             for (std::size_t i = 0, total = groups.size(); i < total; ++i) {
@@ -448,7 +579,7 @@ void ThreadPool::loadSettings(YAML::Node& node)
                 if (group_id >= ThreadGroup::MINIMUM_THREAD_ID) {
                     std::string group_name = group["name"].as<std::string>();
 
-                    auto g = std::make_shared<ThreadGroup>(timed_queue_, handler_, group_id, group_name);
+                    auto g = std::make_shared<ThreadGroup>(handler_, group_id, group_name);
                     g->setPause(isPaused());
                     g->useProfiler(getProfiler());
 
@@ -496,6 +627,11 @@ void ThreadPool::loadSettings(YAML::Node& node)
                 addToGroup(task, id);
             }
         }
+
+        const YAML::Node& rebalancer = threads["rebalancer"];
+        if (rebalancer.IsDefined()) {
+            rebalancer_->loadSettings(rebalancer);
+        }
     }
 }
 
@@ -0,0 +1,307 @@
+/// HEADER
+#include <csapex/scheduling/thread_rebalancer.h>
+
+/// COMPONENT
+#include <csapex/scheduling/thread_pool.h>
+#include <csapex/scheduling/task_generator.h>
+#include <csapex/utility/assert.h>
+
+/// SYSTEM
+#include <algorithm>
+
+using namespace csapex;
+
+namespace
+{
+const std::string AUTOMATIC_GROUP_PREFIX = "auto ";
+
+std::vector<TaskGenerator*> getGenerators(const ThreadPool& pool, ThreadGroup* group)
+{
+    std::vector<TaskGenerator*> generators;
+    for (const TaskGeneratorPtr& generator : *group) {
+        // generators that are not managed by the pool are moved together with their owner
+        if (pool.isManaged(generator.get())) {
+            generators.push_back(generator.get());
+        }
+    }
+    return generators;
+}
+}  // namespace
+
+ThreadRebalancer::ThreadRebalancer(ThreadPool& pool)
+  : pool_(pool)
+  , enabled_(false)
+  , interval_(std::chrono::seconds(5))
+  , max_groups_(8)
+  , low_utilization_(0.1)
+  , high_utilization_(0.8)
+  , max_queue_wait_(std::chrono::milliseconds(10))
+  , last_rebalance_(std::chrono::steady_clock::now())
+{
+}
+
+void ThreadRebalancer::setEnabled(bool enabled)
+{
+    if (enabled != enabled_) {
+        enabled_ = enabled;
+
+        // samples taken while disabled do not reflect the current layout
+        last_rebalance_ = std::chrono::steady_clock::now();
+        for (const ThreadGroupPtr& group : pool_.getGroups()) {
+            group->takeLoadStatistics();
+        }
+
+        enabled_changed(enabled_);
+    }
+}
+
+bool ThreadRebalancer::isEnabled() const
+{
+    return enabled_;
+}
+
+void ThreadRebalancer::setInterval(std::chrono::milliseconds interval)
+{
+    interval_ = interval;
+}
+
+std::chrono::milliseconds ThreadRebalancer::getInterval() const
+{
+    return interval_;
+}
+
+void ThreadRebalancer::setMaximumGroupCount(std::size_t count)
+{
+    max_groups_ = std::max<std::size_t>(1, count);
+}
+
+std::size_t ThreadRebalancer::getMaximumGroupCount() const
+{
+    return max_groups_;
+}
+
+void ThreadRebalancer::setUtilizationLimits(double low, double high)
+{
+    apex_assert_hard(low <= high);
+    low_utilization_ = low;
+    high_utilization_ = high;
+}
+
+double ThreadRebalancer::getLowUtilization() const
+{
+    return low_utilization_;
+}
+
+double ThreadRebalancer::getHighUtilization() const
+{
+    return high_utilization_;
+}
+
+void ThreadRebalancer::setMaximumQueueWait(std::chrono::milliseconds wait)
+{
+    max_queue_wait_ = wait;
+}
+
+std::chrono::milliseconds ThreadRebalancer::getMaximumQueueWait() const
+{
+    return max_queue_wait_;
+}
+
+const YAML::Node& ThreadRebalancer::getLayout() const
+{
+    return layout_;
+}
+
+void ThreadRebalancer::tick()
+{
+    if (!enabled_) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_rebalance_ >= interval_) {
+        rebalance();
+    }
+}
+
+double ThreadRebalancer::getUtilization(const Sample& sample, std::chrono::steady_clock::duration busy) const
+{
+    double period = std::chrono::duration<double>(sample.load.period).count() * std::max<std::size_t>(1, sample.group->getWorkerCount());
+    if (period <= 0.0) {
+        return 0.0;
+    }
+    return std::chrono::duration<double>(busy).count() / period;
+}
+
+bool ThreadRebalancer::rebalance()
+{
+    last_rebalance_ = std::chrono::steady_clock::now();
+
+    std::vector<Sample> samples;
+    std::set<int> existing_groups;
+    for (const ThreadGroupPtr& group : pool_.getGroups()) {
+        ThreadGroup::LoadStatistics load = group->takeLoadStatistics();
+
+        // private threads have been requested explicitly
+        if (group->id() == ThreadGroup::PRIVATE_THREAD) {
+            continue;
+        }
+        existing_groups.insert(group->id());
+
+        Sample sample{ group.get(), load, 0.0, created_groups_.find(group->id()) != created_groups_.end() };
+        sample.utilization = getUtilization(sample, load.busy);
+        samples.push_back(sample);
+    }
+
+    // groups might have been removed by someone else in the meantime
+    for (auto it = created_groups_.begin(); it != created_groups_.end();) {
+        if (existing_groups.find(*it) == existing_groups.end()) {
+            it = created_groups_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    bool changed = split(samples) || merge(samples);
+    if (changed) {
+        layout_ = YAML::Node();
+        pool_.saveSettings(layout_);
+
+        rebalanced();
+    }
+
+    return changed;
+}
+
+bool ThreadRebalancer::split(std::vector<Sample>& samples)
+{
+    // the group with the highest load that can still be divided
+    Sample* overloaded = nullptr;
+    for (Sample& sample : samples) {
+        bool waiting_too_long = sample.load.tasks > 0 && sample.load.wait / sample.load.tasks > max_queue_wait_;
+        if (sample.utilization <= high_utilization_ && !waiting_too_long) {
+            continue;
+        }
+        if (getGenerators(pool_, sample.group).size() < 2) {
+            continue;
+        }
+        if (!overloaded || sample.utilization > overloaded->utilization) {
+            overloaded = &sample;
+        }
+    }
+    if (!overloaded) {
+        return false;
+    }
+
+    std::vector<TaskGenerator*> generators = getGenerators(pool_, overloaded->group);
+    TaskGenerator* expensive = nullptr;
+    std::chrono::steady_clock::duration max_cost{};
+    for (const auto& pair : overloaded->load.generators) {
+        if (pair.second > max_cost && std::find(generators.begin(), generators.end(), pair.first) != generators.end()) {
+            expensive = pair.first;
+            max_cost = pair.second;
+        }
+    }
+    if (!expensive) {
+        return false;
+    }
+
+    if (samples.size() < max_groups_) {
+        created_groups_.insert(pool_.createNewGroupFor(expensive, AUTOMATIC_GROUP_PREFIX + std::to_string(ThreadGroup::nextId())));
+        return true;
+    }
+
+    // no more groups are allowed, so the generator can only move to a group that has capacity left
+    double cost = getUtilization(*overloaded, max_cost);
+    Sample* target = nullptr;
+    for (Sample& sample : samples) {
+        if (&sample == overloaded || sample.utilization + cost > high_utilization_) {
+            continue;
+        }
+        if (!target || sample.utilization < target->utilization) {
+            target = &sample;
+        }
+    }
+    if (!target) {
+        return false;
+    }
+
+    pool_.addToGroup(expensive, target->group->id());
+    return true;
+}
+
+bool ThreadRebalancer::merge(std::vector<Sample>& samples)
+{
+    // only groups created by the rebalancer are removed, user defined groups stay as they are
+    Sample* idle = nullptr;
+    for (Sample& sample : samples) {
+        if (sample.automatic && sample.utilization < low_utilization_) {
+            if (!idle || sample.utilization < idle->utilization) {
+                idle = &sample;
+            }
+        }
+    }
+    if (!idle) {
+        return false;
+    }
+
+    // prefer other automatic groups, the default group takes everything that is left
+    Sample* target = nullptr;
+    for (Sample& sample : samples) {
+        if (&sample == idle || sample.utilization + idle->utilization > high_utilization_) {
+            continue;
+        }
+        bool is_default = sample.group->id() == ThreadGroup::DEFAULT_GROUP_ID;
+        if (!sample.automatic && !is_default) {
+            continue;
+        }
+        if (!target || (sample.automatic && !target->automatic) || (sample.automatic == target->automatic && sample.utilization < target->utilization)) {
+            target = &sample;
+        }
+    }
+    if (!target) {
+        return false;
+    }
+
+    for (TaskGenerator* generator : getGenerators(pool_, idle->group)) {
+        pool_.addToGroup(generator, target->group->id());
+    }
+    created_groups_.erase(idle->group->id());
+    pool_.removeGroup(idle->group->id());
+
+    return true;
+}
+
+void ThreadRebalancer::saveSettings(YAML::Node& node) const
+{
+    node["enabled"] = enabled_;
+    node["interval"] = static_cast<int>(interval_.count());
+    node["max_groups"] = max_groups_;
+    node["low_utilization"] = low_utilization_;
+    node["high_utilization"] = high_utilization_;
+    node["max_queue_wait"] = static_cast<int>(max_queue_wait_.count());
+    node["created_groups"] = std::vector<int>(created_groups_.begin(), created_groups_.end());
+}
+
+void ThreadRebalancer::loadSettings(const YAML::Node& node)
+{
+    if (node["interval"].IsDefined()) {
+        setInterval(std::chrono::milliseconds(node["interval"].as<int>()));
+    }
+    if (node["max_groups"].IsDefined()) {
+        setMaximumGroupCount(node["max_groups"].as<std::size_t>());
+    }
+    if (node["low_utilization"].IsDefined() && node["high_utilization"].IsDefined()) {
+        setUtilizationLimits(node["low_utilization"].as<double>(), node["high_utilization"].as<double>());
+    }
+    if (node["max_queue_wait"].IsDefined()) {
+        setMaximumQueueWait(std::chrono::milliseconds(node["max_queue_wait"].as<int>()));
+    }
+    if (node["created_groups"].IsDefined()) {
+        std::vector<int> ids = node["created_groups"].as<std::vector<int>>();
+        created_groups_ = std::set<int>(ids.begin(), ids.end());
+    }
+    if (node["enabled"].IsDefined()) {
+        setEnabled(node["enabled"].as<bool>());
+    }
+}
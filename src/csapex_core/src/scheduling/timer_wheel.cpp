@@ -0,0 +1,256 @@
+/// HEADER
+#include <csapex/scheduling/timer_wheel.h>
+
+/// PROJECT
+#include <csapex/scheduling/task.h>
+#include <csapex/utility/assert.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <limits>
+
+using namespace csapex;
+
+namespace
+{
+std::uint64_t span(std::size_t level)
+{
+    return std::uint64_t(1) << (TimerWheel::SLOT_BITS * (level + 1));
+}
+
+std::size_t slotIndex(std::uint64_t tick, std::size_t level)
+{
+    return (tick >> (TimerWheel::SLOT_BITS * level)) & (TimerWheel::SLOTS - 1);
+}
+}  // namespace
+
+TimerWheel::TimerWheel(clock::duration tick) : tick_(tick), origin_(clock::now()), current_tick_(0), size_(0)
+{
+    apex_assert_hard(tick_.count() > 0);
+    timers_per_level_.fill(0);
+}
+
+TimerWheel::~TimerWheel()
+{
+    clear();
+}
+
+std::uint64_t TimerWheel::toTicksCeil(clock::time_point time) const
+{
+    if (time <= origin_) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>((time - origin_ + tick_ - clock::duration(1)) / tick_);
+}
+
+std::uint64_t TimerWheel::toTicksFloor(clock::time_point time) const
+{
+    if (time <= origin_) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>((time - origin_) / tick_);
+}
+
+TimerWheel::clock::time_point TimerWheel::toTime(std::uint64_t ticks) const
+{
+    return origin_ + tick_ * ticks;
+}
+
+TimerWheel::Handle TimerWheel::add(const TaskPtr& task, clock::time_point time)
+{
+    TimerPtr timer = std::make_shared<Timer>();
+    timer->task = task;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    // the current tick has already been processed
+    timer->expiry = std::max(toTicksCeil(time), current_tick_ + 1);
+    insert(timer);
+    ++size_;
+
+    return Handle(timer);
+}
+
+void TimerWheel::insert(const TimerPtr& timer)
+{
+    std::uint64_t delta = timer->expiry - current_tick_;
+
+    std::size_t level = 0;
+    while (level < LEVELS - 1 && delta >= span(level)) {
+        ++level;
+    }
+
+    // timers beyond the range of the wheel are parked in the farthest slot and re-inserted when it is cascaded
+    std::uint64_t position = delta < span(level) ? timer->expiry : current_tick_ + span(level) - 1;
+
+    Slot& slot = wheels_[level][slotIndex(position, level)];
+    slot.push_back(timer);
+    ++timers_per_level_[level];
+    timer->level = level;
+    timer->slot = &slot;
+    timer->pos = std::prev(slot.end());
+}
+
+void TimerWheel::unlink(Timer& timer)
+{
+    timer.slot->erase(timer.pos);
+    timer.slot = nullptr;
+    --timers_per_level_[timer.level];
+    --size_;
+}
+
+bool TimerWheel::cancel(const Handle& handle)
+{
+    TimerPtr timer = handle.timer_.lock();
+    if (!timer) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!timer->slot) {
+        return false;
+    }
+
+    unlink(*timer);
+    return true;
+}
+
+std::vector<TaskPtr> TimerWheel::remove(TaskGenerator* generator)
+{
+    std::vector<TaskPtr> removed;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& wheel : wheels_) {
+        for (Slot& slot : wheel) {
+            for (auto it = slot.begin(); it != slot.end();) {
+                TimerPtr timer = *it;
+                ++it;
+                if (timer->task->getParent() == generator) {
+                    removed.push_back(timer->task);
+                    unlink(*timer);
+                }
+            }
+        }
+    }
+
+    return removed;
+}
+
+void TimerWheel::clear()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& wheel : wheels_) {
+        for (Slot& slot : wheel) {
+            for (const TimerPtr& timer : slot) {
+                timer->slot = nullptr;
+            }
+            slot.clear();
+        }
+    }
+    timers_per_level_.fill(0);
+    size_ = 0;
+}
+
+void TimerWheel::cascade(std::size_t level)
+{
+    Slot& slot = wheels_[level][slotIndex(current_tick_, level)];
+    while (!slot.empty()) {
+        TimerPtr timer = slot.front();
+        slot.pop_front();
+        --timers_per_level_[level];
+        insert(timer);
+    }
+}
+
+std::vector<TaskPtr> TimerWheel::advance(clock::time_point now)
+{
+    std::vector<TaskPtr> expired;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::uint64_t target = toTicksFloor(now);
+    if (size_ == 0) {
+        current_tick_ = std::max(current_tick_, target);
+        return expired;
+    }
+
+    while (current_tick_ < target && size_ > 0) {
+        // if the lower wheels are empty, nothing happens before the next cascade of the lowest occupied one
+        std::size_t lowest = 0;
+        while (timers_per_level_[lowest] == 0) {
+            ++lowest;
+        }
+        if (lowest > 0) {
+            std::uint64_t block = std::uint64_t(1) << (SLOT_BITS * lowest);
+            std::uint64_t next_cascade = (current_tick_ / block + 1) * block;
+            if (next_cascade > target) {
+                break;
+            }
+            current_tick_ = next_cascade - 1;
+        }
+
+        ++current_tick_;
+
+        // when a lower wheel wraps around, the next slot of the upper wheel is distributed
+        std::size_t levels = 1;
+        while (levels < LEVELS && slotIndex(current_tick_, levels - 1) == 0) {
+            ++levels;
+        }
+        for (std::size_t level = levels - 1; level > 0; --level) {
+            cascade(level);
+        }
+
+        Slot& slot = wheels_[0][slotIndex(current_tick_, 0)];
+        while (!slot.empty()) {
+            TimerPtr timer = slot.front();
+            apex_assert_hard(timer->expiry == current_tick_);
+            expired.push_back(timer->task);
+            unlink(*timer);
+        }
+    }
+
+    current_tick_ = std::max(current_tick_, target);
+
+    return expired;
+}
+
+TimerWheel::clock::time_point TimerWheel::nextExpiry() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (size_ == 0) {
+        return clock::time_point::max();
+    }
+
+    std::uint64_t next = std::numeric_limits<std::uint64_t>::max();
+
+    if (timers_per_level_[0] > 0) {
+        for (std::uint64_t tick = current_tick_ + 1, end = current_tick_ + SLOTS; tick <= end; ++tick) {
+            if (!wheels_[0][slotIndex(tick, 0)].empty()) {
+                next = tick;
+                break;
+            }
+        }
+    }
+
+    // timers on an upper wheel can expire before that, wake up for the next cascade of the lowest occupied one.
+    // the cascades of higher wheels fall onto cascades of the lower ones, so that is the earliest.
+    std::size_t lowest = 1;
+    while (lowest < LEVELS && timers_per_level_[lowest] == 0) {
+        ++lowest;
+    }
+    if (lowest < LEVELS) {
+        std::uint64_t block = std::uint64_t(1) << (SLOT_BITS * lowest);
+        next = std::min(next, (current_tick_ / block + 1) * block);
+    }
+
+    return toTime(next);
+}
+
+std::size_t TimerWheel::size() const
+{
+    return size_;
+}
+
+bool TimerWheel::empty() const
+{
+    return size_ == 0;
+}
@@ -72,13 +72,16 @@ TokenData::Ptr MessageSerializer::deserializeYamlMessage(const YAML::Node& node)
         converter_type.erase(0, ns.size());
     }
 
-    if (i.type_to_yaml_converter.find(converter_type) == i.type_to_yaml_converter.end()) {
+    // unknown names are not interned, so that arbitrary input cannot grow the symbol table
+    SymbolTable::Id type_id;
+    auto pos = SymbolTable::find(converter_type, type_id) ? i.type_to_yaml_converter.find(type_id) : i.type_to_yaml_converter.end();
+    if (pos == i.type_to_yaml_converter.end()) {
         throw DeserializationError(std::string("cannot deserialize, no such type (") + type + ")");
     }
 
     TokenData::Ptr msg = MessageFactory::createMessage(converter_type);
     try {
-        i.type_to_yaml_converter.at(converter_type).decoder(node["data"], *msg);
+        pos->second.decoder(node["data"], *msg);
     } catch (const YAML::Exception& e) {
         throw DeserializationError(std::string("error while deserializing: ") + e.msg);
     }
@@ -91,18 +94,16 @@ YAML::Node MessageSerializer::serializeYamlMessage(const TokenData& msg)
     try {
         MessageSerializer& i = instance();
 
-        std::string type = msg.typeName();
-
         YAML::Node node;
-        auto pos = i.type_to_yaml_converter.find(type);
+        auto pos = i.type_to_yaml_converter.find(msg.typeId());
         if (pos == i.type_to_yaml_converter.end()) {
             return node;
         }
 
-        YamlConverter& converter = i.type_to_yaml_converter.at(type);
+        YamlConverter& converter = pos->second;
         YamlConverter::Encoder& encoder = converter.encoder;
 
-        node["type"] = type;
+        node["type"] = msg.typeName();
         node["data"] = encoder(msg);
 
         return node;
@@ -136,13 +137,10 @@ void MessageSerializer::registerMessage(std::string type, YamlConverter converte
 {
     MessageSerializer& i = instance();
 
-    std::map<std::string, YamlConverter>::const_iterator it = i.type_to_yaml_converter.find(type);
-
-    if (it != i.type_to_yaml_converter.end()) {
+    SymbolTable::Id type_id;
+    if (SymbolTable::find(type, type_id) && i.type_to_yaml_converter.find(type_id) != i.type_to_yaml_converter.end()) {
         return;
     }
 
-    apex_assert_hard(it == i.type_to_yaml_converter.end());
-
-    i.type_to_yaml_converter.insert(std::make_pair(type, converter));
+    i.type_to_yaml_converter.insert(std::make_pair(SymbolTable::intern(type), converter));
 }
@@ -0,0 +1,56 @@
+#include <csapex/msg/message_type_registry.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/io.h>
+
+#include <csapex_testing/mockup_msgs.h>
+
+/// SYSTEM
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace csapex;
+using namespace connection_types;
+
+namespace
+{
+template <typename F>
+double nanosecondsPerCall(int iterations, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        f();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+}  // namespace
+
+/**
+ * Compares message_cast and the type registry with dynamic casts, the timings depend on the machine and are only printed.
+ */
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    TokenData::ConstPtr hit = std::make_shared<GenericValueMessage<int>>(42);
+    TokenData::ConstPtr miss = std::make_shared<MockMessage>();
+
+    // the results are accumulated, so that the casts are not optimized away
+    std::size_t found = 0;
+    auto count = [&found](bool result) { found += result ? 1 : 0; };
+
+    double dynamic_hit = nanosecondsPerCall(iterations, [&]() { count(std::dynamic_pointer_cast<GenericValueMessage<int> const>(hit) != nullptr); });
+    double registry_hit = nanosecondsPerCall(iterations, [&]() { count(msg::message_cast<GenericValueMessage<int> const>(hit) != nullptr); });
+    double dynamic_miss = nanosecondsPerCall(iterations, [&]() { count(std::dynamic_pointer_cast<GenericValueMessage<int> const>(miss) != nullptr); });
+    double registry_miss = nanosecondsPerCall(iterations, [&]() { count(msg::message_cast<GenericValueMessage<int> const>(miss) != nullptr); });
+
+    double raw_dynamic = nanosecondsPerCall(iterations, [&]() { count(dynamic_cast<const MockMessage*>(miss.get()) != nullptr); });
+    double raw_registry = nanosecondsPerCall(iterations, [&]() { count(MessageTypeRegistry::cast<MockMessage>(miss.get()) != nullptr); });
+
+    std::cout << "shared_ptr cast, hit:  dynamic " << dynamic_hit << " ns, message_cast " << registry_hit << " ns" << std::endl;
+    std::cout << "shared_ptr cast, miss: dynamic " << dynamic_miss << " ns, message_cast " << registry_miss << " ns" << std::endl;
+    std::cout << "raw pointer cast:      dynamic " << raw_dynamic << " ns, registry " << raw_registry << " ns" << std::endl;
+
+    return found == static_cast<std::size_t>(4 * iterations) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
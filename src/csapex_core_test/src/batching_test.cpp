@@ -0,0 +1,82 @@
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_state.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/utility/uuid_provider.h>
+#include <csapex/utility/yaml.h>
+
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/node_constructing_test.h>
+
+/// SYSTEM
+#include <chrono>
+#include <thread>
+
+namespace csapex
+{
+class BatchingTest : public NodeConstructingTest
+{
+protected:
+    NodeFacadeImplementationPtr makeNode(const std::string& type, const std::string& name, int batch_size)
+    {
+        NodeStatePtr state = std::make_shared<NodeState>(nullptr);
+        state->setBatchSize(batch_size);
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph, state);
+
+        EXPECT_NE(nullptr, nf);
+
+        return nf;
+    }
+};
+
+TEST_F(BatchingTest, BatchSizeIsPersisted)
+{
+    NodeState state(nullptr);
+    ASSERT_EQ(1, state.getBatchSize());
+
+    state.setBatchSize(0);
+    ASSERT_EQ(1, state.getBatchSize());
+
+    state.setBatchSize(8);
+
+    YAML::Node node;
+    state.writeYaml(node);
+    ASSERT_EQ(8, node["batch_size"].as<int>());
+
+    NodeState other(nullptr);
+    other = state;
+    ASSERT_EQ(8, other.getBatchSize());
+}
+
+TEST_F(BatchingTest, BatchedNodesDoNotOverrunTheirConsumers)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src_p = makeNode("MockupSource", "src", 16);
+    main_graph_facade.addNode(src_p);
+    std::shared_ptr<MockupSource> src = std::dynamic_pointer_cast<MockupSource>(src_p->getNode());
+    ASSERT_NE(nullptr, src);
+
+    NodeFacadeImplementationPtr sink_p = makeNode("MockupSink", "sink", 16);
+    main_graph_facade.addNode(sink_p);
+    std::shared_ptr<MockupSink> sink = std::dynamic_pointer_cast<MockupSink>(sink_p->getNode());
+    ASSERT_NE(nullptr, sink);
+
+    main_graph_facade.connect(src_p, "output", sink_p, "input");
+
+    executor.start();
+
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (sink->getValue() < 100 && std::chrono::steady_clock::now() < timeout) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    executor.stop();
+
+    ASSERT_GE(sink->getValue(), 100);
+
+    // a batch must still wait for the sink to consume each message before producing the next one
+    ASSERT_LE(src->getValue() - sink->getValue(), 2);
+}
+
+}  // namespace csapex
@@ -414,3 +414,58 @@ TEST_F(BinarySerializationTest, VectorTest)
         ASSERT_EQ(10, vector->size());
     }
 }
+
+TEST_F(BinarySerializationTest, FlatVectorTest)
+{
+    SerializationBuffer data;
+    {
+        GenericVectorMessage::Ptr message = GenericVectorMessage::make<int>();
+
+        // more entries than a generically serialized vector can hold
+        std::shared_ptr<std::vector<int>> vector = std::make_shared<std::vector<int>>();
+        for (int i = 0; i < 1000; ++i) {
+            vector->push_back(i * 3);
+        }
+        message->set(vector);
+
+        TokenData::Ptr generic = message;
+        data << generic;
+    }
+
+    {
+        TokenData::Ptr generic;
+        data >> generic;
+        ASSERT_NE(nullptr, generic);
+
+        GenericVectorMessage::Ptr vector_msg = std::dynamic_pointer_cast<GenericVectorMessage>(generic);
+        ASSERT_NE(nullptr, vector_msg);
+
+        std::shared_ptr<const std::vector<int>> vector = vector_msg->makeShared<int>();
+        ASSERT_NE(nullptr, vector);
+
+        ASSERT_EQ(1000, vector->size());
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT_EQ(i * 3, vector->at(i));
+        }
+    }
+}
+
+TEST_F(BinarySerializationTest, TruncatedFlatVectorIsRejected)
+{
+    SerializationBuffer data;
+    {
+        GenericVectorMessage::Ptr message = GenericVectorMessage::make<int>();
+
+        std::shared_ptr<std::vector<int>> vector = std::make_shared<std::vector<int>>(1000, 7);
+        message->set(vector);
+
+        TokenData::Ptr generic = message;
+        data << generic;
+    }
+
+    // the announced number of entries is larger than the remaining data
+    data.resize(data.size() - 500 * sizeof(int));
+
+    TokenData::Ptr generic;
+    ASSERT_THROW(data >> generic, std::runtime_error);
+}
@@ -0,0 +1,227 @@
+#include <csapex/model/graph_facade.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/connection.h>
+#include <csapex/model/connection_description.h>
+#include <csapex/core/graphio.h>
+#include <csapex/model/node_constructor.h>
+#include <csapex/model/node_modifier.h>
+#include <csapex/msg/io.h>
+#include <csapex/scheduling/thread_pool.h>
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/stepping_test.h>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace csapex
+{
+class ConnectionBufferTest : public SteppingTest
+{
+};
+
+class SlowSink : public Node
+{
+public:
+    void setup(csapex::NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+    }
+
+    void process() override
+    {
+        int value = msg::getValue<int>(in);
+        if (value <= last) {
+            ++out_of_order;
+        }
+        last = value;
+        ++received;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::atomic<int> last{ -1 };
+    std::atomic<int> received{ 0 };
+    std::atomic<int> out_of_order{ 0 };
+
+private:
+    Input* in;
+};
+
+class LatestValueTest : public NodeConstructingTest
+{
+protected:
+    LatestValueTest()
+    {
+        factory.registerNodeType(std::make_shared<NodeConstructor>("SlowSink", []() { return std::make_shared<SlowSink>(); }));
+    }
+
+    NodeFacadeImplementationPtr makeNode(GraphFacadeImplementation& graph_facade, const std::string& type, const std::string& name)
+    {
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        EXPECT_NE(nullptr, nf);
+        graph_facade.addNode(nf);
+        return nf;
+    }
+
+    int heldValue(const ConnectionPtr& connection)
+    {
+        auto msg = std::dynamic_pointer_cast<connection_types::GenericValueMessage<int> const>(connection->getToken()->getTokenData());
+        apex_assert_hard(msg);
+        return msg->value;
+    }
+};
+
+TEST_F(ConnectionBufferTest, BufferedConnectionDeliversEveryToken)
+{
+    NodeFacadeImplementationPtr src = factory.makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src"), graph);
+    ASSERT_NE(nullptr, src);
+    main_graph_facade->addNode(src);
+
+    NodeFacadeImplementationPtr sink_p = factory.makeNode("MockupSink", UUIDProvider::makeUUID_without_parent("Sink"), graph);
+    ASSERT_NE(nullptr, sink_p);
+    main_graph_facade->addNode(sink_p);
+    std::shared_ptr<MockupSink> sink = std::dynamic_pointer_cast<MockupSink>(sink_p->getNode());
+    ASSERT_NE(nullptr, sink);
+
+    ConnectionPtr connection = main_graph_facade->connect(src, "output", sink_p, "input");
+    ASSERT_NE(nullptr, connection);
+    connection->setBuffer(4, OverflowPolicy::BLOCK);
+
+    executor.start();
+
+    for (int iter = 0; iter < 50; ++iter) {
+        ASSERT_NO_FATAL_FAILURE(step());
+
+        ASSERT_EQ(iter, sink->getValue());
+    }
+
+    ASSERT_EQ(0, connection->getDroppedTokenCount());
+
+    executor.stop();
+}
+
+TEST_F(ConnectionBufferTest, BufferSettingsArePersisted)
+{
+    YAML::Node store;
+
+    {
+        GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+        NodeFacadeImplementationPtr src = factory.makeNode("MockupSource", UUIDProvider::makeUUID_without_parent("src"), graph);
+        main_graph_facade.addNode(src);
+
+        NodeFacadeImplementationPtr buffered_sink = factory.makeNode("MockupSink", UUIDProvider::makeUUID_without_parent("buffered"), graph);
+        main_graph_facade.addNode(buffered_sink);
+
+        NodeFacadeImplementationPtr plain_sink = factory.makeNode("MockupSink", UUIDProvider::makeUUID_without_parent("plain"), graph);
+        main_graph_facade.addNode(plain_sink);
+
+        NodeFacadeImplementationPtr latest_sink = factory.makeNode("MockupSink", UUIDProvider::makeUUID_without_parent("latest"), graph);
+        main_graph_facade.addNode(latest_sink);
+
+        main_graph_facade.connect(src, "output", buffered_sink, "input")->setBuffer(8, OverflowPolicy::DROP_OLDEST);
+        main_graph_facade.connect(src, "output", plain_sink, "input");
+        main_graph_facade.connect(src, "output", latest_sink, "input")->setBuffer(1, OverflowPolicy::KEEP_LATEST);
+
+        GraphIO io(main_graph_facade, &factory, true);
+        ASSERT_NO_THROW(io.saveGraphTo(store));
+    }
+
+    {
+        auto graph_node = std::make_shared<SubgraphNode>(std::make_shared<GraphImplementation>());
+        auto graph = graph_node->getLocalGraph();
+        GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+        GraphIO io(main_graph_facade, &factory, true);
+        ASSERT_NO_THROW(io.loadGraphFrom(store));
+
+        std::vector<ConnectionDescription> connections = graph->enumerateAllConnections();
+        ASSERT_EQ(3, connections.size());
+
+        for (const ConnectionDescription& connection : connections) {
+            if (connection.to.getFullName().find("buffered") != std::string::npos) {
+                ASSERT_EQ(8, connection.buffer_size);
+                ASSERT_EQ(OverflowPolicy::DROP_OLDEST, connection.overflow_policy);
+            } else if (connection.to.getFullName().find("latest") != std::string::npos) {
+                ASSERT_EQ(OverflowPolicy::KEEP_LATEST, connection.overflow_policy);
+            } else {
+                ASSERT_EQ(1, connection.buffer_size);
+                ASSERT_EQ(OverflowPolicy::BLOCK, connection.overflow_policy);
+            }
+        }
+    }
+}
+
+TEST_F(LatestValueTest, HeldTokenIsReplacedByTheLatestOne)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr sink = makeNode(main_graph_facade, "MockupSink", "sink");
+    ConnectionPtr connection = main_graph_facade.connect(src, "output", sink, "input");
+    connection->setBuffer(1, OverflowPolicy::KEEP_LATEST);
+
+    connection->setToken(msg::createToken(1), true);
+    connection->setToken(msg::createToken(2), true);
+    connection->setToken(msg::createToken(3), true);
+    ASSERT_EQ(3, heldValue(connection));
+    ASSERT_EQ(2, connection->getDroppedTokenCount());
+    ASSERT_EQ(Connection::State::UNREAD, connection->getState());
+    ASSERT_EQ(Connection::State::DONE, connection->getSourceState());
+
+    // the token that is being processed is not replaced, newer tokens wait behind it
+    connection->readToken();
+    connection->setToken(msg::createToken(4), true);
+    connection->setToken(msg::createToken(5), true);
+    ASSERT_EQ(3, heldValue(connection));
+    ASSERT_EQ(1, connection->getBufferedTokenCount());
+    ASSERT_EQ(Connection::State::DONE, connection->getSourceState());
+
+    connection->setTokenProcessed();
+    ASSERT_EQ(5, heldValue(connection));
+    ASSERT_EQ(Connection::State::UNREAD, connection->getState());
+    ASSERT_EQ(0, connection->getBufferedTokenCount());
+
+    main_graph_facade.clear();
+}
+
+TEST_F(LatestValueTest, SlowConsumerDoesNotStallTheProducer)
+{
+    // every node needs its own thread, otherwise the fast path has to wait for the slow sink anyway
+    ThreadPool threaded_executor(eh, true, false, false);
+    GraphFacadeImplementation main_graph_facade(threaded_executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr slow_p = makeNode(main_graph_facade, "SlowSink", "slow");
+    NodeFacadeImplementationPtr fast_p = makeNode(main_graph_facade, "MockupSink", "fast");
+    std::shared_ptr<SlowSink> slow = std::dynamic_pointer_cast<SlowSink>(slow_p->getNode());
+    std::shared_ptr<MockupSink> fast = std::dynamic_pointer_cast<MockupSink>(fast_p->getNode());
+
+    ConnectionPtr latest = main_graph_facade.connect(src, "output", slow_p, "input");
+    latest->setBuffer(1, OverflowPolicy::KEEP_LATEST);
+    ConnectionPtr plain = main_graph_facade.connect(src, "output", fast_p, "input");
+
+    threaded_executor.start();
+
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (slow->received < 10 && std::chrono::steady_clock::now() < timeout) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    threaded_executor.stop();
+
+    ASSERT_GE(slow->received, 10);
+    ASSERT_EQ(0, slow->out_of_order);
+
+    // the producer ran at the pace of the fast sink, the slow sink skipped to the latest tokens
+    ASSERT_GT(fast->getValue(), 2 * slow->received);
+    ASSERT_GT(latest->getDroppedTokenCount(), 0);
+    ASSERT_EQ(0, plain->getDroppedTokenCount());
+
+    main_graph_facade.clear();
+}
+
+}  // namespace csapex
@@ -0,0 +1,141 @@
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/connection.h>
+#include <csapex/model/connection_state_counter.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/input.h>
+#include <csapex/msg/input_transition.h>
+#include <csapex/msg/io.h>
+#include <csapex/msg/output_transition.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/node_constructing_test.h>
+
+namespace csapex
+{
+class ConnectionStateCounterTest : public NodeConstructingTest
+{
+protected:
+    NodeFacadeImplementationPtr makeNode(GraphFacadeImplementation& graph_facade, const std::string& type, const std::string& name)
+    {
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        EXPECT_NE(nullptr, nf);
+        graph_facade.addNode(nf);
+        return nf;
+    }
+};
+
+TEST_F(ConnectionStateCounterTest, CountsArePackedIndependently)
+{
+    ConnectionStateCounter counter;
+    ASSERT_EQ(0, counter.total());
+    ASSERT_TRUE(counter.areAll(Connection::State::UNREAD));
+    ASSERT_FALSE(counter.isOne(Connection::State::UNREAD));
+
+    for (int i = 0; i < 20; ++i) {
+        counter.add(Connection::State::NOT_INITIALIZED);
+    }
+    ASSERT_EQ(20, counter.total());
+    ASSERT_TRUE(counter.areAll(Connection::State::DONE));
+
+    counter.move(Connection::State::NOT_INITIALIZED, Connection::State::UNREAD);
+    counter.move(Connection::State::NOT_INITIALIZED, Connection::State::READ);
+    ASSERT_EQ(18, counter.count(Connection::State::NOT_INITIALIZED));
+    ASSERT_EQ(1, counter.count(Connection::State::UNREAD));
+    ASSERT_EQ(1, counter.count(Connection::State::READ));
+    ASSERT_EQ(20, counter.total());
+
+    ASSERT_FALSE(counter.areAll(Connection::State::UNREAD, Connection::State::READ));
+    ASSERT_TRUE(counter.areAll(Connection::State::UNREAD, Connection::State::READ, Connection::State::NOT_INITIALIZED));
+    ASSERT_TRUE(counter.isOne(Connection::State::READ));
+
+    counter.move(Connection::State::UNREAD, Connection::State::UNREAD);
+    ASSERT_EQ(1, counter.count(Connection::State::UNREAD));
+
+    counter.remove(Connection::State::READ);
+    counter.remove(Connection::State::UNREAD);
+    ASSERT_EQ(18, counter.total());
+    ASSERT_TRUE(counter.areAll(Connection::State::NOT_INITIALIZED));
+}
+
+TEST_F(ConnectionStateCounterTest, TransitionsFollowTheConnectionStates)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr sink = makeNode(main_graph_facade, "MockupSink", "sink");
+    ConnectionPtr connection = main_graph_facade.connect(src, "output", sink, "input");
+
+    InputTransition* in = sink->getNodeHandle()->getInputTransition();
+    OutputTransition* out = src->getNodeHandle()->getOutputTransition();
+
+    ASSERT_EQ(1, in->countConnections(Connection::State::NOT_INITIALIZED));
+    ASSERT_EQ(1, out->countConnections(Connection::State::NOT_INITIALIZED));
+
+    connection->setToken(msg::createToken(1), true);
+    ASSERT_EQ(1, in->countConnections(Connection::State::UNREAD));
+    ASSERT_EQ(1, out->countConnections(Connection::State::UNREAD));
+
+    connection->readToken();
+    ASSERT_TRUE(in->areAllConnections(Connection::State::READ));
+    ASSERT_TRUE(out->areAllConnections(Connection::State::READ));
+
+    connection->setTokenProcessed();
+    ASSERT_TRUE(in->areAllConnections(Connection::State::DONE));
+    ASSERT_TRUE(out->areAllConnections(Connection::State::DONE));
+
+    // a buffered connection releases the producer while the consumer still holds a token
+    connection->setBuffer(4, OverflowPolicy::BLOCK);
+    connection->setToken(msg::createToken(2), true);
+    connection->setToken(msg::createToken(3), true);
+    ASSERT_EQ(1, in->countConnections(Connection::State::UNREAD));
+    ASSERT_EQ(1, out->countConnections(Connection::State::DONE));
+
+    connection->readToken();
+    connection->setTokenProcessed();
+    ASSERT_EQ(1, in->countConnections(Connection::State::UNREAD));
+
+    connection->readToken();
+    connection->setTokenProcessed();
+    ASSERT_TRUE(in->areAllConnections(Connection::State::DONE));
+
+    main_graph_facade.clear();
+}
+
+TEST_F(ConnectionStateCounterTest, DisabledConnectionsAreNotCounted)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr sink = makeNode(main_graph_facade, "MockupSink", "sink");
+    ConnectionPtr connection = main_graph_facade.connect(src, "output", sink, "input");
+
+    InputTransition* in = sink->getNodeHandle()->getInputTransition();
+    OutputTransition* out = src->getNodeHandle()->getOutputTransition();
+    ASSERT_TRUE(in->hasConnection());
+
+    connection->setToken(msg::createToken(1), true);
+
+    InputPtr input = connection->to();
+    input->disable();
+    ASSERT_FALSE(in->hasConnection());
+    ASSERT_FALSE(out->hasConnection());
+    ASSERT_TRUE(in->areAllConnections(Connection::State::READ));
+
+    input->enable();
+    ASSERT_TRUE(in->hasConnection());
+    ASSERT_EQ(1, in->countConnections(Connection::State::UNREAD));
+    ASSERT_EQ(1, out->countConnections(Connection::State::UNREAD));
+
+    graph->deleteConnection(connection);
+    ASSERT_FALSE(in->hasConnection());
+    ASSERT_FALSE(out->hasConnection());
+
+    main_graph_facade.clear();
+}
+
+}  // namespace csapex
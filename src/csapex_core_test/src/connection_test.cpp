@@ -12,6 +12,7 @@
 #include <csapex/utility/uuid_provider.h>
 #include <csapex/utility/exceptions.h>
 #include <csapex/model/multi_connection_type.h>
+#include <csapex/model/connection_description.h>
 
 #include <csapex_testing/csapex_test_case.h>
 #include <csapex_testing/mockup_msgs.h>
@@ -345,3 +346,134 @@ TEST_F(ConnectionTest, MultiTokenDataAcceptsVector)
     ASSERT_TRUE(o_type->canConnectTo(i_type.get()));
     ASSERT_TRUE(i_type->canConnectTo(o_type.get()));
 }
+
+namespace
+{
+TokenPtr makeValueToken(int value)
+{
+    GenericValueMessage<int>::Ptr msg(new GenericValueMessage<int>);
+    msg->value = value;
+    return std::make_shared<Token>(msg);
+}
+
+int getValue(const TokenConstPtr& token)
+{
+    auto msg = std::dynamic_pointer_cast<GenericValueMessage<int> const>(token->getTokenData());
+    apex_assert_hard(msg);
+    return msg->value;
+}
+
+int consumeValue(const ConnectionPtr& connection)
+{
+    int value = getValue(connection->readToken());
+    connection->setTokenProcessed();
+    return value;
+}
+}  // namespace
+
+TEST_F(ConnectionTest, UnbufferedConnectionBlocksProducer)
+{
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+
+    ASSERT_FALSE(connection->isBuffered());
+
+    connection->setToken(makeValueToken(1), true);
+    ASSERT_EQ(Connection::State::UNREAD, connection->getState());
+    ASSERT_EQ(Connection::State::UNREAD, connection->getSourceState());
+}
+
+TEST_F(ConnectionTest, BufferedConnectionAcceptsTokensWhileConsumerIsBusy)
+{
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+
+    // the input has no transition, so it consumes every token that it is notified about
+    std::vector<int> received;
+    i->message_available.connect([&](Connection* c) { received.push_back(getValue(c->getToken())); });
+
+    connection->setBuffer(3, OverflowPolicy::BLOCK);
+    ASSERT_TRUE(connection->isBuffered());
+
+    connection->setToken(makeValueToken(1), true);
+    ASSERT_EQ(Connection::State::UNREAD, connection->getState());
+    ASSERT_EQ(Connection::State::DONE, connection->getSourceState());
+
+    connection->setToken(makeValueToken(2), true);
+    ASSERT_EQ(Connection::State::DONE, connection->getSourceState());
+
+    // the buffer is full now, the producer has to wait
+    connection->setToken(makeValueToken(3), true);
+    ASSERT_EQ(Connection::State::UNREAD, connection->getSourceState());
+    ASSERT_EQ(2, connection->getBufferedTokenCount());
+
+    ASSERT_EQ(1, consumeValue(connection));
+
+    ASSERT_EQ(std::vector<int>({ 2, 3 }), received);
+    ASSERT_EQ(Connection::State::DONE, connection->getState());
+    ASSERT_EQ(0, connection->getBufferedTokenCount());
+    ASSERT_EQ(0, connection->getDroppedTokenCount());
+}
+
+TEST_F(ConnectionTest, BufferedConnectionCanDropOldestToken)
+{
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+
+    std::vector<int> received;
+    i->message_available.connect([&](Connection* c) { received.push_back(getValue(c->getToken())); });
+
+    connection->setBuffer(2, OverflowPolicy::DROP_OLDEST);
+
+    for (int value = 1; value <= 4; ++value) {
+        connection->setToken(makeValueToken(value), true);
+        ASSERT_EQ(Connection::State::DONE, connection->getSourceState());
+    }
+
+    ASSERT_EQ(2, connection->getDroppedTokenCount());
+
+    // the token being processed is never dropped
+    ASSERT_EQ(1, consumeValue(connection));
+    ASSERT_EQ(std::vector<int>({ 4 }), received);
+}
+
+TEST_F(ConnectionTest, BufferedConnectionCanDropNewestToken)
+{
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+
+    std::vector<int> received;
+    i->message_available.connect([&](Connection* c) { received.push_back(getValue(c->getToken())); });
+
+    connection->setBuffer(2, OverflowPolicy::DROP_NEWEST);
+
+    for (int value = 1; value <= 4; ++value) {
+        connection->setToken(makeValueToken(value), true);
+    }
+
+    ASSERT_EQ(2, connection->getDroppedTokenCount());
+
+    ASSERT_EQ(1, consumeValue(connection));
+    ASSERT_EQ(std::vector<int>({ 2 }), received);
+}
+
+TEST_F(ConnectionTest, BufferIsPartOfTheDescription)
+{
+    OutputPtr o = std::make_shared<StaticOutput>(uuid_provider->makeUUID("out"));
+    InputPtr i = std::make_shared<Input>(uuid_provider->makeUUID("in"));
+    ConnectionPtr connection = DirectConnection::connect(o, i);
+
+    ConnectionDescription unbuffered = connection->getDescription();
+    ASSERT_EQ(1, unbuffered.buffer_size);
+    ASSERT_EQ(OverflowPolicy::BLOCK, unbuffered.overflow_policy);
+
+    connection->setBuffer(8, OverflowPolicy::DROP_NEWEST);
+
+    ConnectionDescription buffered = connection->getDescription();
+    ASSERT_EQ(8, buffered.buffer_size);
+    ASSERT_EQ(OverflowPolicy::DROP_NEWEST, buffered.overflow_policy);
+}
@@ -0,0 +1,244 @@
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/graph/vertex.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_state.h>
+#include <csapex/model/node_constructor.h>
+#include <csapex/model/node_modifier.h>
+#include <csapex/model/node_characteristics.h>
+#include <csapex/model/connection.h>
+#include <csapex/model/credit_account.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/input.h>
+#include <csapex/msg/io.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/node_constructing_test.h>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace csapex
+{
+class LaggingSink : public Node
+{
+public:
+    void setup(csapex::NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+    }
+
+    void process() override
+    {
+        int value = msg::getValue<int>(in);
+
+        // the number of token sets that the source has produced after the current one
+        int lag = source->getValue() - value - 1;
+        max_lag = std::max<int>(max_lag, lag);
+        received = value + 1;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    std::shared_ptr<MockupSource> source;
+
+    std::atomic<int> received{ 0 };
+    std::atomic<int> max_lag{ 0 };
+
+private:
+    Input* in;
+};
+
+class NothingProcessingNode : public Node
+{
+public:
+    void setup(csapex::NodeModifier& node_modifier) override
+    {
+        node_modifier.addInput<int>("input");
+    }
+
+    void process() override
+    {
+    }
+
+    bool processNothingMarkers() const override
+    {
+        return true;
+    }
+};
+
+class CreditFlowControlTest : public NodeConstructingTest
+{
+protected:
+    CreditFlowControlTest()
+    {
+        factory.registerNodeType(std::make_shared<NodeConstructor>("LaggingSink", []() { return std::make_shared<LaggingSink>(); }));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("NothingProcessingNode", []() { return std::make_shared<NothingProcessingNode>(); }));
+    }
+
+    NodeFacadeImplementationPtr makeNode(GraphFacadeImplementation& graph_facade, const std::string& type, const std::string& name)
+    {
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        EXPECT_NE(nullptr, nf);
+        graph_facade.addNode(nf);
+        return nf;
+    }
+
+    /**
+     * @brief runLaggingSink lets a fast source feed a slow sink over a large buffer
+     * @return the maximum number of token sets the source was ahead of the sink
+     */
+    int runLaggingSink(int credits, int frames)
+    {
+        // the source must not have to share its thread with the sink
+        ThreadPool threaded_executor(eh, true, false, false);
+        GraphFacadeImplementation main_graph_facade(threaded_executor, graph, graph_node);
+
+        NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+        NodeFacadeImplementationPtr sink_p = makeNode(main_graph_facade, "LaggingSink", "sink");
+        std::shared_ptr<LaggingSink> sink = std::dynamic_pointer_cast<LaggingSink>(sink_p->getNode());
+        sink->source = std::dynamic_pointer_cast<MockupSource>(src->getNode());
+
+        main_graph_facade.connect(src, "output", sink_p, "input")->setBuffer(32, OverflowPolicy::BLOCK);
+        sink_p->getNodeHandle()->getNodeState()->setCredits(credits);
+
+        threaded_executor.start();
+
+        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+        while (sink->received < frames && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        threaded_executor.stop();
+        main_graph_facade.clear();
+
+        EXPECT_GE(sink->received, frames);
+
+        return sink->max_lag;
+    }
+};
+
+TEST_F(CreditFlowControlTest, CreditsAreReturnedUpToTheLimit)
+{
+    CreditAccount account(2);
+    ASSERT_EQ(2, account.getAvailableCredits());
+
+    int granted = 0;
+    slim_signal::ScopedConnection connection = account.credit_granted.connect([&granted]() { ++granted; });
+
+    account.take();
+    account.take();
+    ASSERT_FALSE(account.hasCredit());
+
+    account.grant();
+    ASSERT_TRUE(account.hasCredit());
+    ASSERT_EQ(1, granted);
+
+    // surplus credits are not accumulated
+    account.grant();
+    account.grant();
+    ASSERT_EQ(2, account.getAvailableCredits());
+}
+
+TEST_F(CreditFlowControlTest, SourcesGetOneAccountPerSink)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    // src -> a -> {sink, other_sink}
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr a = makeNode(main_graph_facade, "StaticMultiplier", "a");
+    NodeFacadeImplementationPtr sink = makeNode(main_graph_facade, "MockupSink", "sink");
+    NodeFacadeImplementationPtr other_sink = makeNode(main_graph_facade, "MockupSink", "other_sink");
+
+    main_graph_facade.connect(src, "output", a, "input");
+    main_graph_facade.connect(a, "output", sink, "input");
+    main_graph_facade.connect(a, "output", other_sink, "input");
+
+    ASSERT_TRUE(src->getNodeHandle()->getCreditAccounts().empty());
+
+    sink->getNodeHandle()->getNodeState()->setCredits(3);
+    other_sink->getNodeHandle()->getNodeState()->setCredits(5);
+
+    std::vector<CreditAccountPtr> accounts = src->getNodeHandle()->getCreditAccounts();
+    ASSERT_EQ(2, accounts.size());
+    ASSERT_EQ(8, accounts[0]->getCredits() + accounts[1]->getCredits());
+    ASSERT_TRUE(a->getNodeHandle()->getCreditAccounts().empty());
+
+    // the token sets must not be pruned before they reach the sinks
+    ASSERT_TRUE(a->getNodeHandle()->getVertex()->getNodeCharacteristics().is_leading_to_essential_vertex);
+
+    sink->getNodeHandle()->getNodeState()->setCredits(0);
+    ASSERT_EQ(1, src->getNodeHandle()->getCreditAccounts().size());
+    ASSERT_EQ(5, src->getNodeHandle()->getCreditAccounts().front()->getCredits());
+
+    other_sink->getNodeHandle()->getNodeState()->setCredits(0);
+    ASSERT_TRUE(src->getNodeHandle()->getCreditAccounts().empty());
+}
+
+TEST_F(CreditFlowControlTest, NodesProcessingNoMessageDoNotHideOtherEssentialVertices)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    // added first, so that it is checked before the other vertices
+    makeNode(main_graph_facade, "NothingProcessingNode", "nothing");
+
+    // src -> a -> sink, where the input of sink is essential
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr a = makeNode(main_graph_facade, "StaticMultiplier", "a");
+    NodeFacadeImplementationPtr sink = makeNode(main_graph_facade, "MockupSink", "sink");
+
+    for (const InputPtr& input : sink->getNodeHandle()->getExternalInputs()) {
+        if (input->getLabel() == "input") {
+            input->setEssential(true);
+        }
+    }
+
+    main_graph_facade.connect(src, "output", a, "input");
+    main_graph_facade.connect(a, "output", sink, "input");
+
+    ASSERT_TRUE(a->getNodeHandle()->getVertex()->getNodeCharacteristics().is_leading_to_essential_vertex);
+    ASSERT_TRUE(src->getNodeHandle()->getVertex()->getNodeCharacteristics().is_leading_to_essential_vertex);
+}
+
+TEST_F(CreditFlowControlTest, CreditsAreSerialized)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr a = makeNode(main_graph_facade, "MockupSink", "a");
+    NodeFacadeImplementationPtr b = makeNode(main_graph_facade, "MockupSink", "b");
+
+    NodeStatePtr state = a->getNodeHandle()->getNodeState();
+    state->setCredits(4);
+
+    YAML::Node yaml;
+    state->writeYaml(yaml);
+
+    NodeStatePtr loaded = b->getNodeHandle()->getNodeState();
+    ASSERT_EQ(0, loaded->getCredits());
+    loaded->readYaml(yaml);
+    ASSERT_EQ(4, loaded->getCredits());
+
+    loaded->setCredits(-1);
+    ASSERT_EQ(0, loaded->getCredits());
+}
+
+TEST_F(CreditFlowControlTest, CreditsBoundTheTokensInFlight)
+{
+    const int credits = 2;
+    const int frames = 60;
+
+    int unbounded = runLaggingSink(0, frames);
+    int bounded = runLaggingSink(credits, frames);
+
+    // how far the sink lags behind without credits depends on the scheduling, so it is only reported
+    std::cout << "[ Credits ] maximum lag of the sink: without credits " << unbounded << ", with " << credits << " credits " << bounded << std::endl;
+
+    ASSERT_LE(bounded, credits);
+}
+
+}  // namespace csapex
@@ -0,0 +1,205 @@
+#include <csapex/model/token.h>
+#include <csapex/msg/input.h>
+#include <csapex/msg/static_output.h>
+#include <csapex/msg/direct_connection.h>
+#include <csapex/msg/io.h>
+#include <csapex/msg/no_message.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include <csapex_testing/csapex_test_case.h>
+#include <csapex_testing/mockup_msgs.h>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace csapex;
+using namespace connection_types;
+
+class FanOutTest : public CsApexTestCase
+{
+protected:
+    FanOutTest() : uuid_provider(std::make_shared<UUIDProvider>()), output(std::make_shared<StaticOutput>(uuid_provider->makeUUID("out")))
+    {
+        for (int i = 0; i < CONSUMERS; ++i) {
+            InputPtr input = std::make_shared<Input>(uuid_provider->makeUUID("in" + std::to_string(i)));
+            inputs.push_back(input);
+            connections.push_back(DirectConnection::connect(output, input));
+        }
+    }
+
+    TokenPtr makeImage()
+    {
+        // the size of a 4K rgb image
+        MockMessage::Ptr msg(new MockMessage);
+        msg->value.payload.assign(3840 * 2160 * 3, 'x');
+        return std::make_shared<Token>(msg);
+    }
+
+    void send(const TokenPtr& token)
+    {
+        for (const ConnectionPtr& connection : connections) {
+            connection->reset();
+            connection->setToken(token, true);
+        }
+    }
+
+    static constexpr int CONSUMERS = 5;
+
+    UUIDProviderPtr uuid_provider;
+    OutputPtr output;
+    std::vector<InputPtr> inputs;
+    std::vector<ConnectionPtr> connections;
+};
+
+TEST_F(FanOutTest, PayloadIsSharedByAllConnections)
+{
+    TokenPtr token = makeImage();
+    token->setActivityModifier(ActivityModifier::ACTIVATE);
+    send(token);
+
+    for (const ConnectionPtr& connection : connections) {
+        TokenPtr received = connection->getToken();
+        // each edge has its own token ...
+        ASSERT_NE(token, received);
+        // ... but they all refer to the same payload
+        ASSERT_EQ(token->getTokenData(), received->getTokenData());
+    }
+}
+
+TEST_F(FanOutTest, MutableAccessCopiesSharedPayload)
+{
+    TokenPtr token = makeImage();
+    send(token);
+
+    TokenPtr first = connections.front()->getToken();
+    ASSERT_TRUE(first->isTokenDataShared());
+
+    MockMessage::Ptr modified = std::dynamic_pointer_cast<MockMessage>(first->getMutableTokenData());
+    ASSERT_NE(nullptr, modified);
+    modified->value.payload = "modified";
+
+    ASSERT_FALSE(first->isTokenDataShared());
+    ASSERT_EQ(modified, first->getMutableTokenData());
+
+    // all other consumers still see the original
+    for (std::size_t i = 1; i < connections.size(); ++i) {
+        MockMessage::ConstPtr original = std::dynamic_pointer_cast<MockMessage const>(connections[i]->getToken()->getTokenData());
+        ASSERT_EQ(3840 * 2160 * 3, original->value.payload.size());
+    }
+}
+
+TEST_F(FanOutTest, InputsProvideMutableMessages)
+{
+    MockMessage::Ptr msg(new MockMessage);
+    msg->value.payload = "original";
+    inputs.front()->setToken(std::make_shared<Token>(msg));
+
+    MockMessage::Ptr mutable_msg = msg::getMutableMessage<MockMessage>(inputs.front().get());
+    // the test still holds a reference to the original
+    ASSERT_NE(msg, mutable_msg);
+    mutable_msg->value.payload = "modified";
+
+    ASSERT_EQ("original", msg->value.payload);
+    ASSERT_EQ("modified", msg::getMessage<MockMessage>(inputs.front().get())->value.payload);
+}
+
+TEST_F(FanOutTest, SingleConsumerModifiesRetainedPayloadInPlace)
+{
+    TokenPtr token = makeImage();
+    const TokenData* original = token->getTokenData().get();
+
+    ConnectionPtr connection = connections.front();
+    connection->setToken(token, true);
+    // the producer only keeps its token to republish
+    token->markAsRetained();
+
+    TokenPtr received = connection->getToken();
+    ASSERT_FALSE(received->isTokenDataShared());
+
+    TokenDataPtr modified = received->getMutableTokenData();
+    ASSERT_EQ(original, modified.get());
+    std::dynamic_pointer_cast<MockMessage>(modified)->value.payload = "modified";
+
+    // the payload is not handed out again while it is being modified
+    TokenPtr republished = token->clone();
+    ASSERT_NE(nullptr, std::dynamic_pointer_cast<NoMessage const>(republished->getTokenData()));
+}
+
+TEST_F(FanOutTest, ConcurrentClaimAndRepublishAgree)
+{
+    const int iterations = 2000;
+    for (int i = 0; i < iterations; ++i) {
+        TokenPtr token = std::make_shared<Token>(std::make_shared<MockMessage>());
+        const TokenData* original = token->getTokenData().get();
+        TokenPtr received = token->clone();
+        token->markAsRetained();
+
+        std::atomic<bool> go(false);
+        bool claimed = false;
+        std::thread consumer([&]() {
+            while (!go) {
+            }
+            claimed = received->getMutableTokenData().get() == original;
+        });
+
+        go = true;
+        TokenPtr republished = token->clone();
+        consumer.join();
+
+        // the payload is either claimed by the consumer or republished, never neither nor both
+        bool shared = republished->getTokenData().get() == original;
+        ASSERT_NE(claimed, shared) << "iteration " << i;
+        if (!shared) {
+            ASSERT_NE(nullptr, std::dynamic_pointer_cast<NoMessage const>(republished->getTokenData()));
+        }
+    }
+}
+
+TEST_F(FanOutTest, RetainedPayloadIsCopiedForSeveralConsumers)
+{
+    TokenPtr token = makeImage();
+    TokenDataConstPtr original = token->getTokenData();
+    send(token);
+    token->markAsRetained();
+
+    TokenPtr first = connections.front()->getToken();
+    ASSERT_TRUE(first->isTokenDataShared());
+    ASSERT_NE(original, first->getMutableTokenData());
+
+    // nothing has been modified in place, so the producer can still republish
+    ASSERT_EQ(original, token->clone()->getTokenData());
+}
+
+TEST_F(FanOutTest, FanOutDoesNotCopyThePayload)
+{
+    TokenPtr token = makeImage();
+    TokenDataConstPtr original = token->getTokenData();
+    const int iterations = 20;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        send(token);
+    }
+    auto shared = std::chrono::steady_clock::now() - start;
+
+    for (const ConnectionPtr& connection : connections) {
+        ASSERT_EQ(original, connection->getToken()->getTokenData());
+    }
+
+    // reference: one deep copy per consumer, as it was done before payloads were shared
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (int c = 0; c < CONSUMERS; ++c) {
+            TokenDataPtr copy = token->getTokenData()->cloneAs<TokenData>();
+            ASSERT_NE(nullptr, copy);
+        }
+    }
+    auto copied = std::chrono::steady_clock::now() - start;
+
+    double shared_us = std::chrono::duration<double, std::micro>(shared).count() / iterations;
+    double copied_us = std::chrono::duration<double, std::micro>(copied).count() / iterations;
+    std::cout << "[ FanOut ] 4K image to " << CONSUMERS << " consumers: shared " << shared_us << "us, deep copy " << copied_us << "us" << std::endl;
+}
@@ -0,0 +1,166 @@
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/graph/vertex.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_state.h>
+#include <csapex/model/node_characteristics.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/node_constructing_test.h>
+
+/// SYSTEM
+#include <chrono>
+#include <thread>
+
+namespace csapex
+{
+class FusionTest : public NodeConstructingTest
+{
+protected:
+    NodeFacadeImplementationPtr makeNode(GraphFacadeImplementation& graph_facade, const std::string& type, const std::string& name)
+    {
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        EXPECT_NE(nullptr, nf);
+        graph_facade.addNode(nf);
+        return nf;
+    }
+
+    const NodeCharacteristics& characteristics(const NodeFacadeImplementationPtr& nf)
+    {
+        return nf->getNodeHandle()->getVertex()->getNodeCharacteristics();
+    }
+
+    /**
+     * @brief runChain sends frames through a chain of cheap nodes, which are all executed by the same thread
+     * @return the time it took until the sink received the given number of frames
+     */
+    std::chrono::microseconds runChain(bool fusion, int stages, int frames)
+    {
+        graph->setFusionEnabled(fusion);
+
+        GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+        NodeFacadeImplementationPtr previous = makeNode(main_graph_facade, "MockupSource", "src");
+        for (int i = 0; i < stages; ++i) {
+            NodeFacadeImplementationPtr stage = makeNode(main_graph_facade, "StaticMultiplier", "stage" + std::to_string(i));
+            main_graph_facade.connect(previous, "output", stage, "input");
+            previous = stage;
+        }
+
+        NodeFacadeImplementationPtr sink_p = makeNode(main_graph_facade, "MockupSink", "sink");
+        std::shared_ptr<MockupSink> sink = std::dynamic_pointer_cast<MockupSink>(sink_p->getNode());
+        main_graph_facade.connect(previous, "output", sink_p, "input");
+
+        EXPECT_EQ(fusion ? 0 : -1, characteristics(sink_p).fused_chain);
+
+        const int expected = (frames - 1) << stages;
+
+        auto start = std::chrono::steady_clock::now();
+        executor.start();
+
+        auto timeout = start + std::chrono::seconds(20);
+        while (sink->getValue() < expected && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        executor.stop();
+
+        EXPECT_GE(sink->getValue(), expected);
+        // every frame has passed all stages
+        EXPECT_EQ(0, sink->getValue() % (1 << stages));
+
+        main_graph_facade.clear();
+
+        return duration;
+    }
+};
+
+TEST_F(FusionTest, LinearChainsAreFused)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    // src -> a -> b -> sink
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr a = makeNode(main_graph_facade, "StaticMultiplier", "a");
+    NodeFacadeImplementationPtr b = makeNode(main_graph_facade, "StaticMultiplier", "b");
+    NodeFacadeImplementationPtr sink = makeNode(main_graph_facade, "MockupSink", "sink");
+
+    main_graph_facade.connect(src, "output", a, "input");
+    main_graph_facade.connect(a, "output", b, "input");
+    main_graph_facade.connect(b, "output", sink, "input");
+
+    // src2 -> c -> {sink2, sink3}
+    NodeFacadeImplementationPtr src2 = makeNode(main_graph_facade, "MockupSource", "src2");
+    NodeFacadeImplementationPtr c = makeNode(main_graph_facade, "StaticMultiplier", "c");
+    NodeFacadeImplementationPtr sink2 = makeNode(main_graph_facade, "MockupSink", "sink2");
+    NodeFacadeImplementationPtr sink3 = makeNode(main_graph_facade, "MockupSink", "sink3");
+
+    main_graph_facade.connect(src2, "output", c, "input");
+    main_graph_facade.connect(c, "output", sink2, "input");
+    main_graph_facade.connect(c, "output", sink3, "input");
+
+    int chain = characteristics(src).fused_chain;
+    ASSERT_GE(chain, 0);
+    ASSERT_EQ(chain, characteristics(a).fused_chain);
+    ASSERT_EQ(chain, characteristics(b).fused_chain);
+    ASSERT_EQ(chain, characteristics(sink).fused_chain);
+
+    ASSERT_EQ(0, characteristics(src).fused_chain_position);
+    ASSERT_EQ(1, characteristics(a).fused_chain_position);
+    ASSERT_EQ(2, characteristics(b).fused_chain_position);
+    ASSERT_EQ(3, characteristics(sink).fused_chain_position);
+
+    // the fan out ends the second chain
+    int other_chain = characteristics(src2).fused_chain;
+    ASSERT_GE(other_chain, 0);
+    ASSERT_NE(chain, other_chain);
+    ASSERT_EQ(other_chain, characteristics(c).fused_chain);
+    ASSERT_EQ(-1, characteristics(sink2).fused_chain);
+    ASSERT_EQ(-1, characteristics(sink3).fused_chain);
+
+    graph->setFusionEnabled(false);
+    ASSERT_EQ(-1, characteristics(src).fused_chain);
+    ASSERT_EQ(-1, characteristics(a).fused_chain);
+}
+
+TEST_F(FusionTest, NodesInDifferentThreadsAreNotFused)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr a = makeNode(main_graph_facade, "StaticMultiplier", "a");
+    NodeFacadeImplementationPtr sink = makeNode(main_graph_facade, "MockupSink", "sink");
+
+    main_graph_facade.connect(src, "output", a, "input");
+    main_graph_facade.connect(a, "output", sink, "input");
+
+    // the chains are updated as soon as a node changes its thread
+    NodeStatePtr a_state = a->getNodeHandle()->getNodeState();
+    sink->getNodeHandle()->getNodeState()->setThread("other", 42);
+
+    ASSERT_GE(characteristics(src).fused_chain, 0);
+    ASSERT_EQ(characteristics(src).fused_chain, characteristics(a).fused_chain);
+    ASSERT_EQ(-1, characteristics(sink).fused_chain);
+
+    sink->getNodeHandle()->getNodeState()->setThread(a_state->getThreadName(), a_state->getThreadId());
+    ASSERT_EQ(characteristics(a).fused_chain, characteristics(sink).fused_chain);
+}
+
+TEST_F(FusionTest, FusedChainsDeliverTheSameResults)
+{
+    const int stages = 8;
+    const int frames = 500;
+
+    std::chrono::microseconds separate = runChain(false, stages, frames);
+    std::chrono::microseconds fused = runChain(true, stages, frames);
+
+    std::cout << "[ Fusion ] " << stages << " stages, " << frames << " frames: separate tasks " << separate.count() / 1000.0 << "ms, fused " << fused.count() / 1000.0 << "ms" << std::endl;
+
+    // the timings are only reported, they are too noisy on loaded machines to be asserted
+}
+
+}  // namespace csapex
@@ -0,0 +1,113 @@
+#include <csapex/msg/generic_vector_message.hpp>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/generic_pointer_message.hpp>
+
+#include <csapex_testing/csapex_test_case.h>
+#include <csapex_testing/mockup_msgs.h>
+
+using namespace csapex;
+using namespace connection_types;
+
+namespace
+{
+// large enough to be published as a pointer message
+struct LargeEntry
+{
+    int id;
+    char payload[1024 * 1024];
+};
+}  // namespace
+
+namespace YAML
+{
+template <>
+struct convert<LargeEntry>
+{
+    static Node encode(const LargeEntry& rhs)
+    {
+        Node node;
+        node["id"] = rhs.id;
+        return node;
+    }
+
+    static bool decode(const Node& node, LargeEntry& rhs)
+    {
+        rhs.id = node["id"].as<int>();
+        return true;
+    }
+};
+}  // namespace YAML
+
+class GenericVectorMessageTest : public CsApexTestCase
+{
+};
+
+TEST_F(GenericVectorMessageTest, ValuesAreCollectedInOneBuffer)
+{
+    GenericVectorMessage::Ptr vector = GenericVectorMessage::make(std::make_shared<GenericValueMessage<int>>());
+    for (int i = 0; i < 100; ++i) {
+        vector->addNestedValue(std::make_shared<GenericValueMessage<int>>(i));
+    }
+    ASSERT_EQ(100, vector->nestedValueCount());
+
+    // the collected values are handed out without copying them
+    std::shared_ptr<std::vector<int> const> values = vector->makeShared<int>();
+    ASSERT_EQ(values, vector->makeShared<int>());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(i, values->at(i));
+    }
+
+    auto entry = std::dynamic_pointer_cast<GenericValueMessage<int> const>(vector->nestedValue(42));
+    ASSERT_NE(nullptr, entry);
+    ASSERT_EQ(42, entry->value);
+
+    // other entries are still kept as individual tokens
+    GenericVectorMessage::Ptr mocks = GenericVectorMessage::make(std::make_shared<MockMessage>());
+    auto mock = std::make_shared<MockMessage>();
+    mock->value.payload = "mock";
+    mocks->addNestedValue(mock);
+    ASSERT_EQ(1, mocks->nestedValueCount());
+    ASSERT_EQ("mock", std::dynamic_pointer_cast<MockMessage const>(mocks->nestedValue(0))->value.payload);
+}
+
+TEST_F(GenericVectorMessageTest, SharedBuffersAreCopiedOnWrite)
+{
+    GenericVectorMessage::Ptr vector = GenericVectorMessage::make<double>();
+    vector->addNestedValue(std::make_shared<GenericValueMessage<double>>(1.0));
+
+    std::shared_ptr<std::vector<double> const> before = vector->makeShared<double>();
+    vector->addNestedValue(std::make_shared<GenericValueMessage<double>>(2.0));
+
+    ASSERT_EQ(1, before->size());
+    ASSERT_EQ(2, vector->makeShared<double>()->size());
+    ASSERT_NE(before, vector->makeShared<double>());
+
+    // a clone has a buffer of its own
+    GenericVectorMessage::Ptr clone = vector->cloneAs<GenericVectorMessage>();
+    clone->addNestedValue(std::make_shared<GenericValueMessage<double>>(3.0));
+    ASSERT_EQ(2, vector->nestedValueCount());
+    ASSERT_EQ(3, clone->nestedValueCount());
+}
+
+TEST_F(GenericVectorMessageTest, LargeEntriesAreViewedInPlace)
+{
+    GenericVectorMessage::Ptr vector = GenericVectorMessage::make<LargeEntry>();
+    for (int i = 0; i < 3; ++i) {
+        auto entry = std::make_shared<GenericPointerMessage<LargeEntry>>();
+        entry->value = std::make_shared<LargeEntry>();
+        entry->value->id = i;
+        vector->addNestedValue(entry);
+    }
+
+    std::shared_ptr<std::vector<LargeEntry> const> buffer = vector->makeShared<LargeEntry>();
+    ASSERT_EQ(3, buffer->size());
+
+    auto view = std::dynamic_pointer_cast<GenericPointerMessage<LargeEntry> const>(vector->nestedValue(1));
+    ASSERT_NE(nullptr, view);
+    ASSERT_EQ(&buffer->at(1), view->value.get());
+
+    // the view keeps the buffer alive
+    buffer.reset();
+    vector.reset();
+    ASSERT_EQ(1, view->value->id);
+}
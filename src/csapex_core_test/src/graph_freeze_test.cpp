@@ -0,0 +1,142 @@
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/connection.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/msg/input_transition.h>
+#include <csapex/msg/output_transition.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/node_constructing_test.h>
+
+/// SYSTEM
+#include <chrono>
+#include <thread>
+
+namespace csapex
+{
+class GraphFreezeTest : public NodeConstructingTest
+{
+protected:
+    NodeFacadeImplementationPtr makeNode(GraphFacadeImplementation& graph_facade, const std::string& type, const std::string& name)
+    {
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        EXPECT_NE(nullptr, nf);
+        graph_facade.addNode(nf);
+        return nf;
+    }
+
+};
+
+TEST_F(GraphFreezeTest, AllNodesAreFrozen)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr a = makeNode(main_graph_facade, "StaticMultiplier", "a");
+    NodeFacadeImplementationPtr b = makeNode(main_graph_facade, "StaticMultiplier", "b");
+    NodeFacadeImplementationPtr c = makeNode(main_graph_facade, "DynamicMultiplier", "c");
+    NodeFacadeImplementationPtr sink = makeNode(main_graph_facade, "MockupSink", "sink");
+
+    main_graph_facade.connect(src, "output", a, "input");
+    main_graph_facade.connect(src, "output", b, "input");
+    main_graph_facade.connect(a, "output", c, "input_a");
+    main_graph_facade.connect(b, "output", c, "input_b");
+    main_graph_facade.connect(c, "output", sink, "input");
+
+    ASSERT_FALSE(graph->isFrozen());
+    graph->freeze();
+    ASSERT_TRUE(graph->isFrozen());
+
+    for (const NodeFacadeImplementationPtr& nf : { src, a, b, c, sink }) {
+        ASSERT_TRUE(nf->getNodeHandle()->isFrozen());
+        ASSERT_TRUE(nf->getNodeHandle()->getInputTransition()->isFrozen());
+        ASSERT_TRUE(nf->getNodeHandle()->getOutputTransition()->isFrozen());
+    }
+
+    ASSERT_TRUE(src->getNodeHandle()->isSource());
+    ASSERT_TRUE(sink->getNodeHandle()->isSink());
+
+    graph->thaw();
+    for (const NodeFacadeImplementationPtr& nf : { src, a, b, c, sink }) {
+        ASSERT_FALSE(nf->getNodeHandle()->isFrozen());
+        ASSERT_FALSE(nf->getNodeHandle()->getInputTransition()->isFrozen());
+    }
+
+    main_graph_facade.clear();
+}
+
+TEST_F(GraphFreezeTest, EditsFallBackToDynamicExecution)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr sink = makeNode(main_graph_facade, "MockupSink", "sink");
+    ConnectionPtr connection = main_graph_facade.connect(src, "output", sink, "input");
+
+    graph->freeze();
+    ASSERT_TRUE(sink->getNodeHandle()->isFrozen());
+
+    // adding a node
+    NodeFacadeImplementationPtr other = makeNode(main_graph_facade, "MockupSink", "other");
+    ASSERT_FALSE(graph->isFrozen());
+    ASSERT_FALSE(sink->getNodeHandle()->isFrozen());
+    ASSERT_FALSE(sink->getNodeHandle()->getInputTransition()->isFrozen());
+
+    // adding a connection
+    graph->freeze();
+    main_graph_facade.connect(src, "output", other, "input");
+    ASSERT_FALSE(graph->isFrozen());
+    ASSERT_FALSE(src->getNodeHandle()->getOutputTransition()->isFrozen());
+
+    // removing a connection
+    graph->freeze();
+    ASSERT_TRUE(src->getNodeHandle()->getOutputTransition()->isFrozen());
+    graph->deleteConnection(connection);
+    ASSERT_FALSE(graph->isFrozen());
+    ASSERT_FALSE(sink->getNodeHandle()->areRequiredInputsConnected());
+
+    // the snapshots of the transitions do not keep the removed connection alive
+    std::weak_ptr<Connection> removed = connection;
+    connection.reset();
+    ASSERT_TRUE(removed.expired());
+
+    main_graph_facade.clear();
+}
+
+TEST_F(GraphFreezeTest, FrozenGraphsDeliverTheSameResults)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+    NodeFacadeImplementationPtr a = makeNode(main_graph_facade, "StaticMultiplier", "a");
+    NodeFacadeImplementationPtr b = makeNode(main_graph_facade, "StaticMultiplier", "b");
+    NodeFacadeImplementationPtr sink_p = makeNode(main_graph_facade, "MockupSink", "sink");
+    std::shared_ptr<MockupSink> sink = std::dynamic_pointer_cast<MockupSink>(sink_p->getNode());
+
+    main_graph_facade.connect(src, "output", a, "input");
+    main_graph_facade.connect(a, "output", b, "input");
+    main_graph_facade.connect(b, "output", sink_p, "input");
+
+    graph->freeze();
+
+    executor.start();
+
+    const int expected = 100 * 4;
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (sink->getValue() < expected && std::chrono::steady_clock::now() < timeout) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    executor.stop();
+
+    ASSERT_TRUE(graph->isFrozen());
+    ASSERT_GE(sink->getValue(), expected);
+    ASSERT_EQ(0, sink->getValue() % 4);
+
+    main_graph_facade.clear();
+}
+
+}  // namespace csapex
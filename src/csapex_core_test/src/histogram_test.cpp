@@ -0,0 +1,58 @@
+#include <csapex/profiling/histogram.h>
+
+#include <csapex_testing/csapex_test_case.h>
+
+using namespace csapex;
+
+class HistogramTest : public CsApexTestCase
+{
+protected:
+    Histogram histogram;
+};
+
+TEST_F(HistogramTest, EmptyHistogramIsZero)
+{
+    ASSERT_EQ(0, histogram.count());
+    ASSERT_EQ(0.0, histogram.getMean());
+    ASSERT_EQ(0.0, histogram.getPercentile(0.5));
+}
+
+TEST_F(HistogramTest, ValuesAreSortedIntoPowersOfTwo)
+{
+    histogram.add(0.5);
+    histogram.add(1.0);
+    histogram.add(3.0);
+    histogram.add(4.0);
+
+    const std::vector<std::size_t>& buckets = histogram.getBuckets();
+    ASSERT_EQ(1, buckets[0]);
+    ASSERT_EQ(1, buckets[1]);
+    ASSERT_EQ(1, buckets[2]);
+    ASSERT_EQ(1, buckets[3]);
+
+    ASSERT_EQ(4, histogram.count());
+    ASSERT_DOUBLE_EQ(2.125, histogram.getMean());
+    ASSERT_DOUBLE_EQ(4.0, histogram.getMax());
+}
+
+TEST_F(HistogramTest, PercentilesAreBoundedByTheirBucket)
+{
+    for (int i = 0; i < 99; ++i) {
+        histogram.add(10.0);
+    }
+    histogram.add(1000.0);
+
+    // 10 lies in [8, 16)
+    ASSERT_DOUBLE_EQ(16.0, histogram.getPercentile(0.5));
+    ASSERT_DOUBLE_EQ(16.0, histogram.getPercentile(0.99));
+    ASSERT_DOUBLE_EQ(1000.0, histogram.getPercentile(1.0));
+}
+
+TEST_F(HistogramTest, ResetClearsAllValues)
+{
+    histogram.add(42.0);
+    histogram.reset();
+
+    ASSERT_EQ(0, histogram.count());
+    ASSERT_EQ(0.0, histogram.getMax());
+}
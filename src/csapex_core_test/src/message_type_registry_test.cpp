@@ -0,0 +1,93 @@
+#include <csapex/msg/message_type_registry.h>
+#include <csapex/msg/any_message.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/generic_vector_message.hpp>
+#include <csapex/msg/io.h>
+
+#include <csapex_testing/csapex_test_case.h>
+#include <csapex_testing/mockup_msgs.h>
+
+using namespace csapex;
+using namespace connection_types;
+
+namespace
+{
+class DerivedMockMessage : public MockMessage
+{
+public:
+    int extra = 0;
+};
+
+template <typename R>
+void expectSameAsDynamicCast(const TokenData::ConstPtr& msg)
+{
+    bool expected = std::dynamic_pointer_cast<R const>(msg) != nullptr;
+    EXPECT_EQ(expected, MessageTypeRegistry::isInstance<R>(*msg)) << msg->typeName() << " -> " << type2name(typeid(R));
+    EXPECT_EQ(expected, MessageTypeRegistry::cast<R>(msg.get()) != nullptr) << msg->typeName() << " -> " << type2name(typeid(R));
+    if (expected) {
+        // message_cast may convert between unrelated types, only hits have to be the same object
+        EXPECT_EQ(msg.get(), msg::message_cast<R const>(msg).get()) << msg->typeName() << " -> " << type2name(typeid(R));
+    }
+}
+}  // namespace
+
+class MessageTypeRegistryTest : public CsApexTestCase
+{
+};
+
+TEST_F(MessageTypeRegistryTest, CastsAgreeWithDynamicCast)
+{
+    std::vector<TokenData::ConstPtr> messages{ std::make_shared<GenericValueMessage<int>>(1),
+                                               std::make_shared<GenericValueMessage<double>>(2.0),
+                                               std::make_shared<MockMessage>(),
+                                               std::make_shared<DerivedMockMessage>(),
+                                               GenericVectorMessage::make<int>(),
+                                               std::make_shared<AnyMessage>() };
+
+    // twice, so that both the first check and the cached relations are compared
+    for (int pass = 0; pass < 2; ++pass) {
+        for (const TokenData::ConstPtr& msg : messages) {
+            expectSameAsDynamicCast<TokenData>(msg);
+            expectSameAsDynamicCast<Message>(msg);
+            expectSameAsDynamicCast<GenericValueMessage<int>>(msg);
+            expectSameAsDynamicCast<GenericValueMessage<double>>(msg);
+            expectSameAsDynamicCast<MockMessage>(msg);
+            expectSameAsDynamicCast<DerivedMockMessage>(msg);
+            expectSameAsDynamicCast<GenericVectorMessage>(msg);
+            expectSameAsDynamicCast<AnyMessage>(msg);
+        }
+    }
+
+    ASSERT_EQ(nullptr, MessageTypeRegistry::cast<MockMessage>(nullptr));
+}
+
+TEST_F(MessageTypeRegistryTest, DynamicTypeIdIsTheMostDerivedType)
+{
+    auto mock = std::make_shared<MockMessage>();
+    auto derived = std::make_shared<DerivedMockMessage>();
+
+    MessageTypeRegistry::Id mock_id = MessageTypeRegistry::id<MockMessage>();
+    MessageTypeRegistry::Id derived_id = MessageTypeRegistry::id<DerivedMockMessage>();
+    ASSERT_NE(MessageTypeRegistry::UNKNOWN, mock_id);
+    ASSERT_NE(mock_id, derived_id);
+    ASSERT_EQ(mock_id, MessageTypeRegistry::id<MockMessage>());
+    ASSERT_EQ(mock_id, MessageTypeRegistry::getId(typeid(MockMessage)));
+
+    ASSERT_EQ(mock_id, mock->dynamicTypeId());
+    ASSERT_EQ(derived_id, derived->dynamicTypeId());
+
+    // accessed through a base pointer, the type is the same
+    const TokenData& as_token = *derived;
+    ASSERT_EQ(derived_id, as_token.dynamicTypeId());
+
+    // clones and copies are of the same type
+    ASSERT_EQ(mock_id, mock->cloneAs<MockMessage>()->dynamicTypeId());
+    DerivedMockMessage copy(*derived);
+    ASSERT_EQ(derived_id, copy.dynamicTypeId());
+
+    // assigning the base part does not change the type of an object
+    MockMessage& base = copy;
+    base = *mock;
+    ASSERT_EQ(derived_id, copy.dynamicTypeId());
+    ASSERT_TRUE(MessageTypeRegistry::isInstance<DerivedMockMessage>(copy));
+}
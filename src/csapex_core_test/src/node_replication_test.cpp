@@ -0,0 +1,233 @@
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/graph/vertex.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_state.h>
+#include <csapex/model/node_constructor.h>
+#include <csapex/model/node_modifier.h>
+#include <csapex/model/node_worker.h>
+#include <csapex/model/node_characteristics.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/io.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/node_constructing_test.h>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+namespace csapex
+{
+class SlowStatelessNode : public Node
+{
+public:
+    void setup(csapex::NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void process() override
+    {
+        int value = msg::getValue<int>(in);
+
+        int now_active = ++active;
+        int max = max_active;
+        while (now_active > max && !max_active.compare_exchange_weak(max, now_active)) {
+        }
+
+        // vary the processing time, so that the replicas finish out of order
+        std::this_thread::sleep_for(std::chrono::milliseconds(STAGE_TIME_MS + (value % 3) * STAGE_TIME_MS));
+        --active;
+        msg::publish(out, value);
+    }
+
+    bool isReplicable() const override
+    {
+        return true;
+    }
+
+    static constexpr int STAGE_TIME_MS = 5;
+
+    // number of copies that are processing at the same time
+    static inline std::atomic<int> active{ 0 };
+    static inline std::atomic<int> max_active{ 0 };
+
+private:
+    Input* in;
+    Output* out;
+};
+
+class StatefulNode : public SlowStatelessNode
+{
+public:
+    bool isReplicable() const override
+    {
+        return false;
+    }
+};
+
+class OrderRecorder : public Node
+{
+public:
+    void setup(csapex::NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+    }
+
+    void process() override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        values.push_back(msg::getValue<int>(in));
+    }
+
+    std::vector<int> getValues() const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return values;
+    }
+
+private:
+    Input* in;
+
+    mutable std::mutex mutex;
+    std::vector<int> values;
+};
+
+class NodeReplicationTest : public NodeConstructingTest
+{
+protected:
+    NodeReplicationTest()
+    {
+        factory.registerNodeType(std::make_shared<NodeConstructor>("SlowStatelessNode", []() { return std::make_shared<SlowStatelessNode>(); }));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("StatefulNode", []() { return std::make_shared<StatefulNode>(); }));
+        factory.registerNodeType(std::make_shared<NodeConstructor>("OrderRecorder", []() { return std::make_shared<OrderRecorder>(); }));
+    }
+
+    NodeFacadeImplementationPtr makeNode(GraphFacadeImplementation& graph_facade, const std::string& type, const std::string& name)
+    {
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        EXPECT_NE(nullptr, nf);
+        graph_facade.addNode(nf);
+        return nf;
+    }
+
+    struct WorkerResult
+    {
+        std::chrono::milliseconds duration;
+        int max_active_copies;
+    };
+
+    /**
+     * @brief runWorker sends frames through a slow node with the given number of replicas, the frames have to arrive in order
+     * @return the time it took until the recorder received the given number of frames and the maximum number of copies that processed at once
+     */
+    WorkerResult runWorker(const std::string& type, int replicas, int frames, bool expect_replicated)
+    {
+        SlowStatelessNode::max_active = 0;
+
+        GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+        NodeFacadeImplementationPtr src = makeNode(main_graph_facade, "MockupSource", "src");
+        NodeFacadeImplementationPtr worker = makeNode(main_graph_facade, type, "worker");
+        worker->getNodeHandle()->getNodeState()->setReplicas(replicas);
+
+        NodeFacadeImplementationPtr recorder_p = makeNode(main_graph_facade, "OrderRecorder", "recorder");
+        std::shared_ptr<OrderRecorder> recorder = std::dynamic_pointer_cast<OrderRecorder>(recorder_p->getNode());
+
+        main_graph_facade.connect(src, "output", worker, "input");
+        main_graph_facade.connect(worker, "output", recorder_p, "input");
+
+        // the replicas are executed by the thread group of the node, so it needs enough workers to run them concurrently
+        ThreadGroup* group = executor.getDefaultGroup();
+        group->setWorkerCount(replicas);
+
+        auto start = std::chrono::steady_clock::now();
+        executor.start();
+
+        auto timeout = start + std::chrono::seconds(20);
+        while (recorder->getValues().size() < static_cast<std::size_t>(frames) && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        EXPECT_EQ(expect_replicated, worker->getNodeWorker().lock()->isReplicated());
+        // source, worker and recorder plus one generator per replica
+        EXPECT_EQ(expect_replicated ? 3 + replicas : 3, static_cast<int>(std::distance(group->begin(), group->end())));
+
+        executor.stop();
+        main_graph_facade.clear();
+
+        std::vector<int> values = recorder->getValues();
+        EXPECT_GE(values.size(), frames);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            EXPECT_EQ(static_cast<int>(i), values[i]);
+        }
+
+        return WorkerResult{ duration, SlowStatelessNode::max_active };
+    }
+};
+
+TEST_F(NodeReplicationTest, NodesDeclareWhetherTheyAreReplicable)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr stateless = makeNode(main_graph_facade, "SlowStatelessNode", "stateless");
+    NodeFacadeImplementationPtr stateful = makeNode(main_graph_facade, "StatefulNode", "stateful");
+
+    ASSERT_TRUE(stateless->getNodeHandle()->getVertex()->getNodeCharacteristics().is_replicable);
+    ASSERT_FALSE(stateful->getNodeHandle()->getVertex()->getNodeCharacteristics().is_replicable);
+}
+
+TEST_F(NodeReplicationTest, ReplicaCountIsPersisted)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    NodeFacadeImplementationPtr a = makeNode(main_graph_facade, "SlowStatelessNode", "a");
+    NodeFacadeImplementationPtr b = makeNode(main_graph_facade, "SlowStatelessNode", "b");
+
+    NodeStatePtr state = a->getNodeHandle()->getNodeState();
+    state->setReplicas(4);
+
+    YAML::Node yaml;
+    state->writeYaml(yaml);
+
+    NodeStatePtr loaded = b->getNodeHandle()->getNodeState();
+    ASSERT_EQ(1, loaded->getReplicas());
+    loaded->readYaml(yaml);
+    ASSERT_EQ(4, loaded->getReplicas());
+
+    loaded->setReplicas(0);
+    ASSERT_EQ(1, loaded->getReplicas());
+}
+
+TEST_F(NodeReplicationTest, NonReplicableNodesIgnoreTheReplicaCount)
+{
+    WorkerResult result = runWorker("StatefulNode", 4, 10, false);
+    ASSERT_EQ(1, result.max_active_copies);
+}
+
+TEST_F(NodeReplicationTest, ReplicasKeepTheOrderOfTheTokens)
+{
+    const int frames = 40;
+
+    WorkerResult single = runWorker("SlowStatelessNode", 1, frames, false);
+    WorkerResult replicated = runWorker("SlowStatelessNode", 4, frames, true);
+
+    std::cout << "[ Replication ] " << frames << " frames: single " << single.duration.count() << "ms, 4 replicas " << replicated.duration.count() << "ms, copies active at once: "
+              << replicated.max_active_copies << std::endl;
+
+    ASSERT_EQ(1, single.max_active_copies);
+    ASSERT_GE(replicated.max_active_copies, 2);
+    ASSERT_LE(replicated.max_active_copies, 4);
+}
+
+}  // namespace csapex
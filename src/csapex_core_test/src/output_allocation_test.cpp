@@ -3,10 +3,12 @@
 #include <csapex/model/graph/graph_impl.h>
 #include <csapex/model/execution_type.h>
 #include <csapex/model/node_state.h>
+#include <csapex/model/token.h>
 #include <csapex/msg/message_allocator.h>
 #include <csapex/msg/output.h>
 
 #include <csapex_testing/test_exception_handler.h>
+#include <csapex_testing/mockup_msgs.h>
 #include <csapex_testing/mockup_nodes.h>
 #include <csapex_testing/stepping_test.h>
 #include <csapex_testing/io.h>
@@ -157,6 +159,124 @@ TEST_F(OutputAllocationTest, AllocatorCanBeSet)
     EXPECT_STREQ("frame", msgptr->frame_id.c_str());
 }
 
+TEST_F(OutputAllocationTest, MessagesAreRecycledOnceReleased)
+{
+    using M = connection_types::VectorMessage;
+
+    MessageAllocator allocator;
+    ASSERT_TRUE(allocator.isPooling());
+
+    M::Ptr first = allocator.allocate<M>();
+    first->value.push_back(Foo(1));
+    first->frame_id = "first";
+    first->stamp_micro_seconds = 42;
+    M* first_address = first.get();
+
+    // the first message is still in use
+    M::Ptr second = allocator.allocate<M>();
+    ASSERT_NE(first_address, second.get());
+    ASSERT_EQ(0, allocator.getPoolHits());
+    ASSERT_EQ(2, allocator.getPoolMisses());
+
+    first.reset();
+    M::Ptr third = allocator.allocate<M>();
+    ASSERT_EQ(first_address, third.get());
+    ASSERT_EQ(1, allocator.getPoolHits());
+    ASSERT_EQ(2, allocator.getPoolSize());
+
+    // allocated messages are always initialized freshly
+    EXPECT_TRUE(third->value.empty());
+    EXPECT_TRUE(third->frame_id.empty());
+    EXPECT_EQ(0, third->stamp_micro_seconds);
+}
+
+TEST_F(OutputAllocationTest, RecycledMessagesKeepTheirBuffers)
+{
+    using M = connection_types::VectorMessage;
+
+    MessageAllocator allocator;
+
+    M::Ptr msg = allocator.recycle<M>();
+    msg->value.resize(1024);
+    M* address = msg.get();
+    const Foo* buffer = msg->value.data();
+
+    msg.reset();
+    msg = allocator.recycle<M>();
+    ASSERT_EQ(address, msg.get());
+    ASSERT_EQ(buffer, msg->value.data());
+    ASSERT_GE(msg->value.capacity(), 1024);
+    ASSERT_EQ(1, allocator.getPoolHits());
+}
+
+TEST_F(OutputAllocationTest, PooledMessagesAreNotSharedWithThePool)
+{
+    using M = connection_types::VectorMessage;
+
+    MessageAllocator allocator;
+
+    M::Ptr msg = allocator.allocate<M>();
+    M* address = msg.get();
+    ASSERT_EQ(1, msg.use_count());
+
+    // a single consumer can take over the message without copying
+    TokenPtr produced = std::make_shared<Token>(msg);
+    msg.reset();
+    TokenPtr consumed = produced->clone();
+    produced->markAsRetained();
+    ASSERT_EQ(address, consumed->getMutableTokenData().get());
+
+    // and the message is recycled once it is released
+    produced.reset();
+    consumed.reset();
+    ASSERT_EQ(address, allocator.allocate<M>().get());
+    ASSERT_EQ(1, allocator.getPoolHits());
+}
+
+TEST_F(OutputAllocationTest, PoolIsBounded)
+{
+    using M = connection_types::VectorMessage;
+
+    MessageAllocator allocator;
+    allocator.setPoolCapacity(2);
+
+    std::vector<M::Ptr> in_use;
+    for (int i = 0; i < 4; ++i) {
+        in_use.push_back(allocator.allocate<M>());
+    }
+    ASSERT_EQ(2, allocator.getPoolSize());
+    in_use.clear();
+
+    for (int i = 0; i < 4; ++i) {
+        in_use.push_back(allocator.allocate<M>());
+    }
+    ASSERT_EQ(2, allocator.getPoolHits());
+    ASSERT_EQ(6, allocator.getPoolMisses());
+}
+
+TEST_F(OutputAllocationTest, PoolingCanBeDisabled)
+{
+    using M = connection_types::VectorMessage;
+
+    MessageAllocator allocator;
+
+    // only messages generated from MessageTemplate are pooled
+    allocator.allocate<connection_types::GenericValueMessage<int>>(42);
+    ASSERT_EQ(0, allocator.getPoolMisses());
+
+    allocator.allocate<M>();
+    ASSERT_EQ(1, allocator.getPoolSize());
+
+    allocator.setPooling(false);
+    ASSERT_EQ(0, allocator.getPoolSize());
+
+    M* address = allocator.allocate<M>().get();
+    ASSERT_NE(nullptr, address);
+    ASSERT_EQ(0, allocator.getPoolSize());
+    ASSERT_EQ(0, allocator.getPoolHits());
+    ASSERT_EQ(1, allocator.getPoolMisses());
+}
+
 using namespace boost::interprocess;
 
 template <typename T>
@@ -0,0 +1,180 @@
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_state.h>
+#include <csapex/model/node_constructor.h>
+#include <csapex/model/node_modifier.h>
+#include <csapex/model/connection.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/io.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/node_constructing_test.h>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace csapex
+{
+class SlowForwarder : public Node
+{
+public:
+    void setup(csapex::NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void process() override
+    {
+        int value = msg::getValue<int>(in);
+        if (value <= last_value) {
+            out_of_order = true;
+        }
+        last_value = value;
+
+        int now_active = ++active;
+        int max = max_active;
+        while (now_active > max && !max_active.compare_exchange_weak(max, now_active)) {
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(STAGE_TIME_MS));
+        --active;
+        msg::publish(out, value);
+    }
+
+    static constexpr int STAGE_TIME_MS = 10;
+
+    // number of stages that are processing at the same time, over all instances
+    static inline std::atomic<int> active{ 0 };
+    static inline std::atomic<int> max_active{ 0 };
+
+    std::atomic<int> last_value{ -1 };
+    std::atomic<bool> out_of_order{ false };
+
+private:
+    Input* in;
+    Output* out;
+};
+
+class PipeliningTest : public NodeConstructingTest
+{
+protected:
+    PipeliningTest()
+    {
+        factory.registerNodeType(std::make_shared<NodeConstructor>("SlowForwarder", []() { return std::make_shared<SlowForwarder>(); }));
+    }
+
+    NodeFacadeImplementationPtr makeNode(const std::string& type, const std::string& name, ExecutionMode mode)
+    {
+        NodeStatePtr state = std::make_shared<NodeState>(nullptr);
+        state->setExecutionMode(mode);
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph, state);
+
+        EXPECT_NE(nullptr, nf);
+
+        return nf;
+    }
+
+    struct ChainResult
+    {
+        std::chrono::milliseconds duration;
+        int max_active_stages;
+    };
+
+    /**
+     * @brief runChain sends frames through a chain of slow nodes, each with its own thread
+     * @return the time it took until the sink received the given number of frames and the maximum number of stages that were busy at once
+     */
+    ChainResult runChain(ExecutionMode mode, int stages, int frames)
+    {
+        SlowForwarder::max_active = 0;
+
+        ThreadPool threaded_executor(eh, true, false, false);
+        GraphFacadeImplementation main_graph_facade(threaded_executor, graph, graph_node);
+
+        NodeFacadeImplementationPtr src = makeNode("MockupSource", "src", mode);
+        main_graph_facade.addNode(src);
+
+        NodeFacadeImplementationPtr previous = src;
+        std::vector<std::shared_ptr<SlowForwarder>> forwarders;
+        for (int i = 0; i < stages; ++i) {
+            NodeFacadeImplementationPtr stage = makeNode("SlowForwarder", "stage" + std::to_string(i), mode);
+            main_graph_facade.addNode(stage);
+            main_graph_facade.connect(previous, "output", stage, "input");
+            forwarders.push_back(std::dynamic_pointer_cast<SlowForwarder>(stage->getNode()));
+            previous = stage;
+        }
+
+        NodeFacadeImplementationPtr sink_p = makeNode("MockupSink", "sink", mode);
+        main_graph_facade.addNode(sink_p);
+        std::shared_ptr<MockupSink> sink = std::dynamic_pointer_cast<MockupSink>(sink_p->getNode());
+        main_graph_facade.connect(previous, "output", sink_p, "input");
+
+        auto start = std::chrono::steady_clock::now();
+        threaded_executor.start();
+
+        auto timeout = start + std::chrono::seconds(20);
+        while (sink->getValue() < frames && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        threaded_executor.stop();
+        main_graph_facade.clear();
+
+        EXPECT_GE(sink->getValue(), frames);
+        for (const auto& forwarder : forwarders) {
+            EXPECT_FALSE(forwarder->out_of_order);
+        }
+
+        return ChainResult{ duration, SlowForwarder::max_active };
+    }
+};
+
+TEST_F(PipeliningTest, PipeliningNodesAcceptTheNextTokenEarly)
+{
+    NodeFacadeImplementationPtr src = makeNode("MockupSource", "src", ExecutionMode::PIPELINING);
+    NodeFacadeImplementationPtr stage = makeNode("SlowForwarder", "stage", ExecutionMode::SEQUENTIAL);
+
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+    main_graph_facade.addNode(src);
+    main_graph_facade.addNode(stage);
+    ConnectionPtr connection = main_graph_facade.connect(src, "output", stage, "input");
+
+    ASSERT_FALSE(connection->isPipelining());
+    ASSERT_FALSE(connection->isBuffered());
+
+    stage->getNodeHandle()->getNodeState()->setExecutionMode(ExecutionMode::PIPELINING);
+    ASSERT_TRUE(connection->isPipelining());
+    ASSERT_TRUE(connection->isBuffered());
+    // the user configured buffer is not changed
+    ASSERT_EQ(1, connection->getBufferCapacity());
+
+    stage->getNodeHandle()->getNodeState()->setExecutionMode(ExecutionMode::SEQUENTIAL);
+    ASSERT_FALSE(connection->isPipelining());
+}
+
+TEST_F(PipeliningTest, DeepChainsOverlapTheirStages)
+{
+    const int stages = 4;
+    const int frames = 30;
+
+    ChainResult sequential = runChain(ExecutionMode::SEQUENTIAL, stages, frames);
+    ChainResult pipelined = runChain(ExecutionMode::PIPELINING, stages, frames);
+
+    std::cout << "[ Pipelining ] " << stages << " stages, " << frames << " frames: sequential " << sequential.duration.count() << "ms, pipelined " << pipelined.duration.count()
+              << "ms, stages busy at once: sequential " << sequential.max_active_stages << ", pipelined " << pipelined.max_active_stages << std::endl;
+
+    // each stage works on a different frame, frames are still delivered in order (checked in runChain)
+    ASSERT_GE(pipelined.max_active_stages, 2);
+    ASSERT_LE(pipelined.max_active_stages, stages);
+}
+
+}  // namespace csapex
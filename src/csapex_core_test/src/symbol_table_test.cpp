@@ -0,0 +1,130 @@
+#include <csapex/utility/symbol_table.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/generic_vector_message.hpp>
+#include <csapex/serialization/io/csapex_io.h>
+#include <csapex/serialization/io/std_io.h>
+
+#include <csapex_testing/csapex_test_case.h>
+#include <csapex_testing/mockup_msgs.h>
+
+/// SYSTEM
+#include <thread>
+
+using namespace csapex;
+using namespace connection_types;
+
+class SymbolTableTest : public CsApexTestCase
+{
+};
+
+TEST_F(SymbolTableTest, EqualStringsShareOneId)
+{
+    SymbolTable::Id a = SymbolTable::intern("symbol_table_test_a");
+    SymbolTable::Id b = SymbolTable::intern("symbol_table_test_b");
+
+    ASSERT_NE(a, b);
+    ASSERT_EQ(a, SymbolTable::intern(std::string("symbol_table_test_") + "a"));
+    ASSERT_EQ("symbol_table_test_a", SymbolTable::lookup(a));
+    ASSERT_EQ("symbol_table_test_b", SymbolTable::lookup(b));
+
+    ASSERT_EQ(SymbolTable::EMPTY, SymbolTable::intern(""));
+    ASSERT_TRUE(SymbolTable::lookup(SymbolTable::EMPTY).empty());
+
+    ASSERT_THROW(SymbolTable::lookup(static_cast<SymbolTable::Id>(SymbolTable::size())), std::out_of_range);
+}
+
+TEST_F(SymbolTableTest, FindingASymbolDoesNotInternIt)
+{
+    SymbolTable::Id known = SymbolTable::intern("symbol_table_test_known");
+    std::size_t size = SymbolTable::size();
+
+    SymbolTable::Id id = SymbolTable::EMPTY;
+    ASSERT_TRUE(SymbolTable::find("symbol_table_test_known", id));
+    ASSERT_EQ(known, id);
+
+    ASSERT_FALSE(SymbolTable::find("symbol_table_test_unknown", id));
+    ASSERT_FALSE(SymbolTable::find("symbol_table_test_unknown", id));
+    ASSERT_EQ(size, SymbolTable::size());
+}
+
+TEST_F(SymbolTableTest, SymbolsCanBeInternedConcurrently)
+{
+    const int symbols = 2000;
+    std::vector<std::vector<SymbolTable::Id>> ids(4);
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < ids.size(); ++t) {
+        threads.emplace_back([t, &ids]() {
+            for (int i = 0; i < symbols; ++i) {
+                ids[t].push_back(SymbolTable::intern("concurrent_" + std::to_string(i)));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < symbols; ++i) {
+        for (std::size_t t = 1; t < ids.size(); ++t) {
+            ASSERT_EQ(ids[0][i], ids[t][i]);
+        }
+        ASSERT_EQ("concurrent_" + std::to_string(i), SymbolTable::lookup(ids[0][i]));
+    }
+}
+
+TEST_F(SymbolTableTest, MessagesOfTheSameTypeShareTheTypeId)
+{
+    auto a = std::make_shared<GenericValueMessage<int>>(1);
+    auto b = std::make_shared<GenericValueMessage<int>>(2);
+    auto c = std::make_shared<GenericValueMessage<double>>(3.0);
+
+    ASSERT_EQ(a->typeId(), b->typeId());
+    ASSERT_NE(a->typeId(), c->typeId());
+    ASSERT_EQ(SymbolTable::intern(a->typeName()), a->typeId());
+
+    ASSERT_TRUE(a->acceptsConnectionFrom(b.get()));
+
+    auto v1 = GenericVectorMessage::make<int>();
+    auto v2 = GenericVectorMessage::make<int>();
+    ASSERT_EQ(v1->typeId(), v2->typeId());
+    ASSERT_EQ(v1->descriptiveName(), v2->descriptiveName());
+
+    auto m1 = std::make_shared<MockMessage>();
+    auto m2 = std::make_shared<MockMessage>();
+    ASSERT_EQ("MockMessage", m1->typeName());
+    ASSERT_EQ(m1->typeId(), m2->typeId());
+}
+
+TEST_F(SymbolTableTest, TypeNamesSurviveSerialization)
+{
+    auto message = std::make_shared<MockMessage>();
+
+    SerializationBuffer data;
+    {
+        TokenData::Ptr generic = message;
+        data << generic;
+    }
+
+    TokenData::Ptr result;
+    data >> result;
+    ASSERT_NE(nullptr, result);
+    ASSERT_EQ(message->typeId(), result->typeId());
+    ASSERT_EQ(message->typeName(), result->typeName());
+    ASSERT_EQ(message->descriptiveName(), result->descriptiveName());
+}
+
+TEST_F(SymbolTableTest, UnknownTypeNamesAreRejectedWhenDeserializing)
+{
+    auto message = std::make_shared<MockMessage>();
+
+    SerializationBuffer data;
+    data << std::string("symbol_table_test_unknown_type");
+    data << message->descriptiveName();
+
+    SemanticVersion version;
+    ASSERT_THROW(message->TokenData::deserialize(data, version), std::runtime_error);
+
+    SymbolTable::Id id;
+    ASSERT_FALSE(SymbolTable::find("symbol_table_test_unknown_type", id));
+    ASSERT_EQ("MockMessage", message->typeName());
+}
@@ -0,0 +1,669 @@
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_generator.h>
+#include <csapex/profiling/profiler.h>
+#include <csapex/profiling/profiler_impl.h>
+#include <csapex/utility/yaml.h>
+
+#include <csapex_testing/csapex_test_case.h>
+#include <csapex_testing/test_exception_handler.h>
+
+/// SYSTEM
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace csapex;
+
+namespace
+{
+class MockupTaskGenerator : public TaskGenerator
+{
+public:
+    void assignToScheduler(Scheduler* scheduler) override
+    {
+        scheduler_ = scheduler;
+        scheduler_->add(shared_from_this());
+    }
+    Scheduler* getScheduler() const override
+    {
+        return scheduler_;
+    }
+    void detach() override
+    {
+        if (scheduler_) {
+            Scheduler* s = scheduler_;
+            scheduler_ = nullptr;
+            s->remove(this);
+        }
+    }
+
+    bool isPaused() const override
+    {
+        return false;
+    }
+    void setPause(bool /*pause*/) override
+    {
+    }
+
+    bool canStartStepping() const override
+    {
+        return true;
+    }
+    void setSteppingMode(bool /*stepping*/) override
+    {
+    }
+    void step() override
+    {
+    }
+    bool isStepping() const override
+    {
+        return false;
+    }
+    bool isStepDone() const override
+    {
+        return true;
+    }
+
+    UUID getUUID() const override
+    {
+        return UUID::NONE;
+    }
+
+    void setError(const std::string& /*msg*/) override
+    {
+    }
+
+    void reset() override
+    {
+    }
+
+    void setSuppressExceptions(bool /*suppress_exceptions*/) override
+    {
+    }
+
+    TaskPtr makeTask(std::function<void()> callback)
+    {
+        return std::make_shared<Task>("test", callback, 0, this);
+    }
+
+private:
+    Scheduler* scheduler_ = nullptr;
+};
+
+}  // namespace
+
+class ThreadGroupTest : public CsApexTestCase
+{
+protected:
+    ThreadGroupTest() : group(std::make_shared<ThreadGroup>(eh, "test"))
+    {
+    }
+
+    bool waitFor(std::function<bool()> predicate)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(5), predicate);
+    }
+
+    void notify()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.notify_all();
+    }
+
+    TestExceptionHandler eh;
+    ThreadGroupPtr group;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+TEST_F(ThreadGroupTest, DefaultIsOneWorker)
+{
+    ASSERT_EQ(1, group->getWorkerCount());
+}
+
+TEST_F(ThreadGroupTest, WorkerCountIsPersisted)
+{
+    group->setWorkerCount(3);
+
+    YAML::Node node;
+    group->saveSettings(node);
+
+    ThreadGroup other(eh, "other");
+    other.loadSettings(node);
+
+    ASSERT_EQ(3, other.getWorkerCount());
+}
+
+TEST_F(ThreadGroupTest, QueueTypeIsPersisted)
+{
+    ASSERT_EQ(Scheduler::QueueType::LOCKED, group->getQueueType());
+
+    group->setQueueType(Scheduler::QueueType::LOCK_FREE);
+
+    YAML::Node node;
+    group->saveSettings(node);
+
+    ThreadGroup other(eh, "other");
+    other.loadSettings(node);
+
+    ASSERT_EQ(Scheduler::QueueType::LOCK_FREE, other.getQueueType());
+}
+
+TEST_F(ThreadGroupTest, SchedulingPolicyIsPersisted)
+{
+    ASSERT_EQ(Scheduler::SchedulingPolicy::PRIORITY, group->getSchedulingPolicy());
+
+    group->setSchedulingPolicy(Scheduler::SchedulingPolicy::EARLIEST_DEADLINE_FIRST);
+
+    YAML::Node node;
+    group->saveSettings(node);
+
+    ThreadGroup other(eh, "other");
+    other.loadSettings(node);
+
+    ASSERT_EQ(Scheduler::SchedulingPolicy::EARLIEST_DEADLINE_FIRST, other.getSchedulingPolicy());
+}
+
+TEST_F(ThreadGroupTest, RealtimeSettingsArePersisted)
+{
+    ASSERT_EQ(ThreadGroup::RealtimePolicy::NONE, group->getRealtimeSettings().policy);
+
+    ThreadGroup::RealtimeSettings settings;
+    settings.policy = ThreadGroup::RealtimePolicy::ROUND_ROBIN;
+    settings.priority = 42;
+    settings.lock_memory = true;
+    settings.stack_prefault = 64 * 1024;
+    group->setRealtimeSettings(settings);
+
+    YAML::Node node;
+    group->saveSettings(node);
+
+    ThreadGroup other(eh, "other");
+    other.loadSettings(node);
+
+    ASSERT_EQ(settings, other.getRealtimeSettings());
+}
+
+TEST_F(ThreadGroupTest, StackPrefaultIsLimited)
+{
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    ThreadGroup::RealtimeSettings settings;
+    settings.stack_prefault = 1024 * 1024 * 1024;
+    group->setRealtimeSettings(settings);
+    ASSERT_EQ(ThreadGroup::MAX_STACK_PREFAULT, group->getRealtimeSettings().stack_prefault);
+
+    bool executed = false;
+    group->start();
+    group->schedule(generator->makeTask([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        executed = true;
+        changed.notify_all();
+    }));
+
+    ASSERT_TRUE(waitFor([&]() { return executed; }));
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, EarliestDeadlineIsExecutedFirst)
+{
+    group->setSchedulingPolicy(Scheduler::SchedulingPolicy::EARLIEST_DEADLINE_FIRST);
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<int> deadlines_ms = { 30, 10, -1, 20, 0 };
+
+    std::vector<int> order;
+    for (std::size_t i = 0; i < deadlines_ms.size(); ++i) {
+        auto generator = std::make_shared<MockupTaskGenerator>();
+        generator->assignToScheduler(group.get());
+
+        int deadline = deadlines_ms[i];
+        TaskPtr task = generator->makeTask([&, deadline]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            order.push_back(deadline);
+            changed.notify_all();
+        });
+        if (deadline >= 0) {
+            task->setDeadline(now + std::chrono::seconds(10) + std::chrono::milliseconds(deadline));
+        }
+        group->schedule(task);
+    }
+
+    group->start();
+
+    ASSERT_TRUE(waitFor([&]() { return order.size() == deadlines_ms.size(); }));
+
+    // tasks without a deadline come last
+    std::vector<int> expected = { 0, 10, 20, 30, -1 };
+    ASSERT_EQ(expected, order);
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, ChangingThePolicyReordersQueuedTasks)
+{
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    auto now = std::chrono::steady_clock::now();
+
+    std::vector<int> order;
+    std::vector<TaskPtr> tasks;
+    for (int i = 0; i < 3; ++i) {
+        TaskPtr task = generator->makeTask([&, i]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            order.push_back(i);
+            changed.notify_all();
+        });
+        task->setDeadline(now + std::chrono::seconds(10 - i));
+        group->schedule(task);
+    }
+
+    group->setSchedulingPolicy(Scheduler::SchedulingPolicy::EARLIEST_DEADLINE_FIRST);
+    group->start();
+
+    ASSERT_TRUE(waitFor([&]() { return order.size() == 3; }));
+    std::vector<int> expected = { 2, 1, 0 };
+    ASSERT_EQ(expected, order);
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, MergingWorkerQueuesKeepsThePriorityOrder)
+{
+    group->setWorkerCount(2);
+
+    auto low = std::make_shared<MockupTaskGenerator>();
+    auto high = std::make_shared<MockupTaskGenerator>();
+    low->assignToScheduler(group.get());
+    high->assignToScheduler(group.get());
+
+    std::vector<int> order;
+    for (int i = 0; i < 2; ++i) {
+        for (auto generator : { low, high }) {
+            int priority = generator == high ? 1 : 0;
+            group->schedule(std::make_shared<Task>("test",
+                                                   [&, priority, i]() {
+                                                       std::unique_lock<std::mutex> lock(mutex);
+                                                       order.push_back(priority * 10 + i);
+                                                       changed.notify_all();
+                                                   },
+                                                   priority, generator.get()));
+        }
+    }
+
+    // both generators end up in the queue of the only remaining worker
+    group->setWorkerCount(1);
+    group->start();
+
+    ASSERT_TRUE(waitFor([&]() { return order.size() == 4; }));
+    std::vector<int> expected = { 10, 11, 0, 1 };
+    ASSERT_EQ(expected, order);
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, DeadlineMissesAreCounted)
+{
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    std::size_t executed = 0;
+    auto count = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++executed;
+        changed.notify_all();
+    };
+
+    TaskPtr missed = generator->makeTask(count);
+    missed->setDeadline(std::chrono::steady_clock::now() - std::chrono::milliseconds(1));
+    TaskPtr met = generator->makeTask(count);
+    met->setDeadline(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    TaskPtr without_deadline = generator->makeTask(count);
+    ASSERT_FALSE(without_deadline->hasDeadline());
+
+    group->start();
+    group->schedule(missed);
+    group->schedule(met);
+    group->schedule(without_deadline);
+
+    ASSERT_TRUE(waitFor([&]() { return executed == 3; }));
+    group->stop();
+
+    ASSERT_EQ(1, group->getDeadlineMissCount());
+}
+
+TEST_F(ThreadGroupTest, SchedulingLatencyIsRecordedByTheProfiler)
+{
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    ProfilerPtr profiler = group->getProfiler();
+    profiler->setEnabled(true);
+
+    std::size_t executed = 0;
+    std::vector<TaskPtr> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(generator->makeTask([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            std::unique_lock<std::mutex> lock(mutex);
+            ++executed;
+            changed.notify_all();
+        }));
+    }
+
+    // all tasks are queued before the first one is executed
+    for (const TaskPtr& task : tasks) {
+        group->schedule(task);
+    }
+    group->start();
+
+    ASSERT_TRUE(waitFor([&]() { return executed == 3; }));
+    group->stop();
+
+    const Profile& profile = profiler->getProfile(group->getName());
+    Histogram depth = profile.getHistogram("queue depth");
+    ASSERT_EQ(3, depth.count());
+    ASSERT_EQ(3, depth.getMax());
+
+    Histogram execution = profile.getHistogram("execution");
+    ASSERT_EQ(3, execution.count());
+    ASSERT_GE(execution.getPercentile(0.5), 2000.0);
+
+    // the last task waited for the two before it
+    Histogram wait = profile.getHistogram("queue wait");
+    ASSERT_EQ(3, wait.count());
+    ASSERT_GE(wait.getMax(), 4000.0);
+}
+
+TEST_F(ThreadGroupTest, ProfilerCanBeSharedByConcurrentGroups)
+{
+    ProfilerImplementation profiler(true);
+
+    const int records = 2000;
+
+    // every thread stands for a group, they all record into the same profiler while it is being read
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&profiler, t]() {
+            std::string key = "group " + std::to_string(t);
+            for (int i = 0; i < records; ++i) {
+                profiler.addToHistogram(key, "execution", i);
+                profiler.incrementCounter(key, "wakeups");
+                profiler.addLatency("sink", key, i);
+            }
+        });
+    }
+    std::atomic<bool> done{ false };
+    std::thread reader([&]() {
+        while (!done) {
+            for (int t = 0; t < 4; ++t) {
+                const Profile& profile = profiler.getProfile("group " + std::to_string(t));
+                profile.getHistograms();
+                profile.getCounters();
+            }
+            profiler.getProfile("sink").getLatencies();
+        }
+    });
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    done = true;
+    reader.join();
+
+    std::map<std::string, Histogram> latencies = profiler.getProfile("sink").getLatencies();
+    ASSERT_EQ(4, latencies.size());
+    for (int t = 0; t < 4; ++t) {
+        std::string key = "group " + std::to_string(t);
+        const Profile& profile = profiler.getProfile(key);
+        ASSERT_EQ(records, profile.getHistogram("execution").count());
+        ASSERT_EQ(records, profile.getCounter("wakeups"));
+        ASSERT_EQ(records, latencies.at(key).count());
+    }
+}
+
+TEST_F(ThreadGroupTest, LockFreeQueueExecutesTasksInOrder)
+{
+    group->setQueueType(Scheduler::QueueType::LOCK_FREE);
+
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    // more tasks than fit into the inbox, the remaining ones take the locked path
+    const int n = 2 * ThreadGroup::INBOX_CAPACITY;
+
+    std::vector<int> order;
+    std::vector<TaskPtr> tasks;
+    for (int i = 0; i < n; ++i) {
+        tasks.push_back(generator->makeTask([&, i]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            order.push_back(i);
+            changed.notify_all();
+        }));
+    }
+
+    group->start();
+
+    // schedule from a foreign thread, like an upstream node would
+    std::thread producer([&]() {
+        for (const TaskPtr& task : tasks) {
+            group->schedule(task);
+        }
+    });
+    producer.join();
+
+    ASSERT_TRUE(waitFor([&]() { return order.size() == static_cast<std::size_t>(n); }));
+    for (int i = 0; i < n; ++i) {
+        ASSERT_EQ(i, order[i]);
+    }
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, DelayedTasksAreExecutedByTheGroup)
+{
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    std::thread::id executed_in;
+    auto delay = std::chrono::milliseconds(20);
+
+    group->start();
+
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point executed_at;
+    group->scheduleDelayed(generator->makeTask([&]() {
+                               std::unique_lock<std::mutex> lock(mutex);
+                               executed_at = std::chrono::steady_clock::now();
+                               executed_in = std::this_thread::get_id();
+                               changed.notify_all();
+                           }),
+                           start + delay);
+
+    ASSERT_TRUE(waitFor([&]() { return executed_in != std::thread::id(); }));
+    ASSERT_EQ(group->thread().get_id(), executed_in);
+    ASSERT_GE(executed_at - start, delay);
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, GeneratorsRunInParallelWithMultipleWorkers)
+{
+    group->setWorkerCount(2);
+
+    auto a = std::make_shared<MockupTaskGenerator>();
+    auto b = std::make_shared<MockupTaskGenerator>();
+    a->assignToScheduler(group.get());
+    b->assignToScheduler(group.get());
+
+    std::atomic<int> running(0);
+    std::atomic<int> overlapped(0);
+
+    auto callback = [&]() {
+        ++running;
+        notify();
+        // only succeeds if the other generator's task is executed at the same time
+        if (waitFor([&]() { return running == 2; })) {
+            ++overlapped;
+        }
+        notify();
+    };
+
+    group->start();
+    group->schedule(a->makeTask(callback));
+    group->schedule(b->makeTask(callback));
+
+    ASSERT_TRUE(waitFor([&]() { return overlapped == 2; }));
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, TasksOfOneGeneratorAreSerialized)
+{
+    group->setWorkerCount(4);
+
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    const int n = 64;
+
+    std::atomic<bool> executing(false);
+    std::atomic<bool> overlapped(false);
+    std::vector<int> order;
+
+    std::vector<TaskPtr> tasks;
+    for (int i = 0; i < n; ++i) {
+        tasks.push_back(generator->makeTask([&, i]() {
+            if (executing.exchange(true)) {
+                overlapped = true;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            executing = false;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            order.push_back(i);
+            changed.notify_all();
+        }));
+    }
+
+    for (const TaskPtr& task : tasks) {
+        group->schedule(task);
+    }
+    group->start();
+
+    ASSERT_TRUE(waitFor([&]() { return order.size() == static_cast<std::size_t>(n); }));
+    ASSERT_FALSE(overlapped);
+    for (int i = 0; i < n; ++i) {
+        ASSERT_EQ(i, order[i]);
+    }
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, InlineExecutionWaitsForTheGeneratorToBeIdle)
+{
+    group->setWorkerCount(2);
+
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    std::atomic<bool> running(false);
+    std::atomic<bool> release(false);
+    std::atomic<int> inline_executions(0);
+
+    group->start();
+    group->schedule(generator->makeTask([&]() {
+        running = true;
+        notify();
+        waitFor([&]() { return release.load(); });
+    }));
+    ASSERT_TRUE(waitFor([&]() { return running.load(); }));
+
+    TaskPtr other = generator->makeTask([&]() { ++inline_executions; });
+
+    // the generator is busy in a worker
+    ASSERT_FALSE(group->executeInline(other));
+    ASSERT_EQ(0, inline_executions);
+
+    release = true;
+    notify();
+
+    // as soon as the worker is done, the task can be executed in this thread
+    bool executed = false;
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!executed && std::chrono::steady_clock::now() < timeout) {
+        executed = group->executeInline(other);
+        if (!executed) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    ASSERT_TRUE(executed);
+    ASSERT_EQ(1, inline_executions);
+
+    group->stop();
+}
+
+TEST_F(ThreadGroupTest, QueuedTasksAreNotQueuedAgain)
+{
+    auto generator = std::make_shared<MockupTaskGenerator>();
+    generator->assignToScheduler(group.get());
+
+    const int samples = 1000;
+    std::atomic<int> executed{ 0 };
+
+    // measures the average time of scheduling a task (and re-scheduling it) with 'depth' other tasks queued
+    auto measure = [&](int depth) {
+        group->clear();
+
+        for (int i = 0; i < depth; ++i) {
+            group->schedule(generator->makeTask([&]() { ++executed; }));
+        }
+
+        std::vector<TaskPtr> tasks;
+        for (int i = 0; i < samples; ++i) {
+            tasks.push_back(generator->makeTask([&]() { ++executed; }));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (const TaskPtr& task : tasks) {
+            group->schedule(task);
+            group->schedule(task);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / (2 * samples);
+    };
+
+    // warm up
+    measure(100);
+
+    double shallow = measure(100);
+    double medium = measure(1000);
+    double deep = measure(10000);
+
+    // the timings depend on the machine, so they are only reported
+    std::cout << "[ ThreadGroup ] enqueue cost at depth 100: " << shallow << "ns, 1000: " << medium << "ns, 10000: " << deep << "ns" << std::endl;
+
+    // tasks of equal priority are executed in order, so all queued tasks have run once the marker runs
+    bool done = false;
+    group->schedule(generator->makeTask([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done = true;
+        changed.notify_all();
+    }));
+
+    group->start();
+    ASSERT_TRUE(waitFor([&]() { return done; }));
+    group->stop();
+
+    ASSERT_EQ(10000 + samples, executed);
+}
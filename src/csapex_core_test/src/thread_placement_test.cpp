@@ -0,0 +1,110 @@
+#include <csapex/scheduling/thread_placement.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/thread_pool.h>
+#include <csapex/utility/cpu_affinity.h>
+#include <csapex/utility/yaml.h>
+
+#include <csapex_testing/csapex_test_case.h>
+#include <csapex_testing/test_exception_handler.h>
+
+using namespace csapex;
+
+class ThreadPlacementTest : public CsApexTestCase
+{
+protected:
+    // two sockets with two cores each, each socket has its own L3 cache
+    ThreadPlacementTest() : placement(CpuTopology({ { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 2, 1, 1, 2 }, { 3, 1, 1, 2 } }))
+    {
+    }
+
+    std::vector<bool> socket(int index)
+    {
+        return index == 0 ? std::vector<bool>{ true, true, false, false } : std::vector<bool>{ false, false, true, true };
+    }
+
+    ThreadPlacement placement;
+};
+
+TEST_F(ThreadPlacementTest, IndependentChainsAreSpreadOverCaches)
+{
+    std::vector<ThreadPlacement::Group> groups = { { 0, 0, 1 }, { 1, 0, 1 } };
+    auto affinities = placement.place(groups, 4);
+
+    ASSERT_EQ(2, affinities.size());
+    ASSERT_NE(affinities[0], affinities[1]);
+    ASSERT_TRUE(affinities[0] == socket(0) || affinities[0] == socket(1));
+    ASSERT_TRUE(affinities[1] == socket(0) || affinities[1] == socket(1));
+}
+
+TEST_F(ThreadPlacementTest, GroupsOfOneChainShareACache)
+{
+    std::vector<ThreadPlacement::Group> groups = { { 0, 0, 1 }, { 1, 0, 1 }, { 0, 1, 1 } };
+    auto affinities = placement.place(groups, 4);
+
+    ASSERT_EQ(affinities[0], affinities[2]);
+    ASSERT_NE(affinities[0], affinities[1]);
+}
+
+TEST_F(ThreadPlacementTest, LongChainsContinueInTheNextCacheInOrderOfDepth)
+{
+    std::vector<ThreadPlacement::Group> groups = { { 0, 2, 1 }, { 0, 0, 1 }, { 0, 1, 1 } };
+    auto affinities = placement.place(groups, 4);
+
+    // the first two stages fill one cache, the last one continues in the other
+    ASSERT_EQ(affinities[1], affinities[2]);
+    ASSERT_NE(affinities[0], affinities[1]);
+}
+
+TEST_F(ThreadPlacementTest, GroupsWithoutChainMayUseAllCpus)
+{
+    std::vector<ThreadPlacement::Group> groups = { { -1, 0, 1 } };
+    auto affinities = placement.place(groups, 4);
+
+    ASSERT_EQ(std::vector<bool>(4, true), affinities[0]);
+}
+
+TEST_F(ThreadPlacementTest, SingleCacheIsNotRestricted)
+{
+    ThreadPlacement single(CpuTopology({ { 0, 0, 0, 0 }, { 1, 0, 0, 0 } }));
+
+    std::vector<ThreadPlacement::Group> groups = { { 0, 0, 1 }, { 1, 0, 1 } };
+    auto affinities = single.place(groups, 2);
+
+    ASSERT_EQ(std::vector<bool>(2, true), affinities[0]);
+    ASSERT_EQ(std::vector<bool>(2, true), affinities[1]);
+}
+
+TEST_F(ThreadPlacementTest, AutomaticPlacementIsPersisted)
+{
+    TestExceptionHandler eh;
+
+    ThreadPool pool(eh, true, true, false);
+    ASSERT_FALSE(pool.isAutomaticPlacementEnabled());
+    pool.setAutomaticPlacement(true);
+
+    YAML::Node node;
+    pool.saveSettings(node);
+
+    ThreadPool other(eh, true, true, false);
+    other.loadSettings(node);
+    ASSERT_TRUE(other.isAutomaticPlacementEnabled());
+}
+
+TEST_F(ThreadPlacementTest, DisablingAutomaticPlacementRestoresTheAffinities)
+{
+    TestExceptionHandler eh;
+
+    ThreadPool pool(eh, true, true, false);
+    ThreadGroup* group = pool.createGroup("pinned");
+
+    std::vector<bool> pinned(group->getCpuAffinity()->getNumCpus(), false);
+    pinned[0] = true;
+    group->getCpuAffinity()->set(pinned);
+    std::vector<bool> default_affinity = pool.getDefaultGroup()->getCpuAffinity()->get();
+
+    pool.setAutomaticPlacement(true);
+    pool.setAutomaticPlacement(false);
+
+    ASSERT_EQ(pinned, group->getCpuAffinity()->get());
+    ASSERT_EQ(default_affinity, pool.getDefaultGroup()->getCpuAffinity()->get());
+}
@@ -0,0 +1,240 @@
+#include <csapex/scheduling/thread_rebalancer.h>
+#include <csapex/scheduling/thread_pool.h>
+#include <csapex/scheduling/thread_group.h>
+#include <csapex/scheduling/task.h>
+#include <csapex/scheduling/task_generator.h>
+#include <csapex/utility/yaml.h>
+
+#include <csapex_testing/csapex_test_case.h>
+#include <csapex_testing/test_exception_handler.h>
+
+/// SYSTEM
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace csapex;
+
+namespace
+{
+/**
+ * @brief The BusyTaskGenerator class keeps its scheduler busy for a fixed time per task
+ */
+class BusyTaskGenerator : public TaskGenerator
+{
+public:
+    explicit BusyTaskGenerator(std::chrono::milliseconds cost) : cost_(cost), running_(false)
+    {
+    }
+
+    void assignToScheduler(Scheduler* scheduler) override
+    {
+        scheduler_ = scheduler;
+        scheduler_->add(shared_from_this());
+    }
+    Scheduler* getScheduler() const override
+    {
+        return scheduler_;
+    }
+    void detach() override
+    {
+        if (scheduler_) {
+            Scheduler* s = scheduler_;
+            scheduler_ = nullptr;
+            s->remove(this);
+        }
+    }
+
+    bool isPaused() const override
+    {
+        return false;
+    }
+    void setPause(bool /*pause*/) override
+    {
+    }
+
+    bool canStartStepping() const override
+    {
+        return true;
+    }
+    void setSteppingMode(bool /*stepping*/) override
+    {
+    }
+    void step() override
+    {
+    }
+    bool isStepping() const override
+    {
+        return false;
+    }
+    bool isStepDone() const override
+    {
+        return true;
+    }
+
+    UUID getUUID() const override
+    {
+        return UUID::NONE;
+    }
+
+    void setError(const std::string& /*msg*/) override
+    {
+    }
+
+    void reset() override
+    {
+    }
+
+    void setSuppressExceptions(bool /*suppress_exceptions*/) override
+    {
+    }
+
+    void start()
+    {
+        running_ = true;
+        task_ = std::make_shared<Task>("busy", [this]() {
+            std::this_thread::sleep_for(cost_);
+            if (running_ && scheduler_) {
+                scheduler_->schedule(task_);
+            }
+        }, 0, this);
+        scheduler_->schedule(task_);
+    }
+
+    void stop()
+    {
+        running_ = false;
+    }
+
+private:
+    Scheduler* scheduler_ = nullptr;
+    std::chrono::milliseconds cost_;
+    std::atomic<bool> running_;
+    TaskPtr task_;
+};
+
+}  // namespace
+
+class ThreadRebalancerTest : public CsApexTestCase
+{
+protected:
+    ThreadRebalancerTest() : pool(eh, true, true, false)
+    {
+    }
+
+    ThreadRebalancer& rebalancer()
+    {
+        return *pool.getRebalancer();
+    }
+
+    TestExceptionHandler eh;
+    ThreadPool pool;
+};
+
+TEST_F(ThreadRebalancerTest, ExpensiveGeneratorIsMovedToItsOwnGroup)
+{
+    auto cheap = std::make_shared<BusyTaskGenerator>(std::chrono::milliseconds(1));
+    auto expensive = std::make_shared<BusyTaskGenerator>(std::chrono::milliseconds(10));
+    pool.add(cheap.get());
+    pool.add(expensive.get());
+    ASSERT_EQ(1, pool.getGroupCount());
+
+    rebalancer().setUtilizationLimits(0.1, 0.5);
+    rebalancer().rebalance();
+
+    pool.start();
+    cheap->start();
+    expensive->start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    cheap->stop();
+    expensive->stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    ASSERT_TRUE(rebalancer().rebalance());
+
+    ASSERT_EQ(2, pool.getGroupCount());
+    ASSERT_EQ(pool.getDefaultGroup(), pool.getGroupFor(cheap.get()));
+    ASSERT_NE(pool.getDefaultGroup(), pool.getGroupFor(expensive.get()));
+
+    // the new layout has been saved
+    ASSERT_TRUE(rebalancer().getLayout()["threads"].IsDefined());
+    ASSERT_EQ(2, rebalancer().getLayout()["threads"]["groups"].size());
+
+    pool.stop();
+}
+
+TEST_F(ThreadRebalancerTest, IdleAutomaticGroupsAreMerged)
+{
+    auto cheap = std::make_shared<BusyTaskGenerator>(std::chrono::milliseconds(1));
+    auto expensive = std::make_shared<BusyTaskGenerator>(std::chrono::milliseconds(10));
+    pool.add(cheap.get());
+    pool.add(expensive.get());
+
+    rebalancer().setUtilizationLimits(0.1, 0.5);
+    rebalancer().rebalance();
+
+    pool.start();
+    cheap->start();
+    expensive->start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    cheap->stop();
+    expensive->stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    ASSERT_TRUE(rebalancer().rebalance());
+    ASSERT_EQ(2, pool.getGroupCount());
+    int created = pool.getGroupFor(expensive.get())->id();
+
+    // the created group is remembered in the saved layout
+    std::vector<int> expected_ids = { created };
+    ASSERT_EQ(expected_ids, rebalancer().getLayout()["threads"]["rebalancer"]["created_groups"].as<std::vector<int>>());
+
+    // nothing is running anymore
+    ASSERT_TRUE(rebalancer().rebalance());
+
+    ASSERT_EQ(1, pool.getGroupCount());
+    ASSERT_EQ(pool.getDefaultGroup(), pool.getGroupFor(expensive.get()));
+
+    pool.stop();
+}
+
+TEST_F(ThreadRebalancerTest, UserGroupsWithAutomaticNamesAreKept)
+{
+    auto generator = std::make_shared<BusyTaskGenerator>(std::chrono::milliseconds(1));
+    pool.add(generator.get());
+    pool.createNewGroupFor(generator.get(), "auto 1000");
+
+    ASSERT_FALSE(rebalancer().rebalance());
+    ASSERT_EQ(2, pool.getGroupCount());
+}
+
+TEST_F(ThreadRebalancerTest, UserGroupsAreKept)
+{
+    auto generator = std::make_shared<BusyTaskGenerator>(std::chrono::milliseconds(1));
+    pool.add(generator.get());
+    pool.createNewGroupFor(generator.get(), "user group");
+
+    ASSERT_FALSE(rebalancer().rebalance());
+    ASSERT_EQ(2, pool.getGroupCount());
+}
+
+TEST_F(ThreadRebalancerTest, SettingsArePersisted)
+{
+    rebalancer().setEnabled(true);
+    rebalancer().setMaximumGroupCount(3);
+    rebalancer().setUtilizationLimits(0.2, 0.6);
+    rebalancer().setMaximumQueueWait(std::chrono::milliseconds(42));
+
+    YAML::Node node;
+    pool.saveSettings(node);
+
+    ThreadPool other(eh, true, true, false);
+    other.loadSettings(node);
+
+    ThreadRebalancer& loaded = *other.getRebalancer();
+    ASSERT_TRUE(loaded.isEnabled());
+    ASSERT_EQ(3, loaded.getMaximumGroupCount());
+    ASSERT_DOUBLE_EQ(0.2, loaded.getLowUtilization());
+    ASSERT_DOUBLE_EQ(0.6, loaded.getHighUtilization());
+    ASSERT_EQ(std::chrono::milliseconds(42), loaded.getMaximumQueueWait());
+}
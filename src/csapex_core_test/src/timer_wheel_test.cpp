@@ -0,0 +1,124 @@
+#include <csapex/scheduling/timer_wheel.h>
+#include <csapex/scheduling/task.h>
+
+#include <csapex_testing/csapex_test_case.h>
+
+using namespace csapex;
+
+class TimerWheelTest : public CsApexTestCase
+{
+protected:
+    TimerWheelTest() : wheel(std::chrono::milliseconds(1)), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    TaskPtr makeTask(const std::string& name)
+    {
+        return std::make_shared<Task>(name, []() {});
+    }
+
+    std::chrono::steady_clock::time_point at(long ms)
+    {
+        return start + std::chrono::milliseconds(ms);
+    }
+
+    TimerWheel wheel;
+    std::chrono::steady_clock::time_point start;
+};
+
+TEST_F(TimerWheelTest, TimersDoNotExpireEarly)
+{
+    TaskPtr task = makeTask("a");
+    wheel.add(task, at(10));
+    ASSERT_EQ(1, wheel.size());
+
+    ASSERT_TRUE(wheel.advance(at(5)).empty());
+
+    std::vector<TaskPtr> expired = wheel.advance(at(12));
+    ASSERT_EQ(1, expired.size());
+    ASSERT_EQ(task, expired.front());
+    ASSERT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, TimersExpireInOrderAcrossAllLevels)
+{
+    // delays that end up on every level of the wheel, including beyond its range
+    std::vector<long> delays = { 3, 70, 5000, 300000, 20000000 };
+
+    std::vector<TaskPtr> tasks;
+    for (std::size_t i = delays.size(); i > 0; --i) {
+        tasks.insert(tasks.begin(), makeTask(std::to_string(i - 1)));
+        wheel.add(tasks.front(), at(delays[i - 1]));
+    }
+
+    for (std::size_t i = 0; i < delays.size(); ++i) {
+        ASSERT_TRUE(wheel.advance(at(delays[i] - 2)).empty()) << "timer " << i << " expired early";
+
+        std::vector<TaskPtr> expired = wheel.advance(at(delays[i] + 2));
+        ASSERT_EQ(1, expired.size()) << "timer " << i << " did not expire";
+        ASSERT_EQ(tasks[i], expired.front());
+    }
+    ASSERT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, TimersCanBeCancelled)
+{
+    TaskPtr a = makeTask("a");
+    TaskPtr b = makeTask("b");
+    TimerWheel::Handle handle_a = wheel.add(a, at(10));
+    wheel.add(b, at(10));
+
+    ASSERT_TRUE(wheel.cancel(handle_a));
+    ASSERT_FALSE(wheel.cancel(handle_a));
+    ASSERT_EQ(1, wheel.size());
+
+    std::vector<TaskPtr> expired = wheel.advance(at(20));
+    ASSERT_EQ(1, expired.size());
+    ASSERT_EQ(b, expired.front());
+}
+
+TEST_F(TimerWheelTest, NextExpiryIsExactForNearTimers)
+{
+    ASSERT_EQ(std::chrono::steady_clock::time_point::max(), wheel.nextExpiry());
+
+    TimerWheel::Handle near = wheel.add(makeTask("near"), at(10));
+
+    ASSERT_GE(wheel.nextExpiry(), at(10));
+    ASSERT_LE(wheel.nextExpiry(), at(11));
+
+    ASSERT_TRUE(wheel.cancel(near));
+
+    // 'a' is beyond the lowest wheel, it is only moved down at the cascade 64 ticks from the start
+    TaskPtr a = makeTask("a");
+    wheel.add(a, at(70));
+    ASSERT_TRUE(wheel.advance(at(60)).empty());
+
+    // 'b' lands on the lowest wheel, but expires after 'a'
+    wheel.add(makeTask("b"), at(100));
+    ASSERT_LE(wheel.nextExpiry(), at(65));
+
+    // following the wake up times never misses 'a'
+    std::vector<TaskPtr> expired;
+    while (expired.empty()) {
+        auto next = wheel.nextExpiry();
+        ASSERT_LE(next, at(71));
+        expired = wheel.advance(next);
+    }
+    ASSERT_EQ(1, expired.size());
+    ASSERT_EQ(a, expired.front());
+}
+
+TEST_F(TimerWheelTest, ManyTimersCanBePending)
+{
+    const int n = 50000;
+    for (int i = 0; i < n; ++i) {
+        wheel.add(makeTask("t"), at(1 + i % 1000));
+    }
+    ASSERT_EQ(n, wheel.size());
+
+    std::size_t expired = 0;
+    for (long t = 0; t <= 1010; t += 10) {
+        expired += wheel.advance(at(t)).size();
+    }
+    ASSERT_EQ(n, expired);
+}
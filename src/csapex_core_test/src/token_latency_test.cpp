@@ -0,0 +1,146 @@
+#include <csapex/model/graph_facade_impl.h>
+#include <csapex/model/graph/graph_impl.h>
+#include <csapex/model/node_facade_impl.h>
+#include <csapex/model/node_handle.h>
+#include <csapex/model/node_worker.h>
+#include <csapex/model/node_constructor.h>
+#include <csapex/model/node_modifier.h>
+#include <csapex/model/subgraph_node.h>
+#include <csapex/model/token.h>
+#include <csapex/msg/generic_value_message.hpp>
+#include <csapex/msg/io.h>
+#include <csapex/profiling/profiler_impl.h>
+#include <csapex/utility/uuid_provider.h>
+
+#include <csapex_testing/mockup_nodes.h>
+#include <csapex_testing/node_constructing_test.h>
+
+/// SYSTEM
+#include <chrono>
+#include <thread>
+
+namespace csapex
+{
+class DelayingForwarder : public Node
+{
+public:
+    void setup(csapex::NodeModifier& node_modifier) override
+    {
+        in = node_modifier.addInput<int>("input");
+        out = node_modifier.addOutput<int>("output");
+    }
+
+    void process() override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_MS));
+        msg::publish(out, msg::getValue<int>(in));
+    }
+
+    static constexpr int DELAY_MS = 4;
+
+private:
+    Input* in;
+    Output* out;
+};
+
+class TokenLatencyTest : public NodeConstructingTest
+{
+protected:
+    TokenLatencyTest()
+    {
+        factory.registerNodeType(std::make_shared<NodeConstructor>("DelayingForwarder", []() { return std::make_shared<DelayingForwarder>(); }));
+    }
+
+    NodeFacadeImplementationPtr makeNode(GraphFacadeImplementation& graph_facade, const std::string& type, const std::string& name)
+    {
+        NodeFacadeImplementationPtr nf = factory.makeNode(type, UUIDProvider::makeUUID_without_parent(name), graph);
+        EXPECT_NE(nullptr, nf);
+        graph_facade.addNode(nf);
+        return nf;
+    }
+};
+
+TEST_F(TokenLatencyTest, OriginsAreMergedPerSource)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto earlier = now - std::chrono::milliseconds(10);
+
+    Token::OriginsPtr a = std::make_shared<std::vector<Token::Origin>>(std::vector<Token::Origin>{ { "a", now }, { "b", now } });
+    Token::OriginsPtr b = std::make_shared<std::vector<Token::Origin>>(std::vector<Token::Origin>{ { "b", earlier }, { "c", now } });
+
+    ASSERT_EQ(nullptr, Token::mergeOrigins({}));
+    ASSERT_EQ(nullptr, Token::mergeOrigins({ nullptr, nullptr }));
+
+    // tokens of the same token set share their origins
+    ASSERT_EQ(a, Token::mergeOrigins({ a, nullptr, a }));
+
+    Token::OriginsPtr merged = Token::mergeOrigins({ a, b });
+    ASSERT_EQ(3, merged->size());
+    for (const Token::Origin& origin : *merged) {
+        if (origin.source == "b") {
+            // the oldest stamp determines how stale the token set is
+            ASSERT_TRUE(origin.stamp == earlier);
+        }
+    }
+}
+
+TEST_F(TokenLatencyTest, OriginsAreClonedWithTheToken)
+{
+    TokenPtr token = msg::createToken(42);
+    Token::OriginsPtr origins = std::make_shared<std::vector<Token::Origin>>(std::vector<Token::Origin>{ { "src", std::chrono::steady_clock::now() } });
+    token->setOrigins(origins);
+
+    TokenPtr clone = token->cloneAs<Token>();
+    ASSERT_EQ(origins, clone->getOrigins());
+}
+
+TEST_F(TokenLatencyTest, SinksRecordTheLatencyOfEverySource)
+{
+    GraphFacadeImplementation main_graph_facade(executor, graph, graph_node);
+
+    // {src_a -> delay, src_b} -> combiner -> sink
+    NodeFacadeImplementationPtr src_a = makeNode(main_graph_facade, "MockupSource", "src_a");
+    NodeFacadeImplementationPtr src_b = makeNode(main_graph_facade, "MockupSource", "src_b");
+    NodeFacadeImplementationPtr delay = makeNode(main_graph_facade, "DelayingForwarder", "delay");
+    NodeFacadeImplementationPtr combiner = makeNode(main_graph_facade, "DynamicMultiplier", "combiner");
+    NodeFacadeImplementationPtr sink_p = makeNode(main_graph_facade, "MockupSink", "sink");
+    std::shared_ptr<MockupSink> sink = std::dynamic_pointer_cast<MockupSink>(sink_p->getNode());
+
+    main_graph_facade.connect(src_a, "output", delay, "input");
+    main_graph_facade.connect(delay, "output", combiner, "input_a");
+    main_graph_facade.connect(src_b, "output", combiner, "input_b");
+    main_graph_facade.connect(combiner, "output", sink_p, "input");
+
+    NodeWorkerPtr sink_worker = sink_p->getNodeWorker().lock();
+    ASSERT_NE(nullptr, sink_worker);
+    sink_worker->setProfiling(true);
+    NodeWorkerPtr combiner_worker = combiner->getNodeWorker().lock();
+    combiner_worker->setProfiling(true);
+
+    executor.start();
+
+    const Profile& profile = sink_worker->getProfiler()->getProfile(sink_p->getUUID().getFullName());
+
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (sink->getValue() < 20 * 20 && std::chrono::steady_clock::now() < timeout) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    executor.stop();
+
+    const std::map<std::string, Histogram>& latencies = profile.getLatencies();
+    ASSERT_EQ(2, latencies.size());
+    ASSERT_EQ(1, latencies.count(src_a->getUUID().getFullName()));
+    ASSERT_EQ(1, latencies.count(src_b->getUUID().getFullName()));
+
+    const Histogram& from_a = latencies.at(src_a->getUUID().getFullName());
+    ASSERT_GT(from_a.count(), 0);
+    ASSERT_GE(from_a.getMax(), DelayingForwarder::DELAY_MS * 1000.0);
+
+    // intermediate nodes do not record anything
+    ASSERT_TRUE(combiner_worker->getProfiler()->getProfile(combiner->getUUID().getFullName()).getLatencies().empty());
+
+    main_graph_facade.clear();
+}
+
+}  // namespace csapex
@@ -6,6 +6,7 @@
 #include <csapex/scheduling/scheduling_fwd.h>
 #include <csapex/model/observer.h>
 #include <csapex/core/core_fwd.h>
+#include <csapex/profiling/profile.h>
 
 /// SYTEM
 #include <QAbstractTableModel>
@@ -29,6 +30,9 @@ public:
 
     void refresh();
 
+private:
+    const Profile& getProfile(ThreadGroup* group) const;
+
 private:
     Settings& settings_;
     ThreadPoolPtr thread_pool_;
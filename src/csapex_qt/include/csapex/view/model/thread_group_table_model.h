@@ -28,6 +28,11 @@ public:
 
     ThreadGroup* getThreadGroup(int row) const;
 
+    /**
+     * @brief updateStatistics refreshes the columns that change while the groups are running
+     */
+    void updateStatistics();
+
 private:
     void refresh();
 
@@ -26,6 +26,7 @@
 #include <csapex/profiling/timer.h>
 #include <csapex/scheduling/thread_group.h>
 #include <csapex/scheduling/thread_pool.h>
+#include <csapex/scheduling/thread_rebalancer.h>
 #include <csapex/view/csapex_view_core_impl.h>
 #include <csapex/view/designer/designer.h>
 #include <csapex/view/designer/designerio.h>
@@ -383,6 +384,12 @@ void CsApexWindow::setupThreadManagement()
         ui->thread_table->resizeColumnsToContents();
     });
 
+    QTimer* statistics_timer = new QTimer(this);
+    statistics_timer->setInterval(1000);
+    statistics_timer->start();
+
+    QObject::connect(statistics_timer, &QTimer::timeout, [model]() { model->updateStatistics(); });
+
     QObject::connect(ui->thread_assign, &QPushButton::clicked, [this](bool) {
         if (GraphView* view = designer_->getVisibleGraphView()) {
             QItemSelectionModel* select = ui->thread_table->selectionModel();
@@ -393,6 +400,22 @@ void CsApexWindow::setupThreadManagement()
         }
     });
 
+    ui->thread_automatic_placement->setChecked(thread_pool->isAutomaticPlacementEnabled());
+    QObject::connect(ui->thread_automatic_placement, &QCheckBox::toggled, [this](bool checked) {
+        ThreadPoolPtr thread_pool = view_core_.getThreadPool();
+        apex_assert_hard(thread_pool);
+        thread_pool->setAutomaticPlacement(checked);
+    });
+    observe(thread_pool->automatic_placement_changed, [this](bool enabled) { ui->thread_automatic_placement->setChecked(enabled); });
+
+    ui->thread_rebalancing->setChecked(thread_pool->getRebalancer()->isEnabled());
+    QObject::connect(ui->thread_rebalancing, &QCheckBox::toggled, [this](bool checked) {
+        ThreadPoolPtr thread_pool = view_core_.getThreadPool();
+        apex_assert_hard(thread_pool);
+        thread_pool->getRebalancer()->setEnabled(checked);
+    });
+    observe(thread_pool->getRebalancer()->enabled_changed, [this](bool enabled) { ui->thread_rebalancing->setChecked(enabled); });
+
     QObject::connect(ui->thread_private, &QPushButton::clicked, [this](bool) {
         if (GraphView* view = designer_->getVisibleGraphView()) {
             view->usePrivateThreadForSelectedNodes();
@@ -32,6 +32,7 @@
 #include <QtGui>
 #include <QtOpenGL>
 #include <QTimer>
+#include <map>
 
 #ifndef GL_MULTISAMPLE
 #define GL_MULTISAMPLE 0x809D
@@ -1395,6 +1396,31 @@ bool DesignerScene::showConnectionContextMenu()
     active->setChecked(c.active);
     menu.addAction(active);
 
+    QAction* latest = new QAction("keep only the latest token", &menu);
+    latest->setCheckable(true);
+    latest->setChecked(c.overflow_policy == OverflowPolicy::KEEP_LATEST);
+    menu.addAction(latest);
+
+    QMenu* buffer_menu = menu.addMenu("buffer size");
+    buffer_menu->setEnabled(c.overflow_policy != OverflowPolicy::KEEP_LATEST);
+    std::map<QAction*, int> buffer_sizes;
+    for (int size : { 1, 2, 4, 8, 16 }) {
+        QAction* action = buffer_menu->addAction(QString::number(size));
+        action->setCheckable(true);
+        action->setChecked(c.buffer_size == size);
+        buffer_sizes[action] = size;
+    }
+
+    QMenu* policy_menu = menu.addMenu("when buffer is full");
+    policy_menu->setEnabled(c.buffer_size > 1 && c.overflow_policy != OverflowPolicy::KEEP_LATEST);
+    std::map<QAction*, OverflowPolicy> policies;
+    for (const auto& pair : std::vector<std::pair<QString, OverflowPolicy>>{ { "block", OverflowPolicy::BLOCK }, { "drop oldest", OverflowPolicy::DROP_OLDEST }, { "drop newest", OverflowPolicy::DROP_NEWEST } }) {
+        QAction* action = policy_menu->addAction(pair.first);
+        action->setCheckable(true);
+        action->setChecked(c.overflow_policy == pair.second);
+        policies[action] = pair.second;
+    }
+
     QAction* selectedItem = menu.exec(QCursor::pos());
 
     if (selectedItem == del) {
@@ -1405,6 +1431,16 @@ bool DesignerScene::showConnectionContextMenu()
 
     } else if (selectedItem == active) {
         view_core_.getCommandDispatcher()->execute(CommandFactory(graph_facade_.get()).setConnectionActive(highlight_connection_id_, active->isChecked()));
+
+    } else if (selectedItem == latest) {
+        OverflowPolicy policy = latest->isChecked() ? OverflowPolicy::KEEP_LATEST : OverflowPolicy::BLOCK;
+        view_core_.getCommandDispatcher()->execute(CommandFactory(graph_facade_.get()).setConnectionBuffer(highlight_connection_id_, c.buffer_size, policy));
+
+    } else if (buffer_sizes.find(selectedItem) != buffer_sizes.end()) {
+        view_core_.getCommandDispatcher()->execute(CommandFactory(graph_facade_.get()).setConnectionBuffer(highlight_connection_id_, buffer_sizes[selectedItem], c.overflow_policy));
+
+    } else if (policies.find(selectedItem) != policies.end()) {
+        view_core_.getCommandDispatcher()->execute(CommandFactory(graph_facade_.get()).setConnectionBuffer(highlight_connection_id_, c.buffer_size, policies[selectedItem]));
     }
 
     return true;
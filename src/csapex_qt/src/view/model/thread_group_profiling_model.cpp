@@ -5,6 +5,7 @@
 #include <csapex/scheduling/thread_pool.h>
 #include <csapex/scheduling/thread_group.h>
 #include <csapex/core/settings.h>
+#include <csapex/profiling/profiler.h>
 #include <csapex/view/widgets/thread_group_profiling_widget.h>
 
 /// SYSTEM
@@ -12,6 +13,26 @@
 
 using namespace csapex;
 
+namespace
+{
+QString formatDuration(double microseconds)
+{
+    if (microseconds < 1000.0) {
+        return QString::number(microseconds, 'f', 0) + " µs";
+    } else {
+        return QString::number(microseconds / 1000.0, 'f', 1) + " ms";
+    }
+}
+
+QString formatLatency(const Histogram& histogram)
+{
+    if (histogram.count() == 0) {
+        return "-";
+    }
+    return formatDuration(histogram.getPercentile(0.5)) + " / " + formatDuration(histogram.getPercentile(0.99)) + " / " + formatDuration(histogram.getMax());
+}
+}  // namespace
+
 ThreadGroupProfilingModel::ThreadGroupProfilingModel(Settings& settings, ThreadPoolPtr thread_pool) : settings_(settings), thread_pool_(thread_pool)
 {
     observe(settings_.setting_changed, [this](const std::string& name) {
@@ -40,7 +61,7 @@ int ThreadGroupProfilingModel::rowCount(const QModelIndex& /*parent*/) const
 
 int ThreadGroupProfilingModel::columnCount(const QModelIndex& /*parent*/) const
 {
-    return 3;
+    return 7;
 }
 
 ThreadGroup* ThreadGroupProfilingModel::getThreadGroup(int row) const
@@ -48,6 +69,11 @@ ThreadGroup* ThreadGroupProfilingModel::getThreadGroup(int row) const
     return thread_pool_->getGroupAt(row);
 }
 
+const Profile& ThreadGroupProfilingModel::getProfile(ThreadGroup* group) const
+{
+    return group->getProfiler()->getProfile(group->getName());
+}
+
 QVariant ThreadGroupProfilingModel::data(const QModelIndex& index, int role) const
 {
     ThreadGroup* group = getThreadGroup(index.row());
@@ -61,6 +87,16 @@ QVariant ThreadGroupProfilingModel::data(const QModelIndex& index, int role) con
                 case 1:
                     return QVariant::fromValue(group->size());
                 case 2:
+                    return formatLatency(getProfile(group).getHistogram("queue wait"));
+                case 3:
+                    return formatLatency(getProfile(group).getHistogram("execution"));
+                case 4: {
+                    Histogram depth = getProfile(group).getHistogram("queue depth");
+                    return depth.count() > 0 ? QString::number(depth.getMean(), 'f', 1) + " / " + QString::number(depth.getMax()) : QString("-");
+                }
+                case 5:
+                    return QVariant::fromValue(getProfile(group).getCounter("wakeups"));
+                case 6:
                     return QVariant::fromValue(ThreadGroupProfilingRenderer(group));
 
                 default:
@@ -73,7 +109,15 @@ QVariant ThreadGroupProfilingModel::data(const QModelIndex& index, int role) con
                     return QString::fromStdString(group->getName());
                 case 1:
                     return QVariant::fromValue(group->size());
-                case 2: {
+                case 2:
+                    return "time between scheduling and execution of a task: median / 99th percentile / maximum";
+                case 3:
+                    return "execution time of a task: median / 99th percentile / maximum";
+                case 4:
+                    return "number of queued tasks when a task is queued: mean / maximum";
+                case 5:
+                    return "how often a sleeping worker has been woken up";
+                case 6: {
                     auto& highlights = ThreadGroupProfilingRendererGlobalState::instance().highlight;
                     auto pos = highlights.find(group);
                     if (pos != highlights.end()) {
@@ -100,6 +144,14 @@ QVariant ThreadGroupProfilingModel::headerData(int section, Qt::Orientation orie
             case 1:
                 return "Nodes";
             case 2:
+                return "Queue Wait";
+            case 3:
+                return "Execution";
+            case 4:
+                return "Queue Depth";
+            case 5:
+                return "Wakeups";
+            case 6:
                 return "Profiling";
             default:
                 break;
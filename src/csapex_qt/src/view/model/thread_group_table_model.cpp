@@ -5,12 +5,24 @@
 #include <csapex/scheduling/thread_pool.h>
 #include <csapex/scheduling/thread_group.h>
 #include <csapex/command/modify_thread.h>
+#include <csapex/command/modify_thread_realtime.h>
 #include <csapex/command/command_executor.h>
 #include <csapex/core/settings.h>
 #include <csapex/view/widgets/cpu_affinity_widget.h>
 
+/// SYSTEM
+#include <algorithm>
+
 using namespace csapex;
 
+namespace
+{
+QStringList realtimePolicyNames()
+{
+    return { "none", "fifo", "round robin" };
+}
+}  // namespace
+
 ThreadGroupTableModel::ThreadGroupTableModel(Settings& settings, ThreadPoolPtr thread_pool, CommandExecutor& dispatcher) : settings_(settings), thread_pool_(thread_pool), cmd_executor_(dispatcher)
 {
     observe(settings_.setting_changed, [this](const std::string& name) {
@@ -39,6 +51,7 @@ ThreadGroupTableModel::ThreadGroupTableModel(Settings& settings, ThreadPoolPtr t
     // handle existing groups
     for (std::size_t i = 0, n = thread_pool->getGroupCount(); i < n; ++i) {
         observe(thread_pool->getGroupAt(i)->getCpuAffinity()->affinity_changed, [this](const CpuAffinity*) { refresh(); });
+        observe(thread_pool->getGroupAt(i)->scheduler_changed, [this]() { refresh(); });
     }
 }
 
@@ -49,7 +62,7 @@ int ThreadGroupTableModel::rowCount(const QModelIndex& /*parent*/) const
 
 int ThreadGroupTableModel::columnCount(const QModelIndex& /*parent*/) const
 {
-    return settings_.get<bool>("debug") ? 4 : 3;
+    return settings_.get<bool>("debug") ? 9 : 8;
 }
 
 ThreadGroup* ThreadGroupTableModel::getThreadGroup(int row) const
@@ -81,12 +94,38 @@ bool ThreadGroupTableModel::setData(const QModelIndex& index, const QVariant& va
             }
             break;
         }
+        case 3:
+        case 4:
+        case 5:
+        case 6: {
+            ThreadGroup::RealtimeSettings realtime = group->getRealtimeSettings();
+            switch (index.column()) {
+                case 3:
+                    realtime.policy = static_cast<ThreadGroup::RealtimePolicy>(std::max(0, realtimePolicyNames().indexOf(value.toString())));
+                    break;
+                case 4:
+                    realtime.priority = value.toInt();
+                    break;
+                case 5:
+                    realtime.lock_memory = value.toInt() == Qt::Checked;
+                    break;
+                case 6:
+                    realtime.stack_prefault = std::max(0, value.toInt()) * 1024;
+                    break;
+            }
+
+            if (realtime != group->getRealtimeSettings()) {
+                command::ModifyThreadRealtime::Ptr modify(new command::ModifyThreadRealtime(group->id(), realtime));
+                cmd_executor_.execute(modify);
+            }
+            break;
+        }
         default:
             break;
     }
 
     QModelIndex top = createIndex(index.row(), 0);
-    QModelIndex bottom = createIndex(index.row(), 5);
+    QModelIndex bottom = createIndex(index.row(), columnCount() - 1);
 
     dataChanged(top, bottom);
 
@@ -97,6 +136,8 @@ QVariant ThreadGroupTableModel::data(const QModelIndex& index, int role) const
 {
     ThreadGroup* group = getThreadGroup(index.row());
 
+    ThreadGroup::RealtimeSettings realtime = group->getRealtimeSettings();
+
     switch (role) {
         case Qt::DisplayRole:
         case Qt::EditRole: {
@@ -107,7 +148,15 @@ QVariant ThreadGroupTableModel::data(const QModelIndex& index, int role) const
                     return QVariant::fromValue(group->size());
                 case 2:
                     return QVariant::fromValue(CpuAffinityRenderer(*group->getCpuAffinity()));
-                case 3: {
+                case 3:
+                    return realtimePolicyNames().at(static_cast<int>(realtime.policy));
+                case 4:
+                    return realtime.priority;
+                case 6:
+                    return static_cast<int>(realtime.stack_prefault / 1024);
+                case 7:
+                    return QVariant::fromValue(group->getDeadlineMissCount());
+                case 8: {
                     QString res;
                     res += "(";
                     res += QString::number(group->isStepDone());
@@ -120,6 +169,17 @@ QVariant ThreadGroupTableModel::data(const QModelIndex& index, int role) const
                     break;
             }
         } break;
+        case Qt::CheckStateRole:
+            if (index.column() == 5) {
+                return realtime.lock_memory ? Qt::Checked : Qt::Unchecked;
+            }
+            break;
+        case Qt::UserRole:
+            // the delegate offers these values in a combo box
+            if (index.column() == 3) {
+                return realtimePolicyNames();
+            }
+            break;
     }
 
     return QVariant();
@@ -130,7 +190,17 @@ QVariant ThreadGroupTableModel::headerData(int section, Qt::Orientation orientat
     if (role == Qt::ToolTipRole) {
         if (orientation == Qt::Horizontal) {
             switch (section) {
-                case 2:
+                case 3:
+                    return "operating system scheduling policy of the workers, fifo and round robin require real-time privileges";
+                case 4:
+                    return "real-time priority of the workers, only used with fifo or round robin";
+                case 5:
+                    return "lock all pages of the process into memory while the group is running";
+                case 6:
+                    return "KiB of each worker stack that are touched before the first task is executed";
+                case 7:
+                    return "number of tasks that finished after their deadline";
+                case 8:
                     return "isStepDone(), canStartStepping()";
                 default:
                     break;
@@ -151,6 +221,16 @@ QVariant ThreadGroupTableModel::headerData(int section, Qt::Orientation orientat
             case 2:
                 return "CPU Affinity";
             case 3:
+                return "Real-time";
+            case 4:
+                return "Priority";
+            case 5:
+                return "Lock Memory";
+            case 6:
+                return "Stack Prefault";
+            case 7:
+                return "Deadline Misses";
+            case 8:
                 return "States";
             default:
                 break;
@@ -177,10 +257,25 @@ Qt::ItemFlags ThreadGroupTableModel::flags(const QModelIndex& index) const
     if (c == 2) {
         flags |= Qt::ItemIsEditable;
     }
+    if (c >= 3 && c <= 6) {
+        // private groups share their settings, only their cpu affinity can be changed
+        ThreadGroup* group = getThreadGroup(index.row());
+        if (group->id() != ThreadGroup::PRIVATE_THREAD) {
+            flags |= (c == 5) ? Qt::ItemIsUserCheckable : Qt::ItemIsEditable;
+        }
+    }
 
     return flags;
 }
 
+void ThreadGroupTableModel::updateStatistics()
+{
+    int rows = rowCount();
+    if (rows > 0) {
+        dataChanged(createIndex(0, 7), createIndex(rows - 1, 7));
+    }
+}
+
 void ThreadGroupTableModel::refresh()
 {
     beginResetModel();
@@ -68,6 +68,10 @@ QWidget* CpuAffinityDelegate::createEditor(QWidget* parent, const QStyleOptionVi
         //                this, &CpuAffinityDelegate::commitAndCloseEditor);
         connect(editor, &CpuAffinityWidget::destroyed, this, &CpuAffinityDelegate::commitAndCloseEditor);
         return editor;
+    } else if (index.data(Qt::UserRole).canConvert<QStringList>()) {
+        QComboBox* editor = new QComboBox(parent);
+        editor->addItems(index.data(Qt::UserRole).toStringList());
+        return editor;
     } else {
         return QStyledItemDelegate::createEditor(parent, option, index);
     }
@@ -79,6 +83,8 @@ void CpuAffinityDelegate::setEditorData(QWidget* editor, const QModelIndex& inde
         CpuAffinityRenderer cpu_affinity = qvariant_cast<CpuAffinityRenderer>(index.data());
         CpuAffinityWidget* starEditor = qobject_cast<CpuAffinityWidget*>(editor);
         starEditor->setRenderer(cpu_affinity);
+    } else if (QComboBox* combo = qobject_cast<QComboBox*>(editor)) {
+        combo->setCurrentText(index.data().toString());
     } else {
         QStyledItemDelegate::setEditorData(editor, index);
     }
@@ -89,6 +95,8 @@ void CpuAffinityDelegate::setModelData(QWidget* editor, QAbstractItemModel* mode
     if (index.data().canConvert<CpuAffinityRenderer>()) {
         CpuAffinityWidget* starEditor = qobject_cast<CpuAffinityWidget*>(editor);
         model->setData(index, QVariant::fromValue(starEditor->getWidget()));
+    } else if (QComboBox* combo = qobject_cast<QComboBox*>(editor)) {
+        model->setData(index, combo->currentText());
     } else {
         QStyledItemDelegate::setModelData(editor, model, index);
     }
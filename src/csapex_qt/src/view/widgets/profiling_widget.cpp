@@ -18,6 +18,18 @@
 
 using namespace csapex;
 
+namespace
+{
+QString formatDuration(double microseconds)
+{
+    if (microseconds < 1000.0) {
+        return QString::number(microseconds, 'f', 0) + " µs";
+    } else {
+        return QString::number(microseconds / 1000.0, 'f', 1) + " ms";
+    }
+}
+}  // namespace
+
 ProfilingWidget::ProfilingWidget(std::shared_ptr<Profiler> profiler, const std::string& profile_name, QWidget* parent)
   : QWidget(parent), profiler_(profiler), profile_(profile_name), space_for_painting_(nullptr)
 {
@@ -82,6 +94,16 @@ void ProfilingWidget::exportCsv()
 
             of << name << "," << stats.mean << "," << stats.stddev << '\n';
         }
+
+        // the latencies have different columns, so they follow in a section of their own
+        std::map<std::string, Histogram> latencies = profile.getLatencies();
+        if (!latencies.empty()) {
+            of << '\n' << "source,p50,p99,max" << '\n';
+            for (const auto& pair : latencies) {
+                const Histogram& histogram = pair.second;
+                of << pair.first << "," << histogram.getPercentile(0.5) << "," << histogram.getPercentile(0.99) << "," << histogram.getMax() << '\n';
+            }
+        }
     }
 }
 
@@ -276,6 +298,24 @@ void ProfilingWidget::paintEvent(QPaintEvent*)
         y += line_height;
     }
 
+    // end-to-end latency of the tokens per source
+    std::map<std::string, Histogram> latencies = profile.getLatencies();
+    if (!latencies.empty()) {
+        p.setPen(QColor(0, 0, 0));
+        y += line_height;
+        p.drawText(QRectF(text_x, y, text_w, line_height), "latency from");
+        p.drawText(QRectF(info_x, y, info_w, line_height), "p50 / p99 / max");
+        y += line_height;
+
+        for (const auto& pair : latencies) {
+            const Histogram& histogram = pair.second;
+            p.drawText(QRectF(text_x, y, text_w, line_height), QString::fromStdString(pair.first));
+            p.drawText(QRectF(info_x, y, info_w, line_height),
+                       formatDuration(histogram.getPercentile(0.5)) + " / " + formatDuration(histogram.getPercentile(0.99)) + " / " + formatDuration(histogram.getMax()));
+            y += line_height;
+        }
+    }
+
     // resize to fit content
     if (space_for_painting_->geometry().height() != y) {
         space_for_painting_->changeSize(0, y, QSizePolicy::MinimumExpanding, QSizePolicy::MinimumExpanding);
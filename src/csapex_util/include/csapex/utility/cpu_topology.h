@@ -0,0 +1,58 @@
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+
+/// SYSTEM
+#include <string>
+#include <vector>
+
+namespace csapex
+{
+/**
+ * @brief The CpuTopology class describes which CPUs share a last level cache and a NUMA node.
+ * On Linux it is read from sysfs, if that is not possible all CPUs are treated as one domain.
+ */
+class CpuTopology
+{
+public:
+    struct Cpu
+    {
+        unsigned id;
+        int numa_node;
+        int package;
+        // the smallest id of all CPUs sharing the last level cache with this one
+        int cache_domain;
+    };
+
+public:
+    /**
+     * @brief CpuTopology reads the topology of this machine
+     * @param sysfs_root the directory containing "cpu" and "node", usually /sys/devices/system
+     */
+    explicit CpuTopology(const std::string& sysfs_root = "/sys/devices/system");
+    explicit CpuTopology(std::vector<Cpu> cpus);
+
+    const std::vector<Cpu>& getCpus() const;
+    unsigned getNumCpus() const;
+
+    /**
+     * @brief getCacheDomains groups the CPUs by their last level cache, ordered by NUMA node
+     */
+    std::vector<std::vector<unsigned>> getCacheDomains() const;
+    std::vector<std::vector<unsigned>> getNumaNodes() const;
+
+    /**
+     * @brief parseCpuList parses the kernel's list format, e.g. "0-3,8,10-11"
+     */
+    static std::vector<unsigned> parseCpuList(const std::string& list);
+
+private:
+    void read(const std::string& sysfs_root);
+    void setToDefault();
+
+private:
+    std::vector<Cpu> cpus_;
+};
+
+}  // namespace csapex
+
+#endif  // CPU_TOPOLOGY_H
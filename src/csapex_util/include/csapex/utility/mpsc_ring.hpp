@@ -0,0 +1,125 @@
+#ifndef MPSC_RING_HPP
+#define MPSC_RING_HPP
+
+/// SYSTEM
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace csapex
+{
+/**
+ * @brief The MpscRing class is a bounded, lock-free multi-producer / single-consumer queue.
+ * Producers may call push concurrently, pop and empty may only be called by one thread at a time.
+ * The capacity is rounded up to the next power of two.
+ */
+template <typename T>
+class MpscRing
+{
+public:
+    explicit MpscRing(std::size_t capacity)
+      : capacity_(roundUp(capacity))
+      , mask_(capacity_ - 1)
+      , cells_(new Cell[capacity_])
+      , enqueue_pos_(0)
+      , dequeue_pos_(0)
+    {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    std::size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    /**
+     * @brief push appends a value, can be called from any thread
+     * @return false, iff the ring is full
+     */
+    bool push(T value)
+    {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief pop removes the oldest value, must only be called by the consumer
+     * @return false, iff no value was published yet
+     */
+    bool pop(T& value)
+    {
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq != pos + 1) {
+            return false;
+        }
+
+        value = std::move(cell.value);
+        cell.value = T();
+        dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+        cell.sequence.store(pos + capacity_, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief empty checks if there is a published value, only exact when called by the consumer
+     */
+    bool empty() const
+    {
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+private:
+    static std::size_t roundUp(std::size_t capacity)
+    {
+        std::size_t result = 2;
+        while (result < capacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(64) std::atomic<std::size_t> enqueue_pos_;
+    alignas(64) std::atomic<std::size_t> dequeue_pos_;
+};
+
+}  // namespace csapex
+
+#endif  // MPSC_RING_HPP
@@ -0,0 +1,46 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+/// PROJECT
+#include <csapex_util/export.h>
+
+/// SYSTEM
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace csapex
+{
+/**
+ * @brief SymbolTable interns strings into a global table, equal strings are always represented by the same small id.
+ *
+ * Symbols are never removed, so an id and the string it refers to stay valid for the lifetime of the process.
+ * Looking up a symbol does not lock, interning only locks exclusively for strings that are seen for the first time.
+ */
+class CSAPEX_UTILS_EXPORT SymbolTable
+{
+public:
+    typedef std::uint32_t Id;
+
+    /**
+     * @brief EMPTY is the id of the empty string
+     */
+    static constexpr Id EMPTY = 0;
+
+public:
+    static Id intern(const std::string& symbol);
+
+    /**
+     * @brief find looks up the id of a symbol without interning it
+     * @return false, iff the symbol has never been interned
+     */
+    static bool find(const std::string& symbol, Id& id);
+
+    static const std::string& lookup(Id id);
+
+    static std::size_t size();
+};
+
+}  // namespace csapex
+
+#endif  // SYMBOL_TABLE_H
@@ -0,0 +1,186 @@
+/// HEADER
+#include <csapex/utility/cpu_topology.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+using namespace csapex;
+
+namespace
+{
+bool readLine(const std::string& path, std::string& line)
+{
+    std::ifstream file(path);
+    if (!file.good()) {
+        return false;
+    }
+    std::getline(file, line);
+    return true;
+}
+
+int readInt(const std::string& path, int default_value)
+{
+    std::string line;
+    if (!readLine(path, line)) {
+        return default_value;
+    }
+    try {
+        return std::stoi(line);
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+}  // namespace
+
+CpuTopology::CpuTopology(const std::string& sysfs_root)
+{
+    read(sysfs_root);
+    if (cpus_.empty()) {
+        setToDefault();
+    }
+}
+
+CpuTopology::CpuTopology(std::vector<Cpu> cpus) : cpus_(cpus)
+{
+    if (cpus_.empty()) {
+        setToDefault();
+    }
+}
+
+void CpuTopology::read(const std::string& sysfs_root)
+{
+    std::string online;
+    if (!readLine(sysfs_root + "/cpu/online", online)) {
+        return;
+    }
+
+    for (unsigned id : parseCpuList(online)) {
+        std::string cpu_dir = sysfs_root + "/cpu/cpu" + std::to_string(id);
+
+        Cpu cpu;
+        cpu.id = id;
+        cpu.numa_node = 0;
+        cpu.package = readInt(cpu_dir + "/topology/physical_package_id", 0);
+        cpu.cache_domain = id;
+
+        // the cache with the highest level is shared by the most CPUs
+        int last_level = 0;
+        for (int index = 0;; ++index) {
+            std::string cache_dir = cpu_dir + "/cache/index" + std::to_string(index);
+            int level = readInt(cache_dir + "/level", -1);
+            if (level < 0) {
+                break;
+            }
+
+            std::string type;
+            if (readLine(cache_dir + "/type", type) && type == "Instruction") {
+                continue;
+            }
+
+            std::string shared;
+            if (level > last_level && readLine(cache_dir + "/shared_cpu_list", shared)) {
+                std::vector<unsigned> sharing = parseCpuList(shared);
+                if (!sharing.empty()) {
+                    last_level = level;
+                    cpu.cache_domain = *std::min_element(sharing.begin(), sharing.end());
+                }
+            }
+        }
+
+        cpus_.push_back(cpu);
+    }
+
+    std::string nodes;
+    if (readLine(sysfs_root + "/node/online", nodes)) {
+        for (unsigned node : parseCpuList(nodes)) {
+            std::string node_cpus;
+            if (!readLine(sysfs_root + "/node/node" + std::to_string(node) + "/cpulist", node_cpus)) {
+                continue;
+            }
+            for (unsigned id : parseCpuList(node_cpus)) {
+                for (Cpu& cpu : cpus_) {
+                    if (cpu.id == id) {
+                        cpu.numa_node = node;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void CpuTopology::setToDefault()
+{
+    cpus_.clear();
+    for (unsigned id = 0, n = std::max(1u, std::thread::hardware_concurrency()); id < n; ++id) {
+        cpus_.push_back(Cpu{ id, 0, 0, 0 });
+    }
+}
+
+const std::vector<CpuTopology::Cpu>& CpuTopology::getCpus() const
+{
+    return cpus_;
+}
+
+unsigned CpuTopology::getNumCpus() const
+{
+    return cpus_.size();
+}
+
+std::vector<std::vector<unsigned>> CpuTopology::getCacheDomains() const
+{
+    std::map<std::tuple<int, int>, std::vector<unsigned>> domains;
+    for (const Cpu& cpu : cpus_) {
+        domains[std::make_tuple(cpu.numa_node, cpu.cache_domain)].push_back(cpu.id);
+    }
+
+    std::vector<std::vector<unsigned>> result;
+    for (const auto& pair : domains) {
+        result.push_back(pair.second);
+    }
+    return result;
+}
+
+std::vector<std::vector<unsigned>> CpuTopology::getNumaNodes() const
+{
+    std::map<int, std::vector<unsigned>> nodes;
+    for (const Cpu& cpu : cpus_) {
+        nodes[cpu.numa_node].push_back(cpu.id);
+    }
+
+    std::vector<std::vector<unsigned>> result;
+    for (const auto& pair : nodes) {
+        result.push_back(pair.second);
+    }
+    return result;
+}
+
+std::vector<unsigned> CpuTopology::parseCpuList(const std::string& list)
+{
+    std::vector<unsigned> cpus;
+
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        try {
+            std::size_t dash = range.find('-');
+            if (dash == std::string::npos) {
+                cpus.push_back(std::stoul(range));
+            } else {
+                unsigned from = std::stoul(range.substr(0, dash));
+                unsigned to = std::stoul(range.substr(dash + 1));
+                for (unsigned cpu = from; cpu <= to; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+        } catch (const std::exception&) {
+            // ignore malformed entries, e.g. trailing whitespace
+        }
+    }
+
+    return cpus;
+}
@@ -0,0 +1,106 @@
+/// HEADER
+#include <csapex/utility/symbol_table.h>
+
+/// PROJECT
+#include <csapex/utility/assert.h>
+
+/// SYSTEM
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+using namespace csapex;
+
+namespace
+{
+constexpr std::size_t CHUNK_BITS = 10;
+constexpr std::size_t CHUNK_SIZE = std::size_t(1) << CHUNK_BITS;
+constexpr std::size_t MAX_CHUNKS = 1024;
+
+struct Table
+{
+    Table() : size(0)
+    {
+        insert(std::string());
+    }
+
+    SymbolTable::Id insert(const std::string& symbol)
+    {
+        std::size_t id = size;
+        apex_assert_hard_msg(id < CHUNK_SIZE * MAX_CHUNKS, "too many symbols");
+
+        // symbols are stored in chunks that are never moved, so that lookups can access them without locking
+        std::unique_ptr<std::string[]>& chunk = chunks[id >> CHUNK_BITS];
+        if (!chunk) {
+            chunk.reset(new std::string[CHUNK_SIZE]);
+        }
+        std::string& entry = chunk[id & (CHUNK_SIZE - 1)];
+        entry = symbol;
+
+        index.emplace(std::string_view(entry), static_cast<SymbolTable::Id>(id));
+        size = id + 1;
+        return static_cast<SymbolTable::Id>(id);
+    }
+
+    std::shared_mutex mutex;
+    std::unordered_map<std::string_view, SymbolTable::Id> index;
+    std::unique_ptr<std::string[]> chunks[MAX_CHUNKS];
+    std::atomic<std::size_t> size;
+};
+
+Table& table()
+{
+    // never destroyed, messages in static storage might still refer to their symbols during shutdown
+    static Table* table = new Table;
+    return *table;
+}
+}  // namespace
+
+SymbolTable::Id SymbolTable::intern(const std::string& symbol)
+{
+    Table& t = table();
+    {
+        std::shared_lock<std::shared_mutex> lock(t.mutex);
+        auto pos = t.index.find(symbol);
+        if (pos != t.index.end()) {
+            return pos->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(t.mutex);
+    auto pos = t.index.find(symbol);
+    if (pos != t.index.end()) {
+        return pos->second;
+    }
+    return t.insert(symbol);
+}
+
+bool SymbolTable::find(const std::string& symbol, Id& id)
+{
+    Table& t = table();
+    std::shared_lock<std::shared_mutex> lock(t.mutex);
+    auto pos = t.index.find(symbol);
+    if (pos == t.index.end()) {
+        return false;
+    }
+    id = pos->second;
+    return true;
+}
+
+const std::string& SymbolTable::lookup(Id id)
+{
+    Table& t = table();
+    if (id >= t.size) {
+        throw std::out_of_range(std::string("unknown symbol ") + std::to_string(id));
+    }
+    return t.chunks[id >> CHUNK_BITS][id & (CHUNK_SIZE - 1)];
+}
+
+std::size_t SymbolTable::size()
+{
+    return table().size;
+}
@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+
+#include <csapex/utility/cpu_topology.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+using namespace csapex;
+
+class CpuTopologyTest : public ::testing::Test
+{
+protected:
+    CpuTopologyTest()
+    {
+    }
+
+    virtual ~CpuTopologyTest()
+    {
+        if (!root.empty()) {
+            std::string cmd = "rm -rf " + root;
+            if (std::system(cmd.c_str()) != 0) {
+                std::cerr << "cannot remove " << root << std::endl;
+            }
+        }
+    }
+
+    void makeDirectories(const std::string& path)
+    {
+        for (std::size_t pos = path.find('/', root.size() + 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+            ::mkdir(path.substr(0, pos).c_str(), 0755);
+        }
+        ::mkdir(path.c_str(), 0755);
+    }
+
+    void writeFile(const std::string& path, const std::string& content)
+    {
+        makeDirectories(path.substr(0, path.rfind('/')));
+        std::ofstream file(path);
+        file << content << "\n";
+    }
+
+    void makeSysfs()
+    {
+        char dir[] = "/tmp/csapex_cpu_topology_XXXXXX";
+        ASSERT_NE(nullptr, ::mkdtemp(dir));
+        root = dir;
+
+        // two sockets with two cores each, every socket has its own L3 cache and NUMA node
+        writeFile(root + "/cpu/online", "0-3");
+        for (int cpu = 0; cpu < 4; ++cpu) {
+            std::string cpu_dir = root + "/cpu/cpu" + std::to_string(cpu);
+            int socket = cpu / 2;
+            writeFile(cpu_dir + "/topology/physical_package_id", std::to_string(socket));
+
+            writeFile(cpu_dir + "/cache/index0/level", "1");
+            writeFile(cpu_dir + "/cache/index0/type", "Data");
+            writeFile(cpu_dir + "/cache/index0/shared_cpu_list", std::to_string(cpu));
+            writeFile(cpu_dir + "/cache/index1/level", "1");
+            writeFile(cpu_dir + "/cache/index1/type", "Instruction");
+            writeFile(cpu_dir + "/cache/index1/shared_cpu_list", std::to_string(cpu));
+            writeFile(cpu_dir + "/cache/index2/level", "3");
+            writeFile(cpu_dir + "/cache/index2/type", "Unified");
+            writeFile(cpu_dir + "/cache/index2/shared_cpu_list", socket == 0 ? "0-1" : "2-3");
+        }
+        writeFile(root + "/node/online", "0-1");
+        writeFile(root + "/node/node0/cpulist", "0-1");
+        writeFile(root + "/node/node1/cpulist", "2-3");
+    }
+
+    std::string root;
+};
+
+TEST_F(CpuTopologyTest, CpuListsAreParsed)
+{
+    std::vector<unsigned> expected = { 0, 1, 2, 3, 8, 10, 11 };
+    ASSERT_EQ(expected, CpuTopology::parseCpuList("0-3,8,10-11"));
+    ASSERT_TRUE(CpuTopology::parseCpuList("").empty());
+}
+
+TEST_F(CpuTopologyTest, TopologyIsReadFromSysfs)
+{
+    makeSysfs();
+
+    CpuTopology topology(root);
+    ASSERT_EQ(4u, topology.getNumCpus());
+
+    std::vector<std::vector<unsigned>> expected_domains = { { 0, 1 }, { 2, 3 } };
+    ASSERT_EQ(expected_domains, topology.getCacheDomains());
+    ASSERT_EQ(expected_domains, topology.getNumaNodes());
+
+    ASSERT_EQ(1, topology.getCpus().at(3).package);
+    ASSERT_EQ(1, topology.getCpus().at(3).numa_node);
+}
+
+TEST_F(CpuTopologyTest, MissingSysfsFallsBackToOneDomain)
+{
+    CpuTopology topology("/nonexistent");
+    ASSERT_GT(topology.getNumCpus(), 0u);
+    ASSERT_EQ(1u, topology.getCacheDomains().size());
+}
+
+TEST_F(CpuTopologyTest, DomainsAreOrderedByNumaNode)
+{
+    std::vector<CpuTopology::Cpu> cpus = { { 0, 1, 1, 0 }, { 1, 0, 0, 1 }, { 2, 1, 1, 0 }, { 3, 0, 0, 1 } };
+    CpuTopology topology(cpus);
+
+    std::vector<std::vector<unsigned>> expected = { { 1, 3 }, { 0, 2 } };
+    ASSERT_EQ(expected, topology.getCacheDomains());
+}
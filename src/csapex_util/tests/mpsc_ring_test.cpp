@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+
+#include <csapex/utility/mpsc_ring.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace csapex;
+
+class MpscRingTest : public ::testing::Test
+{
+protected:
+    MpscRingTest()
+    {
+    }
+
+    virtual ~MpscRingTest()
+    {
+    }
+};
+
+TEST_F(MpscRingTest, CapacityIsRoundedUpToPowerOfTwo)
+{
+    MpscRing<int> ring(5);
+    ASSERT_EQ(8u, ring.capacity());
+}
+
+TEST_F(MpscRingTest, ValuesArePoppedInOrder)
+{
+    MpscRing<int> ring(4);
+    ASSERT_TRUE(ring.empty());
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.push(i));
+    }
+    ASSERT_FALSE(ring.empty());
+
+    for (int i = 0; i < 4; ++i) {
+        int value = -1;
+        ASSERT_TRUE(ring.pop(value));
+        ASSERT_EQ(i, value);
+    }
+
+    int value = -1;
+    ASSERT_FALSE(ring.pop(value));
+    ASSERT_TRUE(ring.empty());
+}
+
+TEST_F(MpscRingTest, PushFailsIfFull)
+{
+    MpscRing<int> ring(2);
+    ASSERT_TRUE(ring.push(0));
+    ASSERT_TRUE(ring.push(1));
+    ASSERT_FALSE(ring.push(2));
+
+    int value = -1;
+    ASSERT_TRUE(ring.pop(value));
+    ASSERT_TRUE(ring.push(2));
+}
+
+TEST_F(MpscRingTest, ConcurrentProducersKeepTheirOrder)
+{
+    const int producers = 4;
+    const int per_producer = 10000;
+
+    MpscRing<int> ring(64);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < per_producer; ++i) {
+                while (!ring.push(p * per_producer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    for (int received = 0; received < producers * per_producer;) {
+        int value;
+        if (ring.pop(value)) {
+            int p = value / per_producer;
+            ASSERT_EQ(next[p], value % per_producer);
+            ++next[p];
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    ASSERT_TRUE(ring.empty());
+}